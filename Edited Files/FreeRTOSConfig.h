@@ -31,12 +31,6 @@
 #include "GPIO.h"
 
 /* Global Variables */
-extern int Task_1_IN , Task_1_OUT , Task_1_Total;
-extern int Task_2_IN , Task_2_OUT , Task_2_Total;
-extern int Task_3_IN , Task_3_OUT , Task_3_Total;
-extern int Task_4_IN , Task_4_OUT , Task_4_Total;
-extern int Task_5_IN , Task_5_OUT , Task_5_Total;
-extern int Task_6_IN , Task_6_OUT , Task_6_Total;
 extern int Systm_Time , CPU_Load;
 /*-----------------------------------------------------------
  * Application specific definitions.
@@ -52,8 +46,17 @@ extern int Systm_Time , CPU_Load;
 
 /* EDF Configuration */
 #define configUSE_EDF_SCHEDULER 1
+#define configUSE_EDF_VD 0 	/* Mixed-criticality EDF with virtual deadlines, see xTaskPeriodicCreateMC(). */
+#define configUSE_EDF_LIMITED_PREEMPTION 0 	/* Defer preemptions to taskPREEMPTION_POINT(), see vTaskSetMaxNonPreemptiveLength(). */
+#define configUSE_EDF_NON_PREEMPTIVE 0 	/* Only switch jobs on completion or blocking, see xTaskCheckNonPreemptiveSchedulability(). */
+#define configUSE_EDF_SLACK_STEALING 0 	/* Run soft work in the slack of the hard jobs, see xTaskRunInSlack(). */
+#define configEDF_SLACK_HORIZON 100 	/* Ticks ahead the slack is computed over, the hyperperiod of the task set. */
+#define configUSE_EDF_HYBRID 0 	/* Periodic tasks form an EDF band inside the fixed priorities, see configEDF_BAND_PRIORITY. */
+#define configEDF_BAND_PRIORITY 2 	/* Priority of the EDF band in the hybrid mode. */
+#define configUSE_EDF_LEAN 0 	/* Leave out the fixed priority ready lists and task priorities, EDF only. */
 /****************************************/
 #define configSUPPORT_DYNAMIC_ALLOCATION 1
+#define configSUPPORT_STATIC_ALLOCATION 0 	/* Tasks in static memory, see xTaskPeriodicCreateStatic() and vApplicationGetIdlePeriodicTaskMemory(). */
 /****************************************/
 
 
@@ -74,6 +77,47 @@ extern int Systm_Time , CPU_Load;
 #define configQUEUE_REGISTRY_SIZE 	0
 #define configUSE_STATS_FORMATTING_FUNCTIONS 1
 #define configGENERATE_RUN_TIME_STATS             1
+#define configUSE_TASK_TRACE_PINS                 1
+#define configUSE_CPU_LOAD_MONITOR                1
+#define configCPU_LOAD_WINDOW_TICKS               100 	/* 100 ms windows, averaged over 1 s and 10 s. */
+#define configCPU_LOAD_MEDIUM_WINDOWS             10
+#define configCPU_LOAD_LONG_WINDOWS               100
+
+/* Binary scheduling trace, see trace_recorder.h.  Timer 1 counts at PCLK / 1001. */
+#define configUSE_TRACE_RECORDER                  1
+#define configTRACE_RECORDER_EVENTS               64
+#define configTRACE_RECORDER_TIMESTAMP()          ( T1TC )
+#define configTRACE_RECORDER_TIMER_HZ             configRUN_TIME_COUNTER_HZ
+
+/* Per task execution time is kept in the TCB by the run time stats, timed by
+ * timer 1 which is started in prvSetupHardware(). */
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+#define portGET_RUN_TIME_COUNTER_VALUE()          ( T1TC )
+#define configRUN_TIME_COUNTER_HZ                 ( configCPU_CLOCK_HZ / 1001UL )
+
+/* Response time and start jitter histograms of each task, see
+ * vTaskGetLatencyStats().  About 0.5 KB per task with the default histogram
+ * size, so only enabled for latency sign-off builds. */
+#define configUSE_TASK_LATENCY_STATS              0
+
+/* Stack profiling, see vTaskGetStackProfile().  main.c reports the stack use
+ * of the tasks on the UART after a training run, for Host_Tools/stack_sizes.py.
+ * The ARM7 stacks grow down, so their top must be recorded for the depth. */
+#define configUSE_STACK_PROFILING                 0
+#define configSTACK_PROFILING_MARGIN              25 	/* Percent added to the most a task used. */
+#define configRECORD_STACK_HIGH_ADDRESS           configUSE_STACK_PROFILING
+
+/* The producer tasks post their events to Uart_Rx as bits of its task
+ * notification value, see main.c.  The second notification is the one a
+ * writer waits on for room in the transmit buffer of the serial driver, see
+ * spsc_ring.h. */
+#define configUSE_TASK_NOTIFICATIONS              1
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES     2
+#define configUSE_QUEUE_SETS                      0
+
+/* Transmit buffer of the serial driver, see serial_tx.h. */
+#define configSERIAL_TX_BUFFER_SIZE               256
+#define configSERIAL_TX_BLOCK_TICKS               portMAX_DELAY
 
 
 
@@ -96,70 +140,27 @@ to exclude the API function. */
 #define INCLUDE_vTaskDelay				1
 
 /* Trace Hooks */
+#include "trace_recorder.h"
+
 #define traceTASK_SWITCHED_OUT() do{\
-																if((int)pxCurrentTCB->pxTaskTag == 1 )\
+																if(pxCurrentTCB->uxTracePin != tskNO_TRACE_PIN)\
 																{\
-																	GPIO_write(PORT_0 , PIN2 , PIN_IS_LOW );\
-																	Task_1_Total += (T1TC - Task_1_IN );\
+																	GPIO_write(PORT_0 , (pinX_t)pxCurrentTCB->uxTracePin , PIN_IS_LOW );\
 																}\
-																else if((int)pxCurrentTCB->pxTaskTag == 2 )\
-																{\
-																	GPIO_write(PORT_0 , PIN3 , PIN_IS_LOW );\
-																	Task_2_Total += (T1TC - Task_2_IN );\
-																}\
-																else if((int)pxCurrentTCB->pxTaskTag == 3 )\
-																{\
-																	GPIO_write(PORT_0 , PIN4 , PIN_IS_LOW );\
-																	Task_3_Total += (T1TC - Task_3_IN );\
-																}\
-																else if((int)pxCurrentTCB->pxTaskTag == 4 )\
-																{\
-																	GPIO_write(PORT_0 , PIN5 , PIN_IS_LOW );\
-																	Task_4_Total += (T1TC - Task_4_IN );\
-																}\
-																else if((int)pxCurrentTCB->pxTaskTag == 5 )\
-																{\
-																	GPIO_write(PORT_0 , PIN6 , PIN_IS_LOW );\
-																	Task_5_Total += (T1TC - Task_5_IN );\
-																}\
-																else if((int)pxCurrentTCB->pxTaskTag == 6 )\
-																{\
-																	GPIO_write(PORT_0 , PIN7 , PIN_IS_LOW );\
-																	Task_6_Total += (T1TC - Task_6_IN );\
-																}\
-																Systm_Time = T1TC;\
-																CPU_Load = (((Task_1_Total + Task_2_Total + Task_3_Total + Task_4_Total + Task_5_Total + Task_6_Total) / (float)Systm_Time  )) * 100;\
+																traceRECORD(traceEVT_SWITCH_OUT , pxCurrentTCB->uxTCBNumber , taskTRACE_STILL_READY(pxCurrentTCB));\
 																}while(0);
 #define traceTASK_SWITCHED_IN() do{\
-																if((int)pxCurrentTCB->pxTaskTag == 1)\
-																{\
-																	GPIO_write(PORT_0 , PIN2 , PIN_IS_HIGH);\
-																	Task_1_IN = T1TC;\
-																}\
-																else if((int)pxCurrentTCB->pxTaskTag == 2)\
-																{\
-																	GPIO_write(PORT_0 , PIN3 , PIN_IS_HIGH);\
-																	Task_2_IN = T1TC;\
-																}\
-																else if((int)pxCurrentTCB->pxTaskTag == 3)\
-																{\
-																	GPIO_write(PORT_0 , PIN4 , PIN_IS_HIGH);\
-																	Task_3_IN = T1TC;\
-																}\
-																else if((int)pxCurrentTCB->pxTaskTag == 4)\
-																{\
-																	GPIO_write(PORT_0 , PIN5 , PIN_IS_HIGH);\
-																	Task_4_IN = T1TC;\
-																}\
-																else if((int)pxCurrentTCB->pxTaskTag == 5)\
-																{\
-																	GPIO_write(PORT_0 , PIN6 , PIN_IS_HIGH);\
-																	Task_5_IN = T1TC;\
-																}\
-																else if((int)pxCurrentTCB->pxTaskTag == 6)\
+																if(pxCurrentTCB->uxTracePin != tskNO_TRACE_PIN)\
 																{\
-																	GPIO_write(PORT_0 , PIN7 , PIN_IS_HIGH);\
-																	Task_6_IN = T1TC;\
+																	GPIO_write(PORT_0 , (pinX_t)pxCurrentTCB->uxTracePin , PIN_IS_HIGH);\
 																}\
+																traceRECORD(traceEVT_SWITCH_IN , pxCurrentTCB->uxTCBNumber , 0);\
 																}while(0);
+#define traceTASK_CREATE(pxNewTCB)              vTraceRecordTaskCreate((uint8_t)(pxNewTCB)->uxTCBNumber , (uint16_t)(pxNewTCB)->xTaskPeriod , (pxNewTCB)->pcTaskName)
+#define traceTASK_RELEASED(pxTCB)               traceRECORD(traceEVT_RELEASE , (pxTCB)->uxTCBNumber , listGET_LIST_ITEM_VALUE(&((pxTCB)->xStateListItem)) - xTickCount)
+#define traceTASK_DEADLINE_MISSED(pxTCB)        traceRECORD(traceEVT_DEADLINE_MISS , (pxTCB)->uxTCBNumber , 0)
+#define traceQUEUE_SEND(pxQueue)                traceRECORD(traceEVT_QUEUE_SEND , (pxQueue)->uxQueueNumber , (pxQueue)->uxMessagesWaiting + 1)
+#define traceQUEUE_SEND_FROM_ISR(pxQueue)       traceRECORD(traceEVT_QUEUE_SEND , (pxQueue)->uxQueueNumber , (pxQueue)->uxMessagesWaiting + 1)
+#define traceQUEUE_RECEIVE(pxQueue)             traceRECORD(traceEVT_QUEUE_RECEIVE , (pxQueue)->uxQueueNumber , (pxQueue)->uxMessagesWaiting - 1)
+#define traceQUEUE_RECEIVE_FROM_ISR(pxQueue)    traceRECORD(traceEVT_QUEUE_RECEIVE , (pxQueue)->uxQueueNumber , (pxQueue)->uxMessagesWaiting - 1)
 #endif /* FREERTOS_CONFIG_H */
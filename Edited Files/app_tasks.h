@@ -0,0 +1,48 @@
+/*
+ * Task table of the application, generated by Host_Tools/simso_tasks.py from
+ * Simso_Project/EDF_6_Tasks_Project.xml.  Edit the model and generate it again
+ * rather than editing this file.
+ */
+
+#ifndef APP_TASKS_H
+#define APP_TASKS_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Fails to compile if configTICK_RATE_HZ, which holds a cast, is not the
+ * tick rate the periods were converted at. */
+typedef char appTICK_RATE_CHECK[ ( configTICK_RATE_HZ == 1000 ) ? 1 : -1 ];
+
+/* Periods, in ticks, by Simso task id. */
+#define Task1_Period    50
+#define Task2_Period    50
+#define Task3_Period    100
+#define Task4_Period    20
+#define Task5_Period    10
+#define Task6_Period    100
+
+#define appTASK_COUNT    6
+
+/* Words of stack of all the tasks together. */
+#define appSTACK_WORDS    600
+
+void Btn1( void * pvParameters );
+void Btn2( void * pvParameters );
+void Task_Tx( void * pvParameters );
+void Uart_Rx( void * pvParameters );
+void Load_1_Simulation( void * pvParameters );
+void Load_2_Simulation( void * pvParameters );
+
+static const TaskPeriodicParameters_t xAppTasks[ appTASK_COUNT ] =
+{
+    /* Function, name, stack depth, parameters, priority, period, deadline, WCET. */
+    { Btn1, "Button_1", 100, NULL, 1, Task1_Period, 50, 1 },
+    { Btn2, "Button_2", 100, NULL, 1, Task2_Period, 50, 1 },
+    { Task_Tx, "Task_Tx", 100, NULL, 1, Task3_Period, 100, 1 },
+    { Uart_Rx, "Rx", 100, NULL, 1, Task4_Period, 20, 1 },
+    { Load_1_Simulation, "Load_1_Simulation", 100, NULL, 1, Task5_Period, 10, 5 },
+    { Load_2_Simulation, "Load_2_Simulation", 100, NULL, 1, Task6_Period, 100, 12 }
+};
+
+#endif /* APP_TASKS_H */
@@ -0,0 +1,848 @@
+/*
+ * An implementation of pvPortMalloc() and vPortFree() that takes bounded time:
+ * a two-level segregated fit (TLSF) allocator, after M. Masmano et al., "TLSF:
+ * a new dynamic memory allocator for real-time systems", ECRTS 2004.
+ *
+ * heap_2.c and heap_4.c search a list of free blocks, so the time they take
+ * grows with the number of blocks on the heap, and with it when tasks and
+ * queues are created and deleted at run time.  Here the free blocks are kept
+ * in segregated lists, one for each range of sizes.  The first level divides
+ * the sizes into powers of two, the second level divides each power of two
+ * into heapSL_COUNT equal ranges.  A bitmap of the lists that are not empty
+ * finds a list of large enough blocks with a couple of bit scans, whatever the
+ * state of the heap: allocating and freeing are a fixed number of steps.
+ *
+ * As in heap_4.c, a block that is freed is merged with the blocks around it
+ * when they are free, so the heap does not fragment into blocks too small to
+ * be used.  Each block records the one before it in memory for that, and its
+ * size, which gives the one after it.
+ *
+ * The lists and their bitmaps are placed at the start of ucHeap, so that the
+ * RAM taken by the heap is still configTOTAL_HEAP_SIZE.  On the LPC2129, with
+ * 8 byte alignment and the 13 KB heap, they take 328 bytes of it.
+ *
+ * See heap_tlsf.h for the statistics kept besides the ones of heap_4.c.
+ */
+#include <stdlib.h>
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+ * all the API functions to use the MPU wrappers.  That should only be done when
+ * task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "heap_tlsf.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
+    #error This file must not be used if configSUPPORT_DYNAMIC_ALLOCATION is 0
+#endif
+
+#ifndef configHEAP_CLEAR_MEMORY_ON_FREE
+    #define configHEAP_CLEAR_MEMORY_ON_FREE    0
+#endif
+
+/* The log2 of the number of second level lists for each power of two.  More
+ * lists waste less memory to the rounding up of the sizes requested, at the
+ * cost of larger tables. */
+#ifndef configTLSF_SL_INDEX_COUNT_LOG2
+    #define configTLSF_SL_INDEX_COUNT_LOG2    3
+#endif
+
+#if ( ( configTLSF_SL_INDEX_COUNT_LOG2 < 1 ) || ( configTLSF_SL_INDEX_COUNT_LOG2 > 5 ) )
+    #error configTLSF_SL_INDEX_COUNT_LOG2 must be between 1 and 5
+#endif
+
+/* Max value that fits in a size_t type. */
+#define heapSIZE_MAX              ( ~( ( size_t ) 0 ) )
+
+/* Check if multiplying a and b will result in overflow. */
+#define heapMULTIPLY_WILL_OVERFLOW( a, b )    ( ( ( a ) > 0 ) && ( ( b ) > ( heapSIZE_MAX / ( a ) ) ) )
+
+/* Check if adding a and b will result in overflow. */
+#define heapADD_WILL_OVERFLOW( a, b )         ( ( a ) > ( heapSIZE_MAX - ( b ) ) )
+
+/* floor( log2( x ) ) for 0 < x < 2^32, as a constant expression, for the sizes
+ * of the tables.  configTOTAL_HEAP_SIZE holds a cast, so the preprocessor
+ * cannot do it. */
+#define heapLOG2_BIT( x, n )    ( ( ( ( size_t ) ( x ) >> ( n ) ) != 0U ) ? 1U : 0U )
+#define heapLOG2( x )                                                                                                                \
+    ( heapLOG2_BIT( x, 1 ) + heapLOG2_BIT( x, 2 ) + heapLOG2_BIT( x, 3 ) + heapLOG2_BIT( x, 4 ) + heapLOG2_BIT( x, 5 ) +         \
+      heapLOG2_BIT( x, 6 ) + heapLOG2_BIT( x, 7 ) + heapLOG2_BIT( x, 8 ) + heapLOG2_BIT( x, 9 ) + heapLOG2_BIT( x, 10 ) +        \
+      heapLOG2_BIT( x, 11 ) + heapLOG2_BIT( x, 12 ) + heapLOG2_BIT( x, 13 ) + heapLOG2_BIT( x, 14 ) + heapLOG2_BIT( x, 15 ) +    \
+      heapLOG2_BIT( x, 16 ) + heapLOG2_BIT( x, 17 ) + heapLOG2_BIT( x, 18 ) + heapLOG2_BIT( x, 19 ) + heapLOG2_BIT( x, 20 ) +    \
+      heapLOG2_BIT( x, 21 ) + heapLOG2_BIT( x, 22 ) + heapLOG2_BIT( x, 23 ) + heapLOG2_BIT( x, 24 ) + heapLOG2_BIT( x, 25 ) +    \
+      heapLOG2_BIT( x, 26 ) + heapLOG2_BIT( x, 27 ) + heapLOG2_BIT( x, 28 ) + heapLOG2_BIT( x, 29 ) + heapLOG2_BIT( x, 30 ) +    \
+      heapLOG2_BIT( x, 31 ) )
+
+/* Blocks smaller than heapSMALL_BLOCK_SIZE all go in the lists of the first
+ * level index 0, one list for each multiple of portBYTE_ALIGNMENT.  Above it,
+ * the first level index of a size is the position of its highest bit, less
+ * heapFL_SHIFT - 1, and the second level index is given by the bits that
+ * follow the highest one. */
+#define heapSL_COUNT            ( 1U << configTLSF_SL_INDEX_COUNT_LOG2 )
+#define heapSMALL_BLOCK_SIZE    ( ( size_t ) heapSL_COUNT * ( size_t ) portBYTE_ALIGNMENT )
+#define heapFL_SHIFT            heapLOG2( heapSMALL_BLOCK_SIZE )
+
+/* No block is larger than the heap, which bounds the first level index. */
+#define heapFL_COUNT            ( heapLOG2( configTOTAL_HEAP_SIZE ) - heapFL_SHIFT + 2U )
+
+/* The bitmaps are 32 bits, and a search looks one bit past the first level
+ * index it starts from. */
+typedef char heapTOTAL_HEAP_SIZE_CHECK[ ( ( heapLOG2( configTOTAL_HEAP_SIZE ) < 31U ) && ( heapFL_COUNT < 32U ) ) ? 1 : -1 ];
+
+#define heapBIT( uxIndex )          ( ( uint32_t ) 1 << ( uxIndex ) )
+#define heapBITS_FROM( uxIndex )    ( ( ~( uint32_t ) 0 ) << ( uxIndex ) )
+
+/* Block sizes are multiples of portBYTE_ALIGNMENT, so bit 0 of the xBlockSize
+ * member of a TlsfBlock_t is free to record that the block is on a free list
+ * rather than owned by the application. */
+#define heapBLOCK_FREE_BIT                  ( ( size_t ) 1 )
+#define heapBLOCK_SIZE( pxBlock )           ( ( pxBlock )->xBlockSize & ~heapBLOCK_FREE_BIT )
+#define heapBLOCK_IS_FREE( pxBlock )        ( ( ( pxBlock )->xBlockSize & heapBLOCK_FREE_BIT ) != 0 )
+#define heapNEXT_PHYSICAL_BLOCK( pxBlock )  ( ( TlsfBlock_t * ) ( void * ) ( ( ( uint8_t * ) ( pxBlock ) ) + heapBLOCK_SIZE( pxBlock ) ) )
+
+/*-----------------------------------------------------------*/
+
+/* Allocate the memory for the heap. */
+#if ( configAPPLICATION_ALLOCATED_HEAP == 1 )
+
+/* The application writer has already defined the array used for the RTOS
+* heap - probably so it can be placed in a special segment or address. */
+    extern uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+#else
+    PRIVILEGED_DATA static uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+#endif /* configAPPLICATION_ALLOCATED_HEAP */
+
+/* The header of a block.  Only the first two members are kept while the block
+ * is allocated: the links of the free list are in the memory handed to the
+ * application. */
+typedef struct A_TLSF_BLOCK
+{
+    struct A_TLSF_BLOCK * pxPrevPhysicalBlock; /*<< The block just below this one in memory, NULL for the first one. */
+    size_t xBlockSize;                         /*<< The size of the block, header included, and heapBLOCK_FREE_BIT. */
+    struct A_TLSF_BLOCK * pxNextFreeBlock;     /*<< The other blocks of the same free list. */
+    struct A_TLSF_BLOCK * pxPrevFreeBlock;
+} TlsfBlock_t;
+
+/* The segregated free lists, and a bit set for each of them that is not
+ * empty: in ulFLBitmap for each first level index that has a list that is not
+ * empty, and in ulSLBitmap[ first level index ] for each list. */
+typedef struct xTLSF_CONTROL
+{
+    uint32_t ulFLBitmap;
+    uint32_t ulSLBitmap[ heapFL_COUNT ];
+    TlsfBlock_t * pxFreeLists[ heapFL_COUNT ][ heapSL_COUNT ];
+} TlsfControl_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Called automatically to setup the required heap structures the first time
+ * pvPortMalloc() is called.
+ */
+static void prvHeapInit( void ) PRIVILEGED_FUNCTION;
+
+/*
+ * Adds a free block to the head of the list of its size, and removes it from
+ * the list it is on.
+ */
+static void prvInsertFreeBlock( TlsfBlock_t * pxBlock ) PRIVILEGED_FUNCTION;
+static void prvRemoveFreeBlock( TlsfBlock_t * pxBlock ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns a free block of at least xBlockSize bytes, or NULL.  The block is
+ * left on its free list.
+ */
+static TlsfBlock_t * prvFindFreeBlock( size_t xBlockSize ) PRIVILEGED_FUNCTION;
+
+/*
+ * The list indexes of a block of xBlockSize bytes.
+ */
+static void prvMapSize( size_t xBlockSize,
+                        UBaseType_t * puxFL,
+                        UBaseType_t * puxSL ) PRIVILEGED_FUNCTION;
+
+/*
+ * The position of the highest and of the lowest bit set in ulBits, which must
+ * not be 0.  The ARM7 has no instruction to count leading zeros, so this is a
+ * binary search: five steps whatever the value.
+ */
+static UBaseType_t prvHighestBit( uint32_t ulBits ) PRIVILEGED_FUNCTION;
+#define prvLowestBit( ulBits )    prvHighestBit( ( ulBits ) & ( ~( ulBits ) + 1U ) )
+
+/*
+ * Counts the free blocks, and finds the largest and the smallest of them.
+ * Called with the scheduler suspended.
+ */
+static void prvScanFreeBlocks( size_t * pxBlocks,
+                               size_t * pxMaxSize,
+                               size_t * pxMinSize ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+/* The size of the structure placed at the beginning of each allocated memory
+ * block must by correctly byte aligned. */
+static const size_t xHeapStructSize = ( offsetof( TlsfBlock_t, pxNextFreeBlock ) + ( ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+/* A free block must have room for its whole TlsfBlock_t. */
+static const size_t xMinimumBlockSize = ( sizeof( TlsfBlock_t ) + ( ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+/* The lists, at the start of the heap, and the first block, after them.  The
+ * last block of the heap is a header of size 0 that is never free, to stop the
+ * merging of blocks. */
+PRIVILEGED_DATA static TlsfControl_t * pxControl = NULL;
+PRIVILEGED_DATA static TlsfBlock_t * pxFirstBlock = NULL;
+
+/* Keeps track of the number of calls to allocate and free memory as well as the
+ * number of free bytes remaining, but says nothing about fragmentation. */
+PRIVILEGED_DATA static size_t xFreeBytesRemaining = 0U;
+PRIVILEGED_DATA static size_t xMinimumEverFreeBytesRemaining = 0U;
+PRIVILEGED_DATA static size_t xNumberOfSuccessfulAllocations = 0;
+PRIVILEGED_DATA static size_t xNumberOfSuccessfulFrees = 0;
+
+#if ( configGENERATE_RUN_TIME_STATS == 1 )
+    PRIVILEGED_DATA static configRUN_TIME_COUNTER_TYPE xLongestMalloc = 0;
+    PRIVILEGED_DATA static configRUN_TIME_COUNTER_TYPE xLongestFree = 0;
+#endif
+
+/*-----------------------------------------------------------*/
+
+void * pvPortMalloc( size_t xWantedSize )
+{
+    TlsfBlock_t * pxBlock;
+    TlsfBlock_t * pxRemainder;
+    void * pvReturn = NULL;
+
+    #if ( configGENERATE_RUN_TIME_STATS == 1 )
+        configRUN_TIME_COUNTER_TYPE xStartTime, xTime;
+    #endif
+
+    vTaskSuspendAll();
+    {
+        #if ( configGENERATE_RUN_TIME_STATS == 1 )
+        {
+            xStartTime = portGET_RUN_TIME_COUNTER_VALUE();
+        }
+        #endif
+
+        /* If this is the first call to malloc then the heap will require
+         * initialisation to setup the free lists. */
+        if( pxControl == NULL )
+        {
+            prvHeapInit();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        if( xWantedSize > 0 )
+        {
+            /* The wanted size must be increased so it can contain the block
+             * header in addition to the requested amount of bytes, and rounded
+             * up to keep the next block aligned. */
+            if( heapADD_WILL_OVERFLOW( xWantedSize, xHeapStructSize + portBYTE_ALIGNMENT_MASK ) == 0 )
+            {
+                xWantedSize = ( xWantedSize + xHeapStructSize + portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+                if( xWantedSize < xMinimumBlockSize )
+                {
+                    xWantedSize = xMinimumBlockSize;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                xWantedSize = 0;
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        if( ( xWantedSize > 0 ) && ( xWantedSize <= xFreeBytesRemaining ) )
+        {
+            pxBlock = prvFindFreeBlock( xWantedSize );
+
+            if( pxBlock != NULL )
+            {
+                prvRemoveFreeBlock( pxBlock );
+
+                /* If the block is larger than required it can be split into
+                 * two.  The block after the remainder cannot be free, as it
+                 * would have been merged with this one. */
+                if( ( heapBLOCK_SIZE( pxBlock ) - xWantedSize ) >= xMinimumBlockSize )
+                {
+                    pxRemainder = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xWantedSize );
+                    configASSERT( ( ( ( size_t ) pxRemainder ) & portBYTE_ALIGNMENT_MASK ) == 0 );
+
+                    pxRemainder->xBlockSize = ( heapBLOCK_SIZE( pxBlock ) - xWantedSize ) | heapBLOCK_FREE_BIT;
+                    pxRemainder->pxPrevPhysicalBlock = pxBlock;
+                    heapNEXT_PHYSICAL_BLOCK( pxRemainder )->pxPrevPhysicalBlock = pxRemainder;
+                    pxBlock->xBlockSize = xWantedSize;
+
+                    prvInsertFreeBlock( pxRemainder );
+                }
+                else
+                {
+                    pxBlock->xBlockSize = heapBLOCK_SIZE( pxBlock );
+                }
+
+                xFreeBytesRemaining -= pxBlock->xBlockSize;
+
+                if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
+                {
+                    xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                xNumberOfSuccessfulAllocations++;
+                pvReturn = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xHeapStructSize );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        traceMALLOC( pvReturn, xWantedSize );
+
+        #if ( configGENERATE_RUN_TIME_STATS == 1 )
+        {
+            xTime = portGET_RUN_TIME_COUNTER_VALUE() - xStartTime;
+
+            if( xTime > xLongestMalloc )
+            {
+                xLongestMalloc = xTime;
+            }
+        }
+        #endif
+    }
+    ( void ) xTaskResumeAll();
+
+    #if ( configUSE_MALLOC_FAILED_HOOK == 1 )
+    {
+        if( pvReturn == NULL )
+        {
+            vApplicationMallocFailedHook();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    #endif /* if ( configUSE_MALLOC_FAILED_HOOK == 1 ) */
+
+    configASSERT( ( ( ( size_t ) pvReturn ) & ( size_t ) portBYTE_ALIGNMENT_MASK ) == 0 );
+    return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vPortFree( void * pv )
+{
+    TlsfBlock_t * pxBlock;
+    TlsfBlock_t * pxNeighbour;
+
+    #if ( configGENERATE_RUN_TIME_STATS == 1 )
+        configRUN_TIME_COUNTER_TYPE xStartTime, xTime;
+    #endif
+
+    if( pv != NULL )
+    {
+        /* The memory being freed will have a block header immediately before
+         * it. */
+        pxBlock = ( void * ) ( ( ( uint8_t * ) pv ) - xHeapStructSize );
+
+        configASSERT( heapBLOCK_IS_FREE( pxBlock ) == 0 );
+
+        if( heapBLOCK_IS_FREE( pxBlock ) == 0 )
+        {
+            #if ( configHEAP_CLEAR_MEMORY_ON_FREE == 1 )
+            {
+                ( void ) memset( pv, 0, pxBlock->xBlockSize - xHeapStructSize );
+            }
+            #endif
+
+            vTaskSuspendAll();
+            {
+                #if ( configGENERATE_RUN_TIME_STATS == 1 )
+                {
+                    xStartTime = portGET_RUN_TIME_COUNTER_VALUE();
+                }
+                #endif
+
+                xFreeBytesRemaining += pxBlock->xBlockSize;
+                traceFREE( pv, pxBlock->xBlockSize );
+
+                /* Merge the block with the one before it in memory if that one
+                 * is free, then with the one after it. */
+                pxNeighbour = pxBlock->pxPrevPhysicalBlock;
+
+                if( ( pxNeighbour != NULL ) && ( heapBLOCK_IS_FREE( pxNeighbour ) ) )
+                {
+                    prvRemoveFreeBlock( pxNeighbour );
+                    pxNeighbour->xBlockSize += pxBlock->xBlockSize;
+                    pxBlock = pxNeighbour;
+                }
+                else
+                {
+                    pxBlock->xBlockSize |= heapBLOCK_FREE_BIT;
+                }
+
+                pxNeighbour = heapNEXT_PHYSICAL_BLOCK( pxBlock );
+
+                if( heapBLOCK_IS_FREE( pxNeighbour ) )
+                {
+                    prvRemoveFreeBlock( pxNeighbour );
+                    pxBlock->xBlockSize += heapBLOCK_SIZE( pxNeighbour );
+                    pxNeighbour = heapNEXT_PHYSICAL_BLOCK( pxBlock );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                pxNeighbour->pxPrevPhysicalBlock = pxBlock;
+                prvInsertFreeBlock( pxBlock );
+                xNumberOfSuccessfulFrees++;
+
+                #if ( configGENERATE_RUN_TIME_STATS == 1 )
+                {
+                    xTime = portGET_RUN_TIME_COUNTER_VALUE() - xStartTime;
+
+                    if( xTime > xLongestFree )
+                    {
+                        xLongestFree = xTime;
+                    }
+                }
+                #endif
+            }
+            ( void ) xTaskResumeAll();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetFreeHeapSize( void )
+{
+    return xFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetMinimumEverFreeHeapSize( void )
+{
+    return xMinimumEverFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+void vPortInitialiseBlocks( void )
+{
+    /* This just exists to keep the linker quiet. */
+}
+/*-----------------------------------------------------------*/
+
+void * pvPortCalloc( size_t xNum,
+                     size_t xSize )
+{
+    void * pv = NULL;
+
+    if( heapMULTIPLY_WILL_OVERFLOW( xNum, xSize ) == 0 )
+    {
+        pv = pvPortMalloc( xNum * xSize );
+
+        if( pv != NULL )
+        {
+            ( void ) memset( pv, 0, xNum * xSize );
+        }
+    }
+
+    return pv;
+}
+/*-----------------------------------------------------------*/
+
+static void prvHeapInit( void ) /* PRIVILEGED_FUNCTION */
+{
+    TlsfBlock_t * pxEnd;
+    uint8_t * pucAlignedHeap;
+    portPOINTER_SIZE_TYPE uxAddress;
+    size_t xTotalHeapSize = configTOTAL_HEAP_SIZE;
+    const size_t xControlSize = ( sizeof( TlsfControl_t ) + ( ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+    /* Ensure the heap starts on a correctly aligned boundary. */
+    uxAddress = ( portPOINTER_SIZE_TYPE ) ucHeap;
+
+    if( ( uxAddress & portBYTE_ALIGNMENT_MASK ) != 0 )
+    {
+        uxAddress += ( portBYTE_ALIGNMENT - 1 );
+        uxAddress &= ~( ( portPOINTER_SIZE_TYPE ) portBYTE_ALIGNMENT_MASK );
+        xTotalHeapSize -= uxAddress - ( portPOINTER_SIZE_TYPE ) ucHeap;
+    }
+
+    pucAlignedHeap = ( uint8_t * ) uxAddress;
+
+    /* The free lists take the start of the heap, all empty to begin with. */
+    pxControl = ( void * ) pucAlignedHeap;
+    ( void ) memset( pxControl, 0, sizeof( TlsfControl_t ) );
+    pucAlignedHeap += xControlSize;
+    xTotalHeapSize -= xControlSize;
+
+    /* pxEnd marks the end of the heap, and is never free. */
+    uxAddress = ( ( portPOINTER_SIZE_TYPE ) pucAlignedHeap ) + xTotalHeapSize;
+    uxAddress -= xHeapStructSize;
+    uxAddress &= ~( ( portPOINTER_SIZE_TYPE ) portBYTE_ALIGNMENT_MASK );
+    pxEnd = ( TlsfBlock_t * ) uxAddress;
+
+    /* To start with there is a single free block that is sized to take up the
+     * entire heap space, minus the space taken by pxEnd. */
+    pxFirstBlock = ( TlsfBlock_t * ) pucAlignedHeap;
+    pxFirstBlock->pxPrevPhysicalBlock = NULL;
+    pxFirstBlock->xBlockSize = ( ( size_t ) ( uxAddress - ( portPOINTER_SIZE_TYPE ) pxFirstBlock ) ) | heapBLOCK_FREE_BIT;
+    pxEnd->pxPrevPhysicalBlock = pxFirstBlock;
+    pxEnd->xBlockSize = 0;
+
+    prvInsertFreeBlock( pxFirstBlock );
+
+    /* Only one block exists - and it covers the entire usable heap space. */
+    xMinimumEverFreeBytesRemaining = heapBLOCK_SIZE( pxFirstBlock );
+    xFreeBytesRemaining = heapBLOCK_SIZE( pxFirstBlock );
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvHighestBit( uint32_t ulBits ) /* PRIVILEGED_FUNCTION */
+{
+    UBaseType_t uxBit = 0;
+
+    if( ( ulBits & 0xFFFF0000UL ) != 0 )
+    {
+        ulBits >>= 16;
+        uxBit += 16;
+    }
+
+    if( ( ulBits & 0xFF00UL ) != 0 )
+    {
+        ulBits >>= 8;
+        uxBit += 8;
+    }
+
+    if( ( ulBits & 0xF0UL ) != 0 )
+    {
+        ulBits >>= 4;
+        uxBit += 4;
+    }
+
+    if( ( ulBits & 0xCUL ) != 0 )
+    {
+        ulBits >>= 2;
+        uxBit += 2;
+    }
+
+    if( ( ulBits & 0x2UL ) != 0 )
+    {
+        uxBit += 1;
+    }
+
+    return uxBit;
+}
+/*-----------------------------------------------------------*/
+
+static void prvMapSize( size_t xBlockSize,
+                        UBaseType_t * puxFL,
+                        UBaseType_t * puxSL ) /* PRIVILEGED_FUNCTION */
+{
+    UBaseType_t uxBit;
+
+    if( xBlockSize < heapSMALL_BLOCK_SIZE )
+    {
+        *puxFL = 0;
+        *puxSL = ( UBaseType_t ) ( xBlockSize / portBYTE_ALIGNMENT );
+    }
+    else
+    {
+        uxBit = prvHighestBit( ( uint32_t ) xBlockSize );
+        *puxFL = uxBit - heapFL_SHIFT + 1U;
+        *puxSL = ( UBaseType_t ) ( xBlockSize >> ( uxBit - configTLSF_SL_INDEX_COUNT_LOG2 ) ) ^ heapSL_COUNT;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static TlsfBlock_t * prvFindFreeBlock( size_t xBlockSize ) /* PRIVILEGED_FUNCTION */
+{
+    TlsfBlock_t * pxBlock = NULL;
+    UBaseType_t uxFL, uxSL;
+    uint32_t ulMap;
+    size_t xRoundedSize = xBlockSize;
+
+    /* Any block of the list a size maps to may be smaller than it.  Rounding
+     * the size up to the next list first makes any block of that list or of a
+     * later one large enough. */
+    if( xBlockSize >= heapSMALL_BLOCK_SIZE )
+    {
+        xRoundedSize += ( ( size_t ) 1 << ( prvHighestBit( ( uint32_t ) xBlockSize ) - configTLSF_SL_INDEX_COUNT_LOG2 ) ) - 1U;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    prvMapSize( xRoundedSize, &uxFL, &uxSL );
+
+    if( uxFL < heapFL_COUNT )
+    {
+        ulMap = pxControl->ulSLBitmap[ uxFL ] & heapBITS_FROM( uxSL );
+
+        if( ulMap == 0 )
+        {
+            ulMap = pxControl->ulFLBitmap & heapBITS_FROM( uxFL + 1U );
+
+            if( ulMap != 0 )
+            {
+                uxFL = prvLowestBit( ulMap );
+                ulMap = pxControl->ulSLBitmap[ uxFL ];
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        if( ulMap != 0 )
+        {
+            pxBlock = pxControl->pxFreeLists[ uxFL ][ prvLowestBit( ulMap ) ];
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    /* Otherwise the only blocks that can be large enough are on the list the
+     * size itself maps to, as when most of the heap is asked for at once.  Its
+     * head is tried, which keeps the search bounded. */
+    if( pxBlock == NULL )
+    {
+        prvMapSize( xBlockSize, &uxFL, &uxSL );
+        pxBlock = pxControl->pxFreeLists[ uxFL ][ uxSL ];
+
+        if( ( pxBlock != NULL ) && ( heapBLOCK_SIZE( pxBlock ) < xBlockSize ) )
+        {
+            pxBlock = NULL;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    return pxBlock;
+}
+/*-----------------------------------------------------------*/
+
+static void prvInsertFreeBlock( TlsfBlock_t * pxBlock ) /* PRIVILEGED_FUNCTION */
+{
+    UBaseType_t uxFL, uxSL;
+    TlsfBlock_t * pxHead;
+
+    prvMapSize( heapBLOCK_SIZE( pxBlock ), &uxFL, &uxSL );
+    pxHead = pxControl->pxFreeLists[ uxFL ][ uxSL ];
+
+    pxBlock->pxNextFreeBlock = pxHead;
+    pxBlock->pxPrevFreeBlock = NULL;
+
+    if( pxHead != NULL )
+    {
+        pxHead->pxPrevFreeBlock = pxBlock;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    pxControl->pxFreeLists[ uxFL ][ uxSL ] = pxBlock;
+    pxControl->ulFLBitmap |= heapBIT( uxFL );
+    pxControl->ulSLBitmap[ uxFL ] |= heapBIT( uxSL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvRemoveFreeBlock( TlsfBlock_t * pxBlock ) /* PRIVILEGED_FUNCTION */
+{
+    UBaseType_t uxFL, uxSL;
+
+    if( pxBlock->pxNextFreeBlock != NULL )
+    {
+        pxBlock->pxNextFreeBlock->pxPrevFreeBlock = pxBlock->pxPrevFreeBlock;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    if( pxBlock->pxPrevFreeBlock != NULL )
+    {
+        pxBlock->pxPrevFreeBlock->pxNextFreeBlock = pxBlock->pxNextFreeBlock;
+    }
+    else
+    {
+        /* The block is the head of its list. */
+        prvMapSize( heapBLOCK_SIZE( pxBlock ), &uxFL, &uxSL );
+        pxControl->pxFreeLists[ uxFL ][ uxSL ] = pxBlock->pxNextFreeBlock;
+
+        if( pxBlock->pxNextFreeBlock == NULL )
+        {
+            pxControl->ulSLBitmap[ uxFL ] &= ~heapBIT( uxSL );
+
+            if( pxControl->ulSLBitmap[ uxFL ] == 0 )
+            {
+                pxControl->ulFLBitmap &= ~heapBIT( uxFL );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvScanFreeBlocks( size_t * pxBlocks,
+                               size_t * pxMaxSize,
+                               size_t * pxMinSize ) /* PRIVILEGED_FUNCTION */
+{
+    TlsfBlock_t * pxBlock = pxFirstBlock;
+
+    *pxBlocks = 0;
+    *pxMaxSize = 0;
+    *pxMinSize = portMAX_DELAY; /* portMAX_DELAY used as a portable way of getting the maximum value. */
+
+    /* pxBlock will be NULL if the heap has not been initialised.  The heap
+     * is initialised automatically when the first allocation is made.  The
+     * walk ends on pxEnd, the only block of size 0. */
+    if( pxBlock != NULL )
+    {
+        while( heapBLOCK_SIZE( pxBlock ) != 0 )
+        {
+            if( heapBLOCK_IS_FREE( pxBlock ) )
+            {
+                ( *pxBlocks )++;
+
+                if( heapBLOCK_SIZE( pxBlock ) > *pxMaxSize )
+                {
+                    *pxMaxSize = heapBLOCK_SIZE( pxBlock );
+                }
+
+                if( heapBLOCK_SIZE( pxBlock ) < *pxMinSize )
+                {
+                    *pxMinSize = heapBLOCK_SIZE( pxBlock );
+                }
+            }
+
+            pxBlock = heapNEXT_PHYSICAL_BLOCK( pxBlock );
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vPortGetHeapStats( HeapStats_t * pxHeapStats )
+{
+    size_t xBlocks, xMaxSize, xMinSize;
+
+    vTaskSuspendAll();
+    {
+        prvScanFreeBlocks( &xBlocks, &xMaxSize, &xMinSize );
+    }
+    ( void ) xTaskResumeAll();
+
+    pxHeapStats->xSizeOfLargestFreeBlockInBytes = xMaxSize;
+    pxHeapStats->xSizeOfSmallestFreeBlockInBytes = xMinSize;
+    pxHeapStats->xNumberOfFreeBlocks = xBlocks;
+
+    taskENTER_CRITICAL();
+    {
+        pxHeapStats->xAvailableHeapSpaceInBytes = xFreeBytesRemaining;
+        pxHeapStats->xNumberOfSuccessfulAllocations = xNumberOfSuccessfulAllocations;
+        pxHeapStats->xNumberOfSuccessfulFrees = xNumberOfSuccessfulFrees;
+        pxHeapStats->xMinimumEverFreeBytesRemaining = xMinimumEverFreeBytesRemaining;
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vPortGetTLSFStats( HeapTLSFStats_t * pxStats )
+{
+    size_t xBlocks, xMaxSize, xMinSize;
+
+    vTaskSuspendAll();
+    {
+        prvScanFreeBlocks( &xBlocks, &xMaxSize, &xMinSize );
+        pxStats->xFreeBytes = xFreeBytesRemaining;
+
+        #if ( configGENERATE_RUN_TIME_STATS == 1 )
+        {
+            pxStats->xLongestMalloc = xLongestMalloc;
+            pxStats->xLongestFree = xLongestFree;
+        }
+        #endif
+    }
+    ( void ) xTaskResumeAll();
+
+    pxStats->xLargestFreeBlock = xMaxSize;
+
+    if( pxStats->xFreeBytes != 0 )
+    {
+        pxStats->xFragmentation = 1000U - ( size_t ) ( ( ( uint64_t ) xMaxSize * 1000U ) / pxStats->xFreeBytes );
+    }
+    else
+    {
+        pxStats->xFragmentation = 0;
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vPortResetTLSFTimes( void )
+{
+    #if ( configGENERATE_RUN_TIME_STATS == 1 )
+    {
+        vTaskSuspendAll();
+        {
+            xLongestMalloc = 0;
+            xLongestFree = 0;
+        }
+        ( void ) xTaskResumeAll();
+    }
+    #endif
+}
+/*-----------------------------------------------------------*/
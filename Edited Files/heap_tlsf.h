@@ -0,0 +1,40 @@
+/*
+ * Two-level segregated fit (TLSF) heap, see heap_tlsf.c.
+ *
+ * heap_tlsf.c is a drop in replacement for the heap_x.c files of the kernel:
+ * build it instead of heap_2.c to have pvPortMalloc() and vPortFree() run in
+ * bounded time, whatever the number and the sizes of the blocks on the heap.
+ * This header only declares the statistics the other heaps do not keep.
+ */
+
+#ifndef HEAP_TLSF_H
+#define HEAP_TLSF_H
+
+/* The statistics depend on configGENERATE_RUN_TIME_STATS, so every file sees
+ * them as heap_tlsf.c does. */
+#include "FreeRTOS.h"
+
+typedef struct xHEAP_TLSF_STATS
+{
+    size_t xFreeBytes;            /*< The same as xPortGetFreeHeapSize(). */
+    size_t xLargestFreeBlock;     /*< The largest allocation that can succeed is this, less the block header. */
+    size_t xFragmentation;        /*< 1000 * ( 1 - xLargestFreeBlock / xFreeBytes ): 0 when the free space is in one block. */
+    #if ( configGENERATE_RUN_TIME_STATS == 1 )
+        configRUN_TIME_COUNTER_TYPE xLongestMalloc; /*< Longest time spent in pvPortMalloc() with the scheduler suspended, in run time counter units. */
+        configRUN_TIME_COUNTER_TYPE xLongestFree;   /*< The same for vPortFree(). */
+    #endif
+} HeapTLSFStats_t;
+
+/*
+ * Fills *pxStats.  Walks the blocks of the heap, so takes time in proportion
+ * to their number: meant for diagnostics, not for the paths that allocate.
+ */
+void vPortGetTLSFStats( HeapTLSFStats_t * pxStats );
+
+/*
+ * Forgets the longest times measured so far, for example at the start of a
+ * mode change that is to be measured on its own.
+ */
+void vPortResetTLSFTimes( void );
+
+#endif /* HEAP_TLSF_H */
@@ -62,8 +62,12 @@
 #include "lpc21xx.h"
 #include "queue.h"
 
+/* Task table, generated from the Simso model. */
+#include "app_tasks.h"
+
 /* Peripheral includes. */
 #include "serial.h"
+#include "serial_tx.h"
 #include "GPIO.h"
 
 
@@ -72,33 +76,48 @@
 #define Btn_Rising	2
 #define Btn_Falling 3
 
+/* Events of the producer tasks, one bit each of the notification value of
+   Uart_Rx.  The bits set since its last wait are all taken at once */
+#define mainEVT_PERIODIC_STRING	( 1UL << 0 )
+#define mainEVT_BTN1_RISING		( 1UL << 1 )
+#define mainEVT_BTN1_FALLING	( 1UL << 2 )
+#define mainEVT_BTN2_RISING		( 1UL << 3 )
+#define mainEVT_BTN2_FALLING	( 1UL << 4 )
+#define mainEVT_ALL				( 0x1FUL )
+
 /*   Global data */
-#define Task1_Period 50
-#define Task2_Period 50
-#define Task3_Period 100
-#define Task4_Period 20
-#define Task5_Period 10
-#define Task6_Period 100
+/* The periods TaskN_Period are in app_tasks.h */
 /*- - - - -  - - - - -  - - */
 
-int Task_1_IN=0 , Task_1_OUT=0 , Task_1_Total=0;
-int Task_2_IN=0 , Task_2_OUT=0 , Task_2_Total=0;
-int Task_3_IN=0 , Task_3_OUT=0 , Task_3_Total=0;
-int Task_4_IN=0 , Task_4_OUT=0 , Task_4_Total=0;
-int Task_5_IN=0 , Task_5_OUT=0 , Task_5_Total=0;
-int Task_6_IN=0 , Task_6_OUT=0 , Task_6_Total=0;
 int Systm_Time = 0 , CPU_Load = 0;
 
 /* Tasks Handler */
 
 
-TaskHandle_t Btn_1TaskHandle = NULL;
-TaskHandle_t Btn_2TaskHandle = NULL;
-TaskHandle_t Tx_TaskHandle = NULL;
-TaskHandle_t Uart_TaskHandle = NULL;
-TaskHandle_t L1TaskHandle = NULL;
-TaskHandle_t L2TaskHandle = NULL;
-QueueHandle_t QueueBtn_1=NULL,QueueBtn_2=NULL ,QueueTx=NULL;
+/* In the order of xAppTasks */
+TaskHandle_t xAppTaskHandles[ appTASK_COUNT ];
+
+/* Uart_Rx, which the producer tasks notify of their events */
+TaskHandle_t RxTask = NULL;
+
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
+/* Without a heap, the TCBs of the tasks of xAppTasks, and their stacks one
+   after the other in the order of the table */
+static StaticPeriodicTask_t xAppTaskBuffers[ appTASK_COUNT ];
+static StackType_t xAppTaskStacks[ appSTACK_WORDS ];
+#endif
+
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+/* Memory of the idle task, given to the kernel by
+   vApplicationGetIdlePeriodicTaskMemory(), or vApplicationGetIdleTaskMemory()
+   without EDF */
+#if ( configUSE_EDF_SCHEDULER == 1 )
+static StaticPeriodicTask_t xIdleTaskBuffer;
+#else
+static StaticTask_t xIdleTaskBuffer;
+#endif
+static StackType_t xIdleTaskStack[ configMINIMAL_STACK_SIZE ];
+#endif
 
 
 /* Constants to setup I/O and processor. */
@@ -107,12 +126,42 @@ QueueHandle_t QueueBtn_1=NULL,QueueBtn_2=NULL ,QueueTx=NULL;
 /* Constants for the ComTest demo application tasks. */
 #define mainCOM_TEST_BAUD_RATE	( ( unsigned long ) 115200 )
 
+#if ( configUSE_STACK_PROFILING == 1 )
+/* Ticks of training run after which the stack use of the tasks is reported,
+   see prvReportStacks(). */
+#define mainSTACK_TRAINING_TICKS	( ( TickType_t ) 10000 )
+#endif
+
 /*
  * Configure the processor for use with the Keil demo board.  This is very
  * minimal as most of the setup is managed by the settings in the project
  * file.
  */
 static void prvSetupHardware( void );
+
+/*
+ * Ticks Uart_Rx can still wait for a message in the job released at
+ * xReleaseTime.  The wait ends a tick before the deadline, so that a job
+ * woken by the timeout has the time to complete.
+ */
+static TickType_t prvRxWaitTicks( TickType_t xReleaseTime );
+
+/*
+ * Posts the events ulEvents to Uart_Rx, once it exists.
+ */
+static void prvPostEvents( uint32_t ulEvents );
+
+/*
+ * Prints on the UART the message of each of the events ulEvents.
+ */
+static void prvPrintEvents( uint32_t ulEvents );
+
+#if ( configUSE_STACK_PROFILING == 1 )
+/*
+ * Prints the stack use of the tasks of xAppTasks on the UART, once.
+ */
+static void prvReportStacks( void );
+#endif
 /*-----------------------------------------------------------*/
 
 /*
@@ -125,6 +174,11 @@ static void prvSetupHardware( void );
 void vApplicationTickHook( void )
 {
 	GPIO_write(PORT_0 , PIN8 , PIN_IS_HIGH);
+	
+	/* Load over the last 100 ms in percent, for the logic analyzer */
+	Systm_Time = T1TC;
+	CPU_Load = uxTaskGetCpuLoad(tskCPU_LOAD_WINDOW) / 10;
+	
 	GPIO_write(PORT_0 , PIN8 , PIN_IS_LOW);
 }
 
@@ -132,8 +186,32 @@ void vApplicationIdleHook( void )
 {
 	GPIO_write(PORT_0 , PIN9 , PIN_IS_HIGH);
 	GPIO_write(PORT_0 , PIN9 , PIN_IS_LOW);
+
+	#if ( configUSE_STACK_PROFILING == 1 )
+	{
+		if( xTaskGetTickCount() >= mainSTACK_TRAINING_TICKS )
+		{
+			prvReportStacks();
+		}
+	}
+	#endif
 }
 
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+
+#if ( configUSE_EDF_SCHEDULER == 1 )
+void vApplicationGetIdlePeriodicTaskMemory( StaticPeriodicTask_t ** ppxIdleTaskTCBBuffer , StackType_t ** ppxIdleTaskStackBuffer , uint32_t * pulIdleTaskStackSize )
+#else
+void vApplicationGetIdleTaskMemory( StaticTask_t ** ppxIdleTaskTCBBuffer , StackType_t ** ppxIdleTaskStackBuffer , uint32_t * pulIdleTaskStackSize )
+#endif
+{
+	*ppxIdleTaskTCBBuffer = &xIdleTaskBuffer;
+	*ppxIdleTaskStackBuffer = xIdleTaskStack;
+	*pulIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+}
+
+#endif
+
 
 /* -------------------   Task 1   -----------------------------*/
 /* ------------------------------------------------------------*/
@@ -141,7 +219,7 @@ void Btn1(void * pvParameters)
 {
 	volatile unsigned char prvState , nxtState , Btn1_State;
 	TickType_t xLastWakeTime = xTaskGetTickCount();
-	vTaskSetApplicationTaskTag(NULL , (void *) 1);
+	vTaskSetTracePin(NULL , PIN2);
 	
 	prvState = GPIO_read(PORT_0 , PIN0);
 
@@ -172,9 +250,13 @@ void Btn1(void * pvParameters)
 		}
 	}
 	prvState = nxtState;
-	if(QueueBtn_1 != NULL)
+	if(Btn1_State == Btn_Rising)
 	{
-		xQueueSend(QueueBtn_1, (void *) &Btn1_State,0);
+		prvPostEvents(mainEVT_BTN1_RISING);
+	}
+	else if(Btn1_State == Btn_Falling)
+	{
+		prvPostEvents(mainEVT_BTN1_FALLING);
 	}
   vTaskDelayUntil( &xLastWakeTime, Task1_Period );
 	GPIO_write(PORT_0 , PIN9 , PIN_IS_LOW);
@@ -189,7 +271,7 @@ void Btn2(void * pvParameters)
 {
 	volatile unsigned char prvState , nxtState , Btn2_State;
 	TickType_t xLastWakeTime = xTaskGetTickCount();
-	vTaskSetApplicationTaskTag(NULL , (void *) 2);
+	vTaskSetTracePin(NULL , PIN3);
 	
 	prvState = GPIO_read(PORT_0 , PIN1);
 
@@ -221,9 +303,13 @@ void Btn2(void * pvParameters)
 		}
 	}
 	prvState = nxtState;
-	if(QueueBtn_2 != NULL)
+	if(Btn2_State == Btn_Rising)
+	{
+		prvPostEvents(mainEVT_BTN2_RISING);
+	}
+	else if(Btn2_State == Btn_Falling)
 	{
-		xQueueSend(QueueBtn_2, (void *) &Btn2_State,0);
+		prvPostEvents(mainEVT_BTN2_FALLING);
 	}
   vTaskDelayUntil( &xLastWakeTime, Task2_Period );
 	GPIO_write(PORT_0 , PIN9 , PIN_IS_LOW);
@@ -239,15 +325,11 @@ void Btn2(void * pvParameters)
 void Task_Tx( void * pvParameters )
 {
 	TickType_t xLastWakeTime = xTaskGetTickCount();
-	unsigned char periodic_Str = Periodic_String;
-	vTaskSetApplicationTaskTag(NULL , (void *) 3);
+	vTaskSetTracePin(NULL , PIN4);
 	
 	while(1)
 	{
-		if(QueueTx != NULL)
-		{
-			xQueueSend(QueueTx, (void *) &periodic_Str,0);
-		}
+		prvPostEvents(mainEVT_PERIODIC_STRING);
 		vTaskDelayUntil( &xLastWakeTime, Task3_Period );
 		GPIO_write(PORT_0 , PIN9 , PIN_IS_LOW);
 	}
@@ -261,64 +343,70 @@ void Task_Tx( void * pvParameters )
 void Uart_Rx( void * pvParameters )
 {
 	TickType_t xLastWakeTime = xTaskGetTickCount();
-	unsigned char Buffer;
-	vTaskSetApplicationTaskTag(NULL , (void *) 4);
+	uint32_t ulEvents;
+	vTaskSetTracePin(NULL , PIN5);
 
 	while(1)
 	{
-	if(QueueTx != NULL)
-	{
-		if((xQueueReceive(QueueTx , (void *)&Buffer ,(TickType_t)10)) == pdPASS)
-		{
-			if(Buffer == Periodic_String)
-			{
-				vSerialPutString((const signed char *const)"I'm Task 3\n" , 12);
-			}
-		}
-	}
-	if((xQueueReceive(QueueBtn_1 , (void *)&Buffer ,(TickType_t)10)) == pdPASS)
-		{
-			if(Buffer == Btn_Rising)
-			{
-				vSerialPutString((const signed char *const)"Btn(1)Rising\n" , 13);
-			}
-			else if(Buffer == Btn_Falling)
-			{
-				vSerialPutString((const signed char *const)"Btn(1)Falling\n" , 14);
-			}
-			else
-			{
-				/* Do Nothing */
-			}
-		}
-		if((xQueueReceive(QueueBtn_2 , (void *)&Buffer ,(TickType_t)10)) == pdPASS)
+		/* A single wait for the events of all the producers: returns at once
+		   if any is pending, and otherwise blocks until the next one is posted
+		   or the wait of the job is over */
+		while(xTaskNotifyWait(0 , mainEVT_ALL , &ulEvents , prvRxWaitTicks(xLastWakeTime)) == pdTRUE)
 		{
-			if(Buffer == Btn_Rising)
-			{
-				vSerialPutString((const signed char *const)"Btn(2)Rising\n" , 13);
-			}
-			else if(Buffer == Btn_Falling)
-			{
-				vSerialPutString((const signed char *const)"Btn(2)Falling\n" , 14);
-			}
-			else
-			{
-				/* Do Nothing */
-			}
+			prvPrintEvents(ulEvents);
 		}
-	
+
 		vTaskDelayUntil( &xLastWakeTime, Task4_Period );
 		GPIO_write(PORT_0 , PIN9 , PIN_IS_LOW);
 	}
 	
 }
 
+static TickType_t prvRxWaitTicks( TickType_t xReleaseTime )
+{
+	TickType_t xElapsed = xTaskGetTickCount() - xReleaseTime;
+
+	return ( xElapsed < ( Task4_Period - 1 ) ) ? ( Task4_Period - 1 - xElapsed ) : 0;
+}
+
+static void prvPostEvents( uint32_t ulEvents )
+{
+	if(RxTask != NULL)
+	{
+		xTaskNotify(RxTask , ulEvents , eSetBits);
+	}
+}
+
+static void prvPrintEvents( uint32_t ulEvents )
+{
+	if((ulEvents & mainEVT_PERIODIC_STRING) != 0)
+	{
+		vSerialPutString((const signed char *const)"I'm Task 3\n" , 12);
+	}
+	if((ulEvents & mainEVT_BTN1_RISING) != 0)
+	{
+		vSerialPutString((const signed char *const)"Btn(1)Rising\n" , 13);
+	}
+	if((ulEvents & mainEVT_BTN1_FALLING) != 0)
+	{
+		vSerialPutString((const signed char *const)"Btn(1)Falling\n" , 14);
+	}
+	if((ulEvents & mainEVT_BTN2_RISING) != 0)
+	{
+		vSerialPutString((const signed char *const)"Btn(2)Rising\n" , 13);
+	}
+	if((ulEvents & mainEVT_BTN2_FALLING) != 0)
+	{
+		vSerialPutString((const signed char *const)"Btn(2)Falling\n" , 14);
+	}
+}
+
 
 void Load_1_Simulation( void * pvParameters )
 {
 		int i = 0;
 		TickType_t xLastWakeTime = xTaskGetTickCount();
-		vTaskSetApplicationTaskTag(NULL , (void *) 5);
+		vTaskSetTracePin(NULL , PIN6);
 		while(1)
 		{
 			for(i = 0 ; i<33300 ;i++)
@@ -335,7 +423,7 @@ void Load_2_Simulation( void * pvParameters )
 {
 		int i = 0;
 		TickType_t xLastWakeTime = xTaskGetTickCount();
-		vTaskSetApplicationTaskTag(NULL , (void *) 6);
+		vTaskSetTracePin(NULL , PIN7);
 		while(1)
 		{
 			for(i = 0 ; i<79900 ;i++)
@@ -350,73 +438,45 @@ void Load_2_Simulation( void * pvParameters )
 
 int main( void )
 {
-		xSerialPortInitMinimal(ser9600);
-		
-		QueueBtn_1    = xQueueCreate( 1,sizeof(char*) );
-	
-		QueueBtn_2    = xQueueCreate( 1,sizeof(char*) );	
-
-		QueueTx				= xQueueCreate( 1,sizeof(char*) );
+	UBaseType_t x;
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
+	StackType_t *pxStack;
+#endif
 
+		xSerialPortInitMinimal(ser9600);
 	
 	/* Setup the hardware for use with the Keil demo board. */
 	prvSetupHardware();
 	
 	
 	
-    /* Create Tasks here */
-	xTaskPeriodicCreate(
-                    Btn1,       /* Function that implements the task. */
-                    "Button_1",          /* Text name for the task. */
-                     100 ,      /* Stack size in words, not bytes. */
-                    ( void * ) 0,    /* Parameter passed into the task. */
-                    1,/* Priority at which the task is created. */
-                    &Btn_1TaskHandle ,
-										Task1_Period); 
-	xTaskPeriodicCreate(
-                    Btn2,       /* Function that implements the task. */
-                    "Button_2",          /* Text name for the task. */
-                     100 ,      /* Stack size in words, not bytes. */
-                    ( void * ) 0,    /* Parameter passed into the task. */
-                    1,/* Priority at which the task is created. */
-                    &Btn_2TaskHandle ,/* Used to pass out the created task's handle. */	
-										Task2_Period); 		/* Period of Task */								
-										
-										
-	xTaskPeriodicCreate(
-                    Task_Tx,       /* Function that implements the task. */
-                    "Task_Tx",          /* Text name for the task. */
-                     100 ,      /* Stack size in words, not bytes. */
-                    ( void * ) 0,    /* Parameter passed into the task. */
-                    1,/* Priority at which the task is created. */
-                    &Tx_TaskHandle ,
-										Task3_Period);
-	xTaskPeriodicCreate(
-                    Uart_Rx,       /* Function that implements the task. */
-                    "Rx",          /* Text name for the task. */
-                     100 ,      /* Stack size in words, not bytes. */
-                    ( void * ) 0,    /* Parameter passed into the task. */
-                    1,/* Priority at which the task is created. */
-                    &Uart_TaskHandle ,
-										Task4_Period);
-	 										
-  xTaskPeriodicCreate(
-                    Load_1_Simulation,       /* Function that implements the task. */
-                    "Load_1_Simulation",          /* Text name for the task. */
-                     100 ,      /* Stack size in words, not bytes. */
-                    ( void * ) 0,    /* Parameter passed into the task. */
-                    1,/* Priority at which the task is created. */
-                    &L1TaskHandle ,
-										Task5_Period);
-	xTaskPeriodicCreate(
-                    Load_2_Simulation,       /* Function that implements the task. */
-                    "Load_2_Simulation",          /* Text name for the task. */
-                     100 ,      /* Stack size in words, not bytes. */
-                    ( void * ) 0,    /* Parameter passed into the task. */
-                    1,/* Priority at which the task is created. */
-                    &L2TaskHandle ,
-										Task6_Period); 
-      /* Used to pass out the created task's handle. */
+    /* Create Tasks here, all the tasks of the Simso model at once */
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+	xTaskPeriodicCreateTable( xAppTasks , appTASK_COUNT , xAppTaskHandles );
+#else
+	/* Or one by one in the static memory above, each stack after the one of
+	   the task before */
+	for( x = 0 , pxStack = xAppTaskStacks ; x < appTASK_COUNT ; pxStack += xAppTasks[ x ].usStackDepth , x++ )
+	{
+		xAppTaskHandles[ x ] = xTaskPeriodicCreateStatic( xAppTasks[ x ].pvTaskCode , xAppTasks[ x ].pcName , xAppTasks[ x ].usStackDepth ,
+		                                                  xAppTasks[ x ].pvParameters , xAppTasks[ x ].uxPriority , pxStack ,
+		                                                  &xAppTaskBuffers[ x ] , xAppTasks[ x ].xPeriod );
+		#if ( configUSE_EDF_SLACK_STEALING == 1 )
+		{
+			vTaskSetWcet( xAppTaskHandles[ x ] , xAppTasks[ x ].xWcet );
+		}
+		#endif
+	}
+#endif
+
+	/* The handle of Uart_Rx, wherever the model puts it in the table */
+	for( x = 0 ; x < appTASK_COUNT ; x++ )
+	{
+		if( xAppTasks[ x ].pvTaskCode == Uart_Rx )
+		{
+			RxTask = xAppTaskHandles[ x ];
+		}
+	}
 
 	/* Now all the tasks have been started - start the scheduler.
 
@@ -433,6 +493,77 @@ int main( void )
 }
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_STACK_PROFILING == 1 )
+
+/* Writes ulValue in decimal at pcBuffer, and returns the end. */
+static char * prvWriteNumber( char * pcBuffer , unsigned long ulValue )
+{
+	char cDigits[ 10 ];
+	int i = 0;
+
+	do
+	{
+		cDigits[ i++ ] = ( char ) ( '0' + ( ulValue % 10UL ) );
+		ulValue /= 10UL;
+	} while( ulValue != 0UL );
+
+	while( i > 0 )
+	{
+		*pcBuffer++ = cDigits[ --i ];
+	}
+
+	return pcBuffer;
+}
+
+/* One line per task, in the order of xAppTasks, for Host_Tools/stack_sizes.py:
+
+	STACK <index> <name> <depth> <used> <recommended depth>
+
+   separated by tabs, in words.  Runs in the idle task, which has a small stack,
+   so the line is built by hand in a static buffer rather than with sprintf().
+   The idle task must not block either, so a line the transmit buffer has no
+   room for is left for its next loop. */
+static void prvReportStacks( void )
+{
+	static UBaseType_t x = 0;
+	static char cLine[ 16 + configMAX_TASK_NAME_LEN + 40 ];
+	TaskStackProfile_t xProfile;
+	const char * pcName;
+	char * pcEnd;
+
+	for( ; x < appTASK_COUNT; x++ )
+	{
+		vTaskGetStackProfile( xAppTaskHandles[ x ] , &xProfile );
+
+		pcEnd = cLine;
+		for( pcName = "STACK\t"; *pcName != '\0'; pcName++ )
+		{
+			*pcEnd++ = *pcName;
+		}
+		pcEnd = prvWriteNumber( pcEnd , ( unsigned long ) x );
+		*pcEnd++ = '\t';
+		for( pcName = pcTaskGetName( xAppTaskHandles[ x ] ); *pcName != '\0'; pcName++ )
+		{
+			*pcEnd++ = *pcName;
+		}
+		*pcEnd++ = '\t';
+		pcEnd = prvWriteNumber( pcEnd , ( unsigned long ) xProfile.usStackDepth );
+		*pcEnd++ = '\t';
+		pcEnd = prvWriteNumber( pcEnd , ( unsigned long ) xProfile.usStackUsed );
+		*pcEnd++ = '\t';
+		pcEnd = prvWriteNumber( pcEnd , ( unsigned long ) xProfile.usRecommendedDepth );
+		*pcEnd++ = '\n';
+
+		if( xSerialTxSend( cLine , ( UBaseType_t ) ( pcEnd - cLine ) , 0 ) != pdPASS )
+		{
+			break;
+		}
+	}
+}
+
+#endif
+/*-----------------------------------------------------------*/
+
 /* Function to reset timer 1 */
 void timer1Reset(void)
 {
@@ -0,0 +1,125 @@
+/*
+ * Buffered transmit of the serial driver, see serial_tx.h.
+ *
+ * xTransmitterIdle is only set by the interrupt, when it finds the ring
+ * empty, and only cleared by a writer, which then starts the transmitter.  A
+ * writer looks at it after the store of uxHead that queues its characters, so
+ * either the interrupt sees the characters, or the writer sees the flag set:
+ * characters cannot be left in the ring with the transmitter stopped.
+ */
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "serial_tx.h"
+
+static SpscRing_t xTxRing;
+static char cTxStorage[ configSERIAL_TX_BUFFER_SIZE ];
+
+static volatile BaseType_t xTransmitterIdle = pdTRUE;
+
+/* pdTRUE while a writer waits for room, outside of the critical section. */
+static volatile BaseType_t xWriterWaiting = pdFALSE;
+/*-----------------------------------------------------------*/
+
+static void prvStartIfIdle( void )
+{
+    if( xTransmitterIdle != pdFALSE )
+    {
+        xTransmitterIdle = pdFALSE;
+        vSerialTxStart();
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vSerialTxInit( void )
+{
+    vSpscRingInit( &xTxRing, cTxStorage, configSERIAL_TX_BUFFER_SIZE, sizeof( char ) );
+    xTransmitterIdle = pdTRUE;
+    xWriterWaiting = pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xSerialTxSend( const char * pcChars,
+                          UBaseType_t uxLength,
+                          TickType_t xTicksToWait )
+{
+    UBaseType_t x = 0U;
+    BaseType_t xReturn = pdPASS;
+    TimeOut_t xTimeOut;
+
+    taskENTER_CRITICAL();
+    {
+        if( ( xWriterWaiting != pdFALSE ) ||
+            ( ( xTicksToWait == ( TickType_t ) 0 ) && ( uxLength > ( configSERIAL_TX_BUFFER_SIZE - uxSpscRingRecordsWaiting( &xTxRing ) ) ) ) )
+        {
+            xReturn = pdFAIL;
+        }
+        else
+        {
+            while( ( x < uxLength ) && ( xSpscRingSend( &xTxRing, &( pcChars[ x ] ), 0 ) == pdPASS ) )
+            {
+                x++;
+            }
+
+            prvStartIfIdle();
+
+            if( x < uxLength )
+            {
+                xWriterWaiting = pdTRUE;
+            }
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    if( ( xReturn == pdPASS ) && ( x < uxLength ) )
+    {
+        /* The other writers are kept out by xWriterWaiting, so the ring
+         * still has a single producer. */
+        vTaskSetTimeOutState( &xTimeOut );
+
+        for( ; x < uxLength; x++ )
+        {
+            if( xSpscRingSend( &xTxRing, &( pcChars[ x ] ), 0 ) != pdPASS )
+            {
+                if( ( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) != pdFALSE ) ||
+                    ( xSpscRingSend( &xTxRing, &( pcChars[ x ] ), xTicksToWait ) != pdPASS ) )
+                {
+                    xReturn = pdFAIL;
+                    break;
+                }
+            }
+
+            prvStartIfIdle();
+        }
+
+        xWriterWaiting = pdFALSE;
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxSerialTxTakeFromISR( char * pcChars,
+                                   UBaseType_t uxMax,
+                                   BaseType_t * const pxHigherPriorityTaskWoken )
+{
+    UBaseType_t uxTaken;
+
+    uxTaken = uxSpscRingReceiveFromISR( &xTxRing, pcChars, uxMax, pxHigherPriorityTaskWoken );
+
+    if( uxTaken == 0U )
+    {
+        xTransmitterIdle = pdTRUE;
+    }
+
+    return uxTaken;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxSerialTxCharsWaiting( void )
+{
+    return uxSpscRingRecordsWaiting( &xTxRing );
+}
+/*-----------------------------------------------------------*/
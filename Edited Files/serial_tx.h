@@ -0,0 +1,82 @@
+/*
+ * Buffered transmit of the serial driver.
+ *
+ * A task that prints does not wait for the UART.  xSerialTxSend(), which
+ * vSerialPutString() calls, copies the characters into a ring buffer of
+ * configSERIAL_TX_BUFFER_SIZE characters, see spsc_ring.h, and returns: its
+ * cost is that of the copy, whatever the baud rate.  The transmit interrupt
+ * of the driver takes them out of the ring a FIFO load at a time, with
+ * uxSerialTxTakeFromISR().
+ *
+ * The ring has a single producer, so the copy is made in a critical section,
+ * which also keeps the characters of a string together when several tasks
+ * print.  Only when the ring is full does a writer wait, for up to the ticks
+ * it was given, outside of the critical section: the interrupt notifies it
+ * each time it frees a FIFO load of room.  A single writer waits at a time,
+ * and while it does the others are refused at once.
+ *
+ * This part does not depend on the hardware.  The driver, serial.c on the
+ * target and sim/sim.c in the simulator, calls vSerialTxInit() when the port
+ * is set up and uxSerialTxTakeFromISR() from its interrupt, and implements
+ * vSerialTxStart(), for the writers to start the transmitter when it has run
+ * out of characters.
+ */
+
+#ifndef SERIAL_TX_H
+#define SERIAL_TX_H
+
+#include "spsc_ring.h"
+
+/* Characters that can wait for the UART, a power of 2.  A job of Uart_Rx
+ * prints 66 of them at most, and the UART sends 230 in its period at
+ * 115200 baud. */
+#ifndef configSERIAL_TX_BUFFER_SIZE
+    #define configSERIAL_TX_BUFFER_SIZE    256
+#endif
+
+/* Ticks vSerialPutString() waits for room in the buffer, at most. */
+#ifndef configSERIAL_TX_BLOCK_TICKS
+    #define configSERIAL_TX_BLOCK_TICKS    portMAX_DELAY
+#endif
+
+/*
+ * Empties the buffer, and marks the transmitter idle.  Called by the driver
+ * before the UART interrupt is enabled.
+ */
+void vSerialTxInit( void );
+
+/*
+ * Queues the uxLength characters at pcChars for the UART, from a task.  With
+ * xTicksToWait 0, the characters are queued all or none.  Otherwise as many
+ * as there is room for are queued at once, and the writer waits up to
+ * xTicksToWait ticks in all for room for the others.  pdPASS if they were all
+ * queued, pdFAIL if some were not, because the time ran out or another writer
+ * was already waiting.
+ */
+BaseType_t xSerialTxSend( const char * pcChars,
+                          UBaseType_t uxLength,
+                          TickType_t xTicksToWait );
+
+/*
+ * Takes up to uxMax characters into pcChars, from the interrupt of the
+ * driver, and returns how many it took.  0 marks the transmitter idle, the
+ * next writer then calls vSerialTxStart().  *pxHigherPriorityTaskWoken is
+ * set as for any FromISR function.
+ */
+UBaseType_t uxSerialTxTakeFromISR( char * pcChars,
+                                   UBaseType_t uxMax,
+                                   BaseType_t * const pxHigherPriorityTaskWoken );
+
+/*
+ * Characters queued that the interrupt has not taken yet.
+ */
+UBaseType_t uxSerialTxCharsWaiting( void );
+
+/*
+ * Implemented by the driver.  Makes the interrupt of the UART run as soon as
+ * possible, to take the characters a writer has just queued.  Called by the
+ * writer, possibly in a critical section.
+ */
+void vSerialTxStart( void );
+
+#endif /* SERIAL_TX_H */
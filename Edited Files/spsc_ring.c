@@ -0,0 +1,275 @@
+/*
+ * Single producer, single consumer ring buffer, see spsc_ring.h.
+ *
+ * uxHead and uxTail count the records sent and received since the ring was
+ * made, and wrap around together: uxHead - uxTail is the number of records in
+ * the ring whatever their values, as the number of records divides the range
+ * of a UBaseType_t.  The slot of a record is its count masked with uxMask.
+ *
+ * Each side reads the index of the other side once, and stores its own once
+ * the record is copied.  The target has a single core that does not reorder
+ * its loads and stores, so the only reordering to prevent is the compiler's,
+ * around those stores.
+ *
+ * A side that blocks first records its handle in the ring, then looks at the
+ * ring again before it waits.  The other side looks for a handle after it has
+ * stored its index, so either the first side sees the new index, or the other
+ * side sees the handle and notifies it: the wakeup cannot be lost.  A
+ * notification that comes after the wait has timed out is left pending, and
+ * only makes the next wait look at the ring once more.
+ */
+#include <string.h>
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "spsc_ring.h"
+
+#if defined( __GNUC__ )
+    #define ringCOMPILER_BARRIER()    __asm volatile ( "" ::: "memory" )
+#elif defined( __CC_ARM )
+    #define ringCOMPILER_BARRIER()    __memory_changed()
+#else
+    #error Define ringCOMPILER_BARRIER() for this compiler
+#endif
+
+#define ringSLOT( pxRing, uxCount )    ( &( ( pxRing )->pucStorage[ ( ( uxCount ) & ( pxRing )->uxMask ) * ( pxRing )->uxRecordSize ] ) )
+#define ringIS_ALIGNED( pv, uxSize )   ( ( ( ( portPOINTER_SIZE_TYPE ) ( pv ) ) & ( ( portPOINTER_SIZE_TYPE ) ( uxSize ) - 1U ) ) == 0U )
+/*-----------------------------------------------------------*/
+
+/* The small records are the common case, and a call to memcpy() would cost
+ * more than copying them. */
+static void prvCopyRecord( void * pvTo,
+                           const void * pvFrom,
+                           UBaseType_t uxRecordSize )
+{
+    switch( uxRecordSize )
+    {
+        case 1U:
+            *( ( uint8_t * ) pvTo ) = *( ( const uint8_t * ) pvFrom );
+            break;
+
+        case 2U:
+            configASSERT( ringIS_ALIGNED( pvTo, 2U ) && ringIS_ALIGNED( pvFrom, 2U ) );
+            *( ( uint16_t * ) pvTo ) = *( ( const uint16_t * ) pvFrom );
+            break;
+
+        case 4U:
+            configASSERT( ringIS_ALIGNED( pvTo, 4U ) && ringIS_ALIGNED( pvFrom, 4U ) );
+            *( ( uint32_t * ) pvTo ) = *( ( const uint32_t * ) pvFrom );
+            break;
+
+        case 8U:
+            configASSERT( ringIS_ALIGNED( pvTo, 4U ) && ringIS_ALIGNED( pvFrom, 4U ) );
+            ( ( uint32_t * ) pvTo )[ 0 ] = ( ( const uint32_t * ) pvFrom )[ 0 ];
+            ( ( uint32_t * ) pvTo )[ 1 ] = ( ( const uint32_t * ) pvFrom )[ 1 ];
+            break;
+
+        default:
+            ( void ) memcpy( pvTo, pvFrom, ( size_t ) uxRecordSize );
+            break;
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vSpscRingInit( SpscRing_t * pxRing,
+                    void * pvStorage,
+                    UBaseType_t uxRecords,
+                    UBaseType_t uxRecordSize )
+{
+    configASSERT( ( uxRecords != 0U ) && ( ( uxRecords & ( uxRecords - 1U ) ) == 0U ) );
+    configASSERT( uxRecordSize != 0U );
+    configASSERT( ( uxRecordSize != 2U ) || ringIS_ALIGNED( pvStorage, 2U ) );
+    configASSERT( ( ( uxRecordSize != 4U ) && ( uxRecordSize != 8U ) ) || ringIS_ALIGNED( pvStorage, 4U ) );
+
+    pxRing->pucStorage = ( uint8_t * ) pvStorage;
+    pxRing->uxRecordSize = uxRecordSize;
+    pxRing->uxMask = uxRecords - 1U;
+    pxRing->uxHead = 0U;
+    pxRing->uxTail = 0U;
+    pxRing->xWaitingReceiver = NULL;
+    pxRing->xWaitingSender = NULL;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xSpscRingSend( SpscRing_t * pxRing,
+                          const void * pvRecord,
+                          TickType_t xTicksToWait )
+{
+    const UBaseType_t uxHead = pxRing->uxHead;
+    TaskHandle_t xReceiver;
+    TimeOut_t xTimeOut;
+    BaseType_t xEntryTimeSet = pdFALSE;
+
+    while( ( uxHead - pxRing->uxTail ) > pxRing->uxMask )
+    {
+        if( xTicksToWait == ( TickType_t ) 0 )
+        {
+            return errQUEUE_FULL;
+        }
+
+        if( xEntryTimeSet == pdFALSE )
+        {
+            vTaskSetTimeOutState( &xTimeOut );
+            xEntryTimeSet = pdTRUE;
+        }
+        else if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) != pdFALSE )
+        {
+            return errQUEUE_FULL;
+        }
+
+        pxRing->xWaitingSender = xTaskGetCurrentTaskHandle();
+        ringCOMPILER_BARRIER();
+
+        if( ( uxHead - pxRing->uxTail ) > pxRing->uxMask )
+        {
+            ( void ) ulTaskNotifyTakeIndexed( configSPSC_RING_NOTIFY_INDEX, pdTRUE, xTicksToWait );
+        }
+
+        pxRing->xWaitingSender = NULL;
+    }
+
+    prvCopyRecord( ringSLOT( pxRing, uxHead ), pvRecord, pxRing->uxRecordSize );
+    ringCOMPILER_BARRIER();
+    pxRing->uxHead = uxHead + 1U;
+    ringCOMPILER_BARRIER();
+
+    /* The consumer clears its handle itself once it runs, so until then each
+     * record notifies it again. */
+    xReceiver = pxRing->xWaitingReceiver;
+
+    if( xReceiver != NULL )
+    {
+        ( void ) xTaskNotifyGiveIndexed( xReceiver, configSPSC_RING_NOTIFY_INDEX );
+    }
+
+    return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xSpscRingSendFromISR( SpscRing_t * pxRing,
+                                 const void * pvRecord,
+                                 BaseType_t * const pxHigherPriorityTaskWoken )
+{
+    const UBaseType_t uxHead = pxRing->uxHead;
+    TaskHandle_t xReceiver;
+
+    if( ( uxHead - pxRing->uxTail ) > pxRing->uxMask )
+    {
+        return errQUEUE_FULL;
+    }
+
+    prvCopyRecord( ringSLOT( pxRing, uxHead ), pvRecord, pxRing->uxRecordSize );
+    ringCOMPILER_BARRIER();
+    pxRing->uxHead = uxHead + 1U;
+    ringCOMPILER_BARRIER();
+
+    xReceiver = pxRing->xWaitingReceiver;
+
+    if( xReceiver != NULL )
+    {
+        vTaskNotifyGiveIndexedFromISR( xReceiver, configSPSC_RING_NOTIFY_INDEX, pxHigherPriorityTaskWoken );
+    }
+
+    return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xSpscRingReceive( SpscRing_t * pxRing,
+                             void * pvRecord,
+                             TickType_t xTicksToWait )
+{
+    const UBaseType_t uxTail = pxRing->uxTail;
+    TaskHandle_t xSender;
+    TimeOut_t xTimeOut;
+    BaseType_t xEntryTimeSet = pdFALSE;
+
+    while( pxRing->uxHead == uxTail )
+    {
+        if( xTicksToWait == ( TickType_t ) 0 )
+        {
+            return errQUEUE_EMPTY;
+        }
+
+        if( xEntryTimeSet == pdFALSE )
+        {
+            vTaskSetTimeOutState( &xTimeOut );
+            xEntryTimeSet = pdTRUE;
+        }
+        else if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) != pdFALSE )
+        {
+            return errQUEUE_EMPTY;
+        }
+
+        pxRing->xWaitingReceiver = xTaskGetCurrentTaskHandle();
+        ringCOMPILER_BARRIER();
+
+        if( pxRing->uxHead == uxTail )
+        {
+            ( void ) ulTaskNotifyTakeIndexed( configSPSC_RING_NOTIFY_INDEX, pdTRUE, xTicksToWait );
+        }
+
+        pxRing->xWaitingReceiver = NULL;
+    }
+
+    /* The record is read once its index is seen, and before its slot is
+     * handed back. */
+    ringCOMPILER_BARRIER();
+    prvCopyRecord( pvRecord, ringSLOT( pxRing, uxTail ), pxRing->uxRecordSize );
+    ringCOMPILER_BARRIER();
+    pxRing->uxTail = uxTail + 1U;
+    ringCOMPILER_BARRIER();
+
+    xSender = pxRing->xWaitingSender;
+
+    if( xSender != NULL )
+    {
+        ( void ) xTaskNotifyGiveIndexed( xSender, configSPSC_RING_NOTIFY_INDEX );
+    }
+
+    return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxSpscRingReceiveFromISR( SpscRing_t * pxRing,
+                                      void * pvRecords,
+                                      UBaseType_t uxRecords,
+                                      BaseType_t * const pxHigherPriorityTaskWoken )
+{
+    const UBaseType_t uxTail = pxRing->uxTail;
+    const UBaseType_t uxWaiting = pxRing->uxHead - uxTail;
+    TaskHandle_t xSender;
+    UBaseType_t x;
+
+    if( uxRecords > uxWaiting )
+    {
+        uxRecords = uxWaiting;
+    }
+
+    if( uxRecords == 0U )
+    {
+        return 0U;
+    }
+
+    ringCOMPILER_BARRIER();
+
+    for( x = 0U; x < uxRecords; x++ )
+    {
+        prvCopyRecord( &( ( ( uint8_t * ) pvRecords )[ x * pxRing->uxRecordSize ] ), ringSLOT( pxRing, uxTail + x ), pxRing->uxRecordSize );
+    }
+
+    ringCOMPILER_BARRIER();
+    pxRing->uxTail = uxTail + uxRecords;
+    ringCOMPILER_BARRIER();
+
+    xSender = pxRing->xWaitingSender;
+
+    if( xSender != NULL )
+    {
+        vTaskNotifyGiveIndexedFromISR( xSender, configSPSC_RING_NOTIFY_INDEX, pxHigherPriorityTaskWoken );
+    }
+
+    return uxRecords;
+}
+/*-----------------------------------------------------------*/
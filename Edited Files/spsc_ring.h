@@ -0,0 +1,113 @@
+/*
+ * Single producer, single consumer ring buffer of fixed size records.
+ *
+ * For a channel with exactly one writer and one reader, a task or an
+ * interrupt on each side, such as a button task feeding Uart_Rx.  Each side
+ * only ever writes its own index, uxHead for the producer and uxTail for the
+ * consumer, and reads the other one, so neither a send nor a receive takes a
+ * lock or a critical section: a record is copied into its slot, then made
+ * visible by the store of the index.  Records of 1, 2, 4 and 8 bytes are
+ * copied with one or two loads and stores, the others with memcpy().
+ *
+ * The storage is an array of uxRecords records given to vSpscRingInit(),
+ * uxRecords a power of 2.  Records of 2 bytes must be aligned on 2, and
+ * records of 4 or 8 bytes on 4, both in the storage and where they are sent
+ * from or received into: declare them with their own type rather than as
+ * bytes.  Records of other sizes need no alignment.
+ *
+ * A side that finds the ring full, or empty, can block for up to xTicksToWait
+ * ticks.  It waits on task notification index configSPSC_RING_NOTIFY_INDEX of
+ * its task, and the other side gives it that notification once it has made
+ * room, or a record.  The wakeup is the one of any task notification: under
+ * EDF the task goes back into the ready list with the deadline of its job, see
+ * prvRestoreJobDeadline() in tasks.c.  With xTicksToWait 0 no kernel function
+ * is called, and only the side that blocked is ever notified.  Index 0 is the
+ * one of xTaskNotify() and xTaskNotifyWait(), so a task that also uses those
+ * needs configTASK_NOTIFICATION_ARRAY_ENTRIES of 2 or more.
+ *
+ * A side that is an interrupt uses the FromISR functions, which never block.
+ * Two tasks, or two interrupts, must not send, or receive, on the same ring.
+ */
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#ifndef configSPSC_RING_NOTIFY_INDEX
+    #define configSPSC_RING_NOTIFY_INDEX    ( configTASK_NOTIFICATION_ARRAY_ENTRIES - 1 )
+#endif
+
+#if ( configUSE_TASK_NOTIFICATIONS != 1 )
+    #error The ring buffer blocks on task notifications, set configUSE_TASK_NOTIFICATIONS to 1
+#endif
+
+#if ( configSPSC_RING_NOTIFY_INDEX >= configTASK_NOTIFICATION_ARRAY_ENTRIES )
+    #error configSPSC_RING_NOTIFY_INDEX must be less than configTASK_NOTIFICATION_ARRAY_ENTRIES
+#endif
+
+typedef struct xSPSC_RING
+{
+    uint8_t * pucStorage;
+    UBaseType_t uxRecordSize;
+    UBaseType_t uxMask;                     /*< Number of records less 1. */
+    volatile UBaseType_t uxHead;            /*< Records sent since vSpscRingInit(), only written by the producer. */
+    volatile UBaseType_t uxTail;            /*< Records received, only written by the consumer. */
+    TaskHandle_t volatile xWaitingReceiver; /*< The consumer while it blocks on an empty ring, else NULL. */
+    TaskHandle_t volatile xWaitingSender;   /*< The producer while it blocks on a full ring, else NULL. */
+} SpscRing_t;
+
+/*
+ * Makes pxRing an empty ring over pvStorage, uxRecords records of
+ * uxRecordSize bytes.  Must be done before either side uses it.
+ */
+void vSpscRingInit( SpscRing_t * pxRing,
+                    void * pvStorage,
+                    UBaseType_t uxRecords,
+                    UBaseType_t uxRecordSize );
+
+/*
+ * Copies the record at pvRecord into the ring.  If the ring is full, waits up
+ * to xTicksToWait for the consumer to take a record.  pdPASS if the record was
+ * sent, errQUEUE_FULL if the ring was still full.
+ */
+BaseType_t xSpscRingSend( SpscRing_t * pxRing,
+                          const void * pvRecord,
+                          TickType_t xTicksToWait );
+
+/*
+ * xSpscRingSend() from an interrupt, without waiting.  Sets
+ * *pxHigherPriorityTaskWoken to pdTRUE if the record woke a task that should
+ * run before the interrupted one, for portYIELD_FROM_ISR().
+ */
+BaseType_t xSpscRingSendFromISR( SpscRing_t * pxRing,
+                                 const void * pvRecord,
+                                 BaseType_t * const pxHigherPriorityTaskWoken );
+
+/*
+ * Takes the oldest record of the ring into pvRecord.  If the ring is empty,
+ * waits up to xTicksToWait for the producer to send one.  pdPASS if a record
+ * was taken, errQUEUE_EMPTY if the ring was still empty.
+ */
+BaseType_t xSpscRingReceive( SpscRing_t * pxRing,
+                             void * pvRecord,
+                             TickType_t xTicksToWait );
+
+/*
+ * Takes up to uxRecords of the oldest records of the ring, from an interrupt,
+ * into the array pvRecords, and gives back their slots with a single store of
+ * uxTail.  Returns the number of records taken, 0 if the ring was empty.  The
+ * producer, if it blocks on the full ring, is notified once for them all, and
+ * *pxHigherPriorityTaskWoken set to pdTRUE if it should run before the
+ * interrupted task, for portYIELD_FROM_ISR().
+ */
+UBaseType_t uxSpscRingReceiveFromISR( SpscRing_t * pxRing,
+                                      void * pvRecords,
+                                      UBaseType_t uxRecords,
+                                      BaseType_t * const pxHigherPriorityTaskWoken );
+
+/*
+ * Records in the ring.  The other side may have moved on since: for the
+ * consumer there may be more, for the producer fewer.
+ */
+#define uxSpscRingRecordsWaiting( pxRing )    ( ( UBaseType_t ) ( ( pxRing )->uxHead - ( pxRing )->uxTail ) )
+
+#endif /* SPSC_RING_H */
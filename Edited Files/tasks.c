@@ -82,11 +82,19 @@
 #define tskDYNAMICALLY_ALLOCATED_STACK_AND_TCB    ( ( uint8_t ) 0 )
 #define tskSTATICALLY_ALLOCATED_STACK_ONLY        ( ( uint8_t ) 1 )
 #define tskSTATICALLY_ALLOCATED_STACK_AND_TCB     ( ( uint8_t ) 2 )
+#define tskTABLE_ALLOCATED_STACK_AND_TCB          ( ( uint8_t ) 3 )
+
+/* The tasks created by xTaskPeriodicCreateTable() live in the block of their
+ * table, which is never freed, so the TCB records how it was allocated
+ * whenever a table can be created, even without static allocation. */
+#define tskTCB_RECORDS_ALLOCATION                                                             \
+    ( ( tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE != 0 ) ||                                   \
+      ( ( configUSE_EDF_SCHEDULER == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) ) )
 
 /* If any of the following are set then task stacks are filled with a known
  * value so the high water mark can be determined.  If none of the following are
  * set then don't fill the stack so there is no unnecessary dependency on memset. */
-#if ( ( configCHECK_FOR_STACK_OVERFLOW > 1 ) || ( configUSE_TRACE_FACILITY == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark2 == 1 ) )
+#if ( ( configCHECK_FOR_STACK_OVERFLOW > 1 ) || ( configUSE_TRACE_FACILITY == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark2 == 1 ) || ( configUSE_STACK_PROFILING == 1 ) )
     #define tskSET_NEW_STACKS_TO_KNOWN_VALUE    1
 #else
     #define tskSET_NEW_STACKS_TO_KNOWN_VALUE    0
@@ -104,6 +112,57 @@
 #if configUSE_EDF_SCHEDULER == 1
 PRIVILEGED_DATA static List_t xReadyTasksListEDF;
 #endif
+
+/* The number of entries the idle task holds in xReadyTasksListEDF.  In the
+ * hybrid mode the idle task is a fixed priority task below the EDF band. */
+#if ( configUSE_EDF_HYBRID == 1 )
+    #define tskEDF_IDLE_ENTRIES    ( ( UBaseType_t ) 0U )
+#else
+    #define tskEDF_IDLE_ENTRIES    ( ( UBaseType_t ) 1U )
+#endif
+
+/* Period of the idle task outside the hybrid mode, where it is a periodic task
+ * that never completes a job. */
+#define tskEDF_IDLE_PERIOD    ( ( TickType_t ) 150U )
+
+#if ( configUSE_EDF_VD == 1 )
+
+/* The EDF-VD deadline scaling factor is held in per mille. */
+    #define tskEDF_VD_SCALE_ONE    ( ( UBaseType_t ) 1000U )
+
+/* LO tasks that were ready, or became ready, while the system is in HI mode.
+ * They are put back in the EDF ready list at the next idle instant. */
+PRIVILEGED_DATA static List_t xDroppedTasksListEDF;
+PRIVILEGED_DATA static volatile UBaseType_t uxCriticalityMode = tskCRITICALITY_LO;
+PRIVILEGED_DATA static UBaseType_t uxVirtualDeadlineScale = tskEDF_VD_SCALE_ONE;
+#endif
+
+#if ( configUSE_EDF_LIMITED_PREEMPTION == 1 )
+
+/* Set when a job with an earlier deadline became ready while the running task
+ * was inside a non-preemptive region. */
+PRIVILEGED_DATA static volatile BaseType_t xPreemptionDeferred = pdFALSE;
+
+/* Set by vTaskPreemptionPoint() so the next context switch can preempt the
+ * calling task. */
+PRIVILEGED_DATA static volatile BaseType_t xPreemptionPointReached = pdFALSE;
+#endif
+
+#if ( configUSE_EDF_SLACK_STEALING == 1 )
+
+/* Ready tasks of the xTaskRunInSlack() class, in FIFO order. */
+PRIVILEGED_DATA static List_t xSlackReadyTasksList;
+
+/* Every periodic task, linked through pxNextPeriodicTCB, for the slack
+ * computation. */
+PRIVILEGED_DATA static struct tskTaskControlBlock * pxPeriodicTasks = NULL;
+
+/* Slack, in ticks, as of the last tick.  Recomputed at the tick after it was
+ * marked stale, and otherwise counted down by one each tick, only while a
+ * slack task is ready. */
+PRIVILEGED_DATA static volatile TickType_t xAvailableSlack = ( TickType_t ) 0U;
+PRIVILEGED_DATA static volatile BaseType_t xSlackStale = pdTRUE;
+#endif
 /*
  * Some kernel aware debuggers require the data the debugger needs access to to
  * be global, rather than file scope.
@@ -118,7 +177,13 @@ PRIVILEGED_DATA static List_t xReadyTasksListEDF;
     #define configIDLE_TASK_NAME    "IDLE"
 #endif
 
-#if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 0 )
+#if ( configUSE_EDF_LEAN == 1 )
+
+/* The lean EDF build has no fixed priority ready lists, every ready task is in
+ * a deadline ordered list. */
+    #define taskRESET_READY_PRIORITY( uxPriority )
+
+#elif ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 0 )
 
 /* If configUSE_PORT_OPTIMISED_TASK_SELECTION is 0 then task selection is
  * performed in a generic way that is not optimised to any particular
@@ -199,6 +264,35 @@ PRIVILEGED_DATA static List_t xReadyTasksListEDF;
 
 /*-----------------------------------------------------------*/
 
+/*
+ * pdTRUE when pxTCB, just readied, is to run before the current task: under
+ * EDF when its job has an earlier deadline, otherwise when it has a higher
+ * priority.  In the hybrid mode two jobs of the EDF band, the periodic tasks,
+ * are compared on their deadlines, and any other pair on their priorities.
+ * The _OR_EQUAL form also holds on a tie.  A yield this asks for still goes
+ * through vTaskSwitchContext(), which keeps the processor for a job in a
+ * non-preemptive region.
+ */
+#if ( ( configUSE_EDF_SCHEDULER == 1 ) && ( configUSE_EDF_HYBRID == 0 ) )
+    #define taskPREEMPTS_CURRENT( pxTCB )             ( listGET_LIST_ITEM_VALUE( &( ( pxTCB )->xStateListItem ) ) < listGET_LIST_ITEM_VALUE( &( pxCurrentTCB->xStateListItem ) ) )
+    #define taskPREEMPTS_CURRENT_OR_EQUAL( pxTCB )    ( listGET_LIST_ITEM_VALUE( &( ( pxTCB )->xStateListItem ) ) <= listGET_LIST_ITEM_VALUE( &( pxCurrentTCB->xStateListItem ) ) )
+#elif ( configUSE_EDF_HYBRID == 1 )
+    #define taskIN_EDF_BAND( pxTCB )                  ( ( pxTCB )->xTaskPeriod != ( TickType_t ) 0U )
+    #define taskPREEMPTS_CURRENT( pxTCB )                                                                                   \
+    ( ( taskIN_EDF_BAND( pxTCB ) && taskIN_EDF_BAND( pxCurrentTCB ) ) ?                                                     \
+      ( listGET_LIST_ITEM_VALUE( &( ( pxTCB )->xStateListItem ) ) < listGET_LIST_ITEM_VALUE( &( pxCurrentTCB->xStateListItem ) ) ) : \
+      ( ( pxTCB )->uxPriority > pxCurrentTCB->uxPriority ) )
+    #define taskPREEMPTS_CURRENT_OR_EQUAL( pxTCB )                                                                           \
+    ( ( taskIN_EDF_BAND( pxTCB ) && taskIN_EDF_BAND( pxCurrentTCB ) ) ?                                                      \
+      ( listGET_LIST_ITEM_VALUE( &( ( pxTCB )->xStateListItem ) ) <= listGET_LIST_ITEM_VALUE( &( pxCurrentTCB->xStateListItem ) ) ) : \
+      ( ( pxTCB )->uxPriority >= pxCurrentTCB->uxPriority ) )
+#else
+    #define taskPREEMPTS_CURRENT( pxTCB )             ( ( pxTCB )->uxPriority > pxCurrentTCB->uxPriority )
+    #define taskPREEMPTS_CURRENT_OR_EQUAL( pxTCB )    ( ( pxTCB )->uxPriority >= pxCurrentTCB->uxPriority )
+#endif
+
+/*-----------------------------------------------------------*/
+
 /* pxDelayedTaskList and pxOverflowDelayedTaskList are switched when the tick
  * count overflows. */
 #define taskSWITCH_DELAYED_LISTS()                                                \
@@ -227,10 +321,74 @@ PRIVILEGED_DATA static List_t xReadyTasksListEDF;
 			taskRECORD_READY_PRIORITY( ( pxTCB )->uxPriority );                                                \
 			listINSERT_END( &( pxReadyTasksLists[ ( pxTCB )->uxPriority ] ), &( ( pxTCB )->xStateListItem ) ); \
 			tracePOST_MOVED_TASK_TO_READY_STATE( pxTCB )
-#else
+#elif ( ( configUSE_EDF_VD == 0 ) && ( configUSE_EDF_SLACK_STEALING == 0 ) && ( configUSE_EDF_HYBRID == 0 ) )
 	#define prvAddTaskToReadyList( pxTCB )      \
 		traceMOVED_TASK_TO_READY_STATE( pxTCB );     \
     vListInsert( &(xReadyTasksListEDF), &( ( pxTCB )->xStateListItem ) )
+#else
+	/* The EDF options that route some tasks away from the EDF ready list. */
+	#define prvAddTaskToReadyList( pxTCB )      \
+		traceMOVED_TASK_TO_READY_STATE( pxTCB );     \
+		prvAddTaskToReadyListEDF( pxTCB )
+#endif
+
+/*
+ * The relative deadline a newly released job of pxTCB is scheduled against.
+ * Under EDF-VD a HI task uses its virtual deadline while the system is in LO
+ * mode.
+ */
+#if ( configUSE_EDF_VD == 1 )
+	#define prvGetRelativeDeadline( pxTCB )    ( ( uxCriticalityMode == tskCRITICALITY_LO ) ? ( pxTCB )->xVirtualDeadline : ( pxTCB )->xTaskPeriod )
+#else
+	#define prvGetRelativeDeadline( pxTCB )    ( ( pxTCB )->xTaskPeriod )
+#endif
+
+/*
+ * A job that blocks on an event (a queue, a queue set, a semaphore, an event
+ * group, a task notification) and is woken by it, or by the timeout of its
+ * wait, has not been released again: it goes on with the deadline it blocked
+ * with.  Nor has a job whose wait xTaskAbortDelay() cuts short.  While it is blocked the value of its state list item is its wake
+ * time, so the deadline is put back from xJobDeadline before it is made ready.
+ */
+#if ( configUSE_EDF_SCHEDULER == 1 )
+	#define prvRestoreJobDeadline( pxTCB )    listSET_LIST_ITEM_VALUE( &( ( pxTCB )->xStateListItem ), ( pxTCB )->xJobDeadline )
+#else
+	#define prvRestoreJobDeadline( pxTCB )
+#endif
+
+/*
+ * The task the EDF dispatcher selects.  With slack stealing a ready slack task
+ * runs ahead of the hard jobs while the slack is positive.
+ */
+#if ( configUSE_EDF_SLACK_STEALING == 1 )
+	#define prvSlackTaskSelectable()    ( ( xAvailableSlack > ( TickType_t ) 0U ) && ( listLIST_IS_EMPTY( &xSlackReadyTasksList ) == pdFALSE ) )
+	#define prvGetEarliestTCBEDF()                                                \
+		( prvSlackTaskSelectable() ?                                               \
+		  ( TCB_t * ) listGET_OWNER_OF_HEAD_ENTRY( &xSlackReadyTasksList ) :     \
+		  ( TCB_t * ) listGET_OWNER_OF_HEAD_ENTRY( &xReadyTasksListEDF ) )
+#else
+	#define prvSlackTaskSelectable()    ( pdFALSE )
+	#define prvGetEarliestTCBEDF()      ( ( TCB_t * ) listGET_OWNER_OF_HEAD_ENTRY( &xReadyTasksListEDF ) )
+#endif
+
+/*
+ * Limited-preemptive EDF: pdTRUE while pxTCB is still ready, has not reached a
+ * preemption point and has run for less than its maximum non-preemptive
+ * length since the last one.
+ */
+#if ( configUSE_EDF_LIMITED_PREEMPTION == 1 )
+	#define prvNonPreemptiveRegionActive( pxTCB )                                                           \
+		( ( ( pxTCB )->xMaxNonPreemptive != ( TickType_t ) 0U ) &&                                          \
+		  ( xPreemptionPointReached == pdFALSE ) &&                                                         \
+		  ( listIS_CONTAINED_WITHIN( &xReadyTasksListEDF, &( ( pxTCB )->xStateListItem ) ) != pdFALSE ) && \
+		  ( ( xTickCount - ( pxTCB )->xNonPreemptiveStart ) < ( pxTCB )->xMaxNonPreemptive ) )
+
+	/* Keep the longest region executed by pxTCB for the analysis. */
+	#define prvRecordNonPreemptiveRegion( pxTCB )                                                          \
+		if( ( xTickCount - ( pxTCB )->xNonPreemptiveStart ) > ( pxTCB )->xLongestNonPreemptive )           \
+		{                                                                                                  \
+			( pxTCB )->xLongestNonPreemptive = xTickCount - ( pxTCB )->xNonPreemptiveStart;                \
+		}
 #endif
 /*-----------------------------------------------------------*/
 
@@ -242,6 +400,32 @@ PRIVILEGED_DATA static List_t xReadyTasksListEDF;
  */
 #define prvGetTCBFromHandle( pxHandle )    ( ( ( pxHandle ) == NULL ) ? pxCurrentTCB : ( pxHandle ) )
 
+/*
+ * pdTRUE while pxTCB is in a ready list.  Lets traceTASK_SWITCHED_OUT() tell a
+ * task that was preempted from one that blocked, completed its job or was
+ * deleted.
+ */
+#if ( ( configUSE_EDF_LEAN == 1 ) && ( configUSE_EDF_SLACK_STEALING == 1 ) )
+    #define taskTRACE_STILL_READY( pxTCB )                                                                 \
+    ( ( listIS_CONTAINED_WITHIN( &xReadyTasksListEDF, &( ( pxTCB )->xStateListItem ) ) != pdFALSE ) ||     \
+      ( listIS_CONTAINED_WITHIN( &xSlackReadyTasksList, &( ( pxTCB )->xStateListItem ) ) != pdFALSE ) )
+#elif ( configUSE_EDF_LEAN == 1 )
+    #define taskTRACE_STILL_READY( pxTCB ) \
+    ( listIS_CONTAINED_WITHIN( &xReadyTasksListEDF, &( ( pxTCB )->xStateListItem ) ) != pdFALSE )
+#elif ( configUSE_EDF_SLACK_STEALING == 1 )
+    #define taskTRACE_STILL_READY( pxTCB )                                                                 \
+    ( ( listIS_CONTAINED_WITHIN( &xReadyTasksListEDF, &( ( pxTCB )->xStateListItem ) ) != pdFALSE ) ||     \
+      ( listIS_CONTAINED_WITHIN( &xSlackReadyTasksList, &( ( pxTCB )->xStateListItem ) ) != pdFALSE ) ||   \
+      ( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ ( pxTCB )->uxPriority ] ), &( ( pxTCB )->xStateListItem ) ) != pdFALSE ) )
+#elif ( configUSE_EDF_SCHEDULER == 1 )
+    #define taskTRACE_STILL_READY( pxTCB )                                                                 \
+    ( ( listIS_CONTAINED_WITHIN( &xReadyTasksListEDF, &( ( pxTCB )->xStateListItem ) ) != pdFALSE ) ||     \
+      ( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ ( pxTCB )->uxPriority ] ), &( ( pxTCB )->xStateListItem ) ) != pdFALSE ) )
+#else
+    #define taskTRACE_STILL_READY( pxTCB ) \
+    ( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ ( pxTCB )->uxPriority ] ), &( ( pxTCB )->xStateListItem ) ) != pdFALSE )
+#endif
+
 /* The item value of the event list item is normally used to hold the priority
  * of the task to which it belongs (coded to allow it to be held in reverse
  * priority order).  However, it is occasionally borrowed for other purposes.  It
@@ -269,9 +453,42 @@ typedef struct tskTaskControlBlock       /* The old naming convention is used to
         xMPU_SETTINGS xMPUSettings; /*< The MPU settings are defined as part of the port layer.  THIS MUST BE THE SECOND MEMBER OF THE TCB STRUCT. */
     #endif
 
-    ListItem_t xStateListItem;                  /*< The list that the state list item of a task is reference from denotes the state of that task (Ready, Blocked, Suspended ). */
-		ListItem_t xEventListItem;                  /*< Used to reference a task from an event list. */
-    UBaseType_t uxPriority;                     /*< The priority of the task.  0 is the lowest priority. */
+    /* The members the tick and the context switch use, with the list item
+     * holding the deadline, are kept together after pxTopOfStack so that
+     * they share as few cache lines as possible.  The colder members follow,
+     * see the tskTCB_HOT() checks below. */
+    ListItem_t xStateListItem; /*< The list that the state list item of a task is reference from denotes the state of that task (Ready, Blocked, Suspended ).  Its value is the absolute deadline of a ready EDF job. */
+
+    #if ( configUSE_EDF_SCHEDULER == 1 )
+        TickType_t xTaskPeriod;  /*< Stores the period in tick of the task. */
+        TickType_t xJobDeadline; /*< Absolute deadline of the current job, kept while the job is blocked on an event. */
+    #endif
+
+    #if ( ( configUSE_EDF_VD == 1 ) || ( configUSE_EDF_SLACK_STEALING == 1 ) )
+        TickType_t xJobExecTime; /*< Ticks consumed by the current job. */
+    #endif
+
+    #if ( configUSE_EDF_LIMITED_PREEMPTION == 1 )
+        TickType_t xMaxNonPreemptive;   /*< Longest non-preemptive region allowed, 0 for a fully preemptive task. */
+        TickType_t xNonPreemptiveStart; /*< Tick at which the current non-preemptive region started. */
+    #endif
+
+    #if ( configUSE_APPLICATION_TASK_TAG == 1 )
+        TaskHookFunction_t pxTaskTag;
+    #endif
+
+    #if ( configUSE_TASK_TRACE_PINS == 1 )
+        UBaseType_t uxTracePin; /*< Pin the trace hooks drive while the task runs, tskNO_TRACE_PIN if none. */
+    #endif
+
+    #if ( configGENERATE_RUN_TIME_STATS == 1 )
+        configRUN_TIME_COUNTER_TYPE ulRunTimeCounter; /*< Stores the amount of time the task has spent in the Running state. */
+    #endif
+
+    ListItem_t xEventListItem;                  /*< Used to reference a task from an event list. */
+    #if ( configUSE_EDF_LEAN == 0 )
+        UBaseType_t uxPriority;                 /*< The priority of the task.  0 is the lowest priority. */
+    #endif
     StackType_t * pxStack;                      /*< Points to the start of the stack. */
     char pcTaskName[ configMAX_TASK_NAME_LEN ]; /*< Descriptive name given to the task when created.  Facilitates debugging only. */ /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
 
@@ -293,16 +510,14 @@ typedef struct tskTaskControlBlock       /* The old naming convention is used to
         UBaseType_t uxMutexesHeld;
     #endif
 
-    #if ( configUSE_APPLICATION_TASK_TAG == 1 )
-        TaskHookFunction_t pxTaskTag;
-    #endif
-
     #if ( configNUM_THREAD_LOCAL_STORAGE_POINTERS > 0 )
         void * pvThreadLocalStoragePointers[ configNUM_THREAD_LOCAL_STORAGE_POINTERS ];
     #endif
 
-    #if ( configGENERATE_RUN_TIME_STATS == 1 )
-        configRUN_TIME_COUNTER_TYPE ulRunTimeCounter; /*< Stores the amount of time the task has spent in the Running state. */
+    #if ( configUSE_TASK_LATENCY_STATS == 1 )
+        TaskLatencyStats_t xLatency;              /*< Response time and start jitter of the jobs, see vTaskGetLatencyStats(). */
+        configRUN_TIME_COUNTER_TYPE ulJobRelease; /*< Run time counter at the nominal release of the current job. */
+        uint8_t ucJobState;                       /*< One of the tskJOB_ values. */
     #endif
 
     #if ( ( configUSE_NEWLIB_REENTRANT == 1 ) || ( configUSE_C_RUNTIME_TLS_SUPPORT == 1 ) )
@@ -315,8 +530,9 @@ typedef struct tskTaskControlBlock       /* The old naming convention is used to
     #endif
 
     /* See the comments in FreeRTOS.h with the definition of
-     * tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE. */
-    #if ( tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE != 0 ) /*lint !e731 !e9029 Macro has been consolidated for readability reasons. */
+     * tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE, and with tskTCB_RECORDS_ALLOCATION
+     * above. */
+    #if ( tskTCB_RECORDS_ALLOCATION != 0 ) /*lint !e731 !e9029 Macro has been consolidated for readability reasons. */
         uint8_t ucStaticallyAllocated;                     /*< Set to pdTRUE if the task is a statically allocated to ensure no attempt is made to free the memory. */
     #endif
 
@@ -327,9 +543,24 @@ typedef struct tskTaskControlBlock       /* The old naming convention is used to
     #if ( configUSE_POSIX_ERRNO == 1 )
         int iTaskErrno;
     #endif
-		
-		#if configUSE_EDF_SCHEDULER == 1 
-			TickType_t xTaskPeriod; /*< Stores the period in tick of the task. > */
+
+		#if ( configUSE_EDF_VD == 1 )
+			UBaseType_t uxCriticality;   /*< tskCRITICALITY_LO or tskCRITICALITY_HI. */
+			TickType_t xWcetLo;          /*< Budget of a job in LO mode, 0 if the task has no budget. */
+			TickType_t xWcetHi;          /*< Budget of a job in HI mode. */
+			TickType_t xVirtualDeadline; /*< Relative deadline used in LO mode. */
+		#endif
+
+		#if ( configUSE_EDF_SLACK_STEALING == 1 )
+			TickType_t xTaskWcet;                            /*< WCET of a job, used to compute the slack. */
+			TickType_t xNextRelease;                         /*< Release time of the next job. */
+			BaseType_t xJobActive;                           /*< pdTRUE from the release of a job until it completes. */
+			BaseType_t xSlackTask;                           /*< pdTRUE for a task created by xTaskRunInSlack(). */
+			struct tskTaskControlBlock * pxNextPeriodicTCB; /*< Next periodic task, NULL at the end. */
+		#endif
+
+		#if ( configUSE_EDF_LIMITED_PREEMPTION == 1 )
+			TickType_t xLongestNonPreemptive; /*< Longest non-preemptive region executed so far. */
 		#endif
 } tskTCB;
 
@@ -337,6 +568,48 @@ typedef struct tskTaskControlBlock       /* The old naming convention is used to
  * below to enable the use of older kernel aware debuggers. */
 typedef tskTCB TCB_t;
 
+/* Fails to compile if a member the tick or the context switch uses is moved
+ * after xEventListItem, the first of the colder members of the TCB. */
+#define tskTCB_HOT( xMember ) \
+    typedef char tskTCB_HOT_##xMember[ ( offsetof( TCB_t, xMember ) < offsetof( TCB_t, xEventListItem ) ) ? 1 : -1 ]
+
+tskTCB_HOT( pxTopOfStack );
+tskTCB_HOT( xStateListItem );
+
+#if ( configUSE_EDF_SCHEDULER == 1 )
+    tskTCB_HOT( xTaskPeriod );
+    tskTCB_HOT( xJobDeadline );
+#endif
+
+#if ( ( configUSE_EDF_VD == 1 ) || ( configUSE_EDF_SLACK_STEALING == 1 ) )
+    tskTCB_HOT( xJobExecTime );
+#endif
+
+#if ( configUSE_EDF_LIMITED_PREEMPTION == 1 )
+    tskTCB_HOT( xMaxNonPreemptive );
+    tskTCB_HOT( xNonPreemptiveStart );
+#endif
+
+#if ( configUSE_APPLICATION_TASK_TAG == 1 )
+    tskTCB_HOT( pxTaskTag );
+#endif
+
+#if ( configUSE_TASK_TRACE_PINS == 1 )
+    tskTCB_HOT( uxTracePin );
+#endif
+
+#if ( configGENERATE_RUN_TIME_STATS == 1 )
+    tskTCB_HOT( ulRunTimeCounter );
+#endif
+
+/* Fails to compile if StaticPeriodicTask_t, the TCB buffer of
+ * xTaskPeriodicCreateStatic(), is smaller than the TCB.  It only has to be
+ * large enough: the padding after its StaticTask_t may not be where the TCB
+ * has it. */
+#if ( configUSE_EDF_SCHEDULER == 1 )
+    typedef char tskSTATIC_PERIODIC_TCB_SIZE[ ( sizeof( StaticPeriodicTask_t ) >= sizeof( TCB_t ) ) ? 1 : -1 ];
+#endif
+
 /*lint -save -e956 A manual analysis and inspection has been used to determine
  * which static variables must be declared volatile. */
 portDONT_DISCARD PRIVILEGED_DATA TCB_t * volatile pxCurrentTCB = NULL;
@@ -347,7 +620,9 @@ portDONT_DISCARD PRIVILEGED_DATA TCB_t * volatile pxCurrentTCB = NULL;
  * the static qualifier. */
 
 
-PRIVILEGED_DATA static List_t pxReadyTasksLists[ configMAX_PRIORITIES ]; /*< Prioritised ready tasks. */
+#if ( configUSE_EDF_LEAN == 0 )
+    PRIVILEGED_DATA static List_t pxReadyTasksLists[ configMAX_PRIORITIES ]; /*< Prioritised ready tasks. */
+#endif
 PRIVILEGED_DATA static List_t xDelayedTaskList1;                         /*< Delayed tasks. */
 PRIVILEGED_DATA static List_t xDelayedTaskList2;                         /*< Delayed tasks (two lists are used - one for delays that have overflowed the current tick count. */
 PRIVILEGED_DATA static List_t * volatile pxDelayedTaskList;              /*< Points to the delayed task list currently being used. */
@@ -376,7 +651,9 @@ PRIVILEGED_DATA static List_t xPendingReadyList;                         /*< Tas
 /* Other file private variables. --------------------------------*/
 PRIVILEGED_DATA static volatile UBaseType_t uxCurrentNumberOfTasks = ( UBaseType_t ) 0U;
 PRIVILEGED_DATA static volatile TickType_t xTickCount = ( TickType_t ) configINITIAL_TICK_COUNT;
-PRIVILEGED_DATA static volatile UBaseType_t uxTopReadyPriority = tskIDLE_PRIORITY;
+#if ( configUSE_EDF_LEAN == 0 )
+    PRIVILEGED_DATA static volatile UBaseType_t uxTopReadyPriority = tskIDLE_PRIORITY;
+#endif
 PRIVILEGED_DATA static volatile BaseType_t xSchedulerRunning = pdFALSE;
 PRIVILEGED_DATA static volatile TickType_t xPendedTicks = ( TickType_t ) 0U;
 PRIVILEGED_DATA static volatile BaseType_t xYieldPending = pdFALSE;
@@ -409,6 +686,36 @@ PRIVILEGED_DATA static volatile UBaseType_t uxSchedulerSuspended = ( UBaseType_t
 
 #endif
 
+#if ( configUSE_CPU_LOAD_MONITOR == 1 )
+
+/* The CPU load estimates are held in per mille with 8 fraction bits, so the
+ * long windows do not lose the small steps of their moving average. */
+    #define tskCPU_LOAD_FRACTION_BITS    ( 8U )
+
+    PRIVILEGED_DATA static TickType_t xCpuLoadTicks = ( TickType_t ) 0U;                       /*< Ticks elapsed in the current window. */
+    PRIVILEGED_DATA static configRUN_TIME_COUNTER_TYPE ulCpuLoadLastTotal = 0UL;                /*< Run time counter at the start of the window. */
+    PRIVILEGED_DATA static configRUN_TIME_COUNTER_TYPE ulCpuLoadLastIdle = 0UL;                 /*< Idle task run time at the start of the window. */
+    PRIVILEGED_DATA static volatile uint32_t ulCpuLoad[ tskCPU_LOAD_LONG + 1U ] = { 0UL, 0UL, 0UL }; /*< Indexed by tskCPU_LOAD_WINDOW, tskCPU_LOAD_MEDIUM and tskCPU_LOAD_LONG. */
+
+#endif
+
+#if ( configUSE_TASK_LATENCY_STATS == 1 )
+
+/* Where the current job of a task is, for the latency statistics.  A task
+ * only gets a known release once it has called xTaskDelayUntil(), so the jobs
+ * of a task that never does are not recorded. */
+    #define tskJOB_UNKNOWN            ( ( uint8_t ) 0U ) /*< The release of the current job is not known. */
+    #define tskJOB_WAITING_RELEASE    ( ( uint8_t ) 1U ) /*< Delayed until the release of its next job. */
+    #define tskJOB_WAITING_START      ( ( uint8_t ) 2U ) /*< Released, not yet switched in. */
+    #define tskJOB_RUNNING            ( ( uint8_t ) 3U ) /*< Switched in at least once since its release. */
+
+    #define tskLATENCY_SUB_BUCKETS    ( ( uint32_t ) 1U << configLATENCY_HISTOGRAM_PRECISION_BITS )
+
+/* Converts ticks to run time counter units. */
+    #define tskTICKS_TO_RUN_TIME( xTicks )    ( ( configRUN_TIME_COUNTER_TYPE ) ( ( ( uint64_t ) ( xTicks ) * ( uint64_t ) configRUN_TIME_COUNTER_HZ ) / ( uint64_t ) configTICK_RATE_HZ ) )
+
+#endif
+
 /*lint -restore */
 
 /*-----------------------------------------------------------*/
@@ -504,7 +811,7 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
  * This function determines the 'high water mark' of the task stack by
  * determining how much of the stack remains at the original preset value.
  */
-#if ( ( configUSE_TRACE_FACILITY == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark2 == 1 ) )
+#if ( ( configUSE_TRACE_FACILITY == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark2 == 1 ) || ( configUSE_STACK_PROFILING == 1 ) )
 
     static configSTACK_DEPTH_TYPE prvTaskCheckFreeStackSpace( const uint8_t * pucStackByte ) PRIVILEGED_FUNCTION;
 
@@ -561,6 +868,129 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
  */
 static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
 
+/*
+ * prvInitialiseNewTask() for a periodic task: also places it in the EDF band
+ * in the hybrid mode, sets its period and, under EDF-VD, makes it a HI task
+ * without a budget.
+ */
+#if ( configUSE_EDF_SCHEDULER == 1 )
+
+    static void prvInitialiseNewPeriodicTask( TaskFunction_t pxTaskCode,
+                                              const char * const pcName, /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+                                              const uint32_t ulStackDepth,
+                                              void * const pvParameters,
+                                              UBaseType_t uxPriority,
+                                              TaskHandle_t * const pxCreatedTask,
+                                              TCB_t * pxNewTCB,
+                                              TickType_t xPeriod ) PRIVILEGED_FUNCTION;
+
+#endif
+
+/*
+ * Releases the first job of a new periodic task, whose period (and criticality
+ * under EDF-VD) have been set: the deadline of the job is the creation tick
+ * plus the relative deadline.
+ */
+#if ( configUSE_EDF_SCHEDULER == 1 )
+
+    static void prvReleaseFirstJob( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
+
+#endif
+
+/*
+ * EDF-VD helpers.  prvComputeVirtualDeadlines() derives the virtual deadline
+ * of every HI task from the utilisation of the task set, the two others move
+ * the system between the LO and HI criticality modes.
+ */
+#if ( configUSE_EDF_VD == 1 )
+
+    static void prvComputeVirtualDeadlines( void ) PRIVILEGED_FUNCTION;
+
+    static void prvGetCriticalityUtilisations( UBaseType_t * puxLoTasksLo,
+                                               UBaseType_t * puxHiTasksLo,
+                                               UBaseType_t * puxHiTasksHi ) PRIVILEGED_FUNCTION;
+
+    static BaseType_t prvEDFVDSchedulable( UBaseType_t uxLoTasksLo,
+                                           UBaseType_t uxHiTasksLo,
+                                           UBaseType_t uxHiTasksHi,
+                                           UBaseType_t * puxScale ) PRIVILEGED_FUNCTION;
+
+    static TickType_t prvGetVirtualDeadline( const TCB_t * const pxTCB ) PRIVILEGED_FUNCTION;
+
+    static void prvSwitchToHiCriticality( void ) PRIVILEGED_FUNCTION;
+
+    static BaseType_t prvSwitchToLoCriticality( void ) PRIVILEGED_FUNCTION;
+
+#endif
+
+/*
+ * Called from the tick at the end of each CPU load window to fold the load
+ * measured over the window into the estimates.
+ */
+#if ( configUSE_CPU_LOAD_MONITOR == 1 )
+
+    static void prvUpdateCpuLoad( void ) PRIVILEGED_FUNCTION;
+
+#endif
+
+/*
+ * Adds ulValue to a latency histogram.  Called from the context switch, so it
+ * is a few shifts and compares: no division and no loop.
+ */
+#if ( configUSE_TASK_LATENCY_STATS == 1 )
+
+    static void prvRecordLatency( TaskLatencyHistogram_t * const pxHistogram,
+                                  uint32_t ulValue ) PRIVILEGED_FUNCTION;
+
+#endif
+
+/*
+ * Places pxTCB in the list it is ready in when an EDF option can route tasks
+ * away from the EDF ready list, or to the fixed priority ready lists.
+ */
+#if ( ( configUSE_EDF_VD == 1 ) || ( configUSE_EDF_SLACK_STEALING == 1 ) || ( configUSE_EDF_HYBRID == 1 ) )
+
+    static void prvAddTaskToReadyListEDF( TCB_t * pxTCB ) PRIVILEGED_FUNCTION;
+
+#endif
+
+/*
+ * Hybrid mode: pdTRUE when a job of the EDF band is ready and no fixed
+ * priority task above the band is.
+ */
+#if ( configUSE_EDF_HYBRID == 1 )
+
+    static BaseType_t prvEDFBandOnTop( void ) PRIVILEGED_FUNCTION;
+
+#endif
+
+/*
+ * Slack stealing: returns the processor time, in ticks, the hard jobs can
+ * give away from xTimeNow without missing a deadline.
+ */
+#if ( configUSE_EDF_SLACK_STEALING == 1 )
+
+    static TickType_t prvComputeSlack( TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
+
+    static TickType_t prvDemandBefore( TickType_t xTimeNow,
+                                       TickType_t xWindow ) PRIVILEGED_FUNCTION;
+
+#endif
+
+/*
+ * Used by xTaskCheckNonPreemptiveSchedulability() to check a single window of
+ * length xL for the task uxTask.
+ */
+#if ( configUSE_EDF_SCHEDULER == 1 )
+
+    static BaseType_t prvNonPreemptiveWindowFits( const TickType_t * pxPeriods,
+                                                  const TickType_t * pxWcets,
+                                                  UBaseType_t uxNumberOfTasks,
+                                                  UBaseType_t uxTask,
+                                                  TickType_t xL ) PRIVILEGED_FUNCTION;
+
+#endif
+
 /*
  * freertos_tasks_c_additions_init() should only be called if the user definable
  * macro FREERTOS_TASKS_C_ADDITIONS_INIT() is defined, as that is the only macro
@@ -609,13 +1039,13 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
             memset( ( void * ) pxNewTCB, 0x00, sizeof( TCB_t ) );
             pxNewTCB->pxStack = ( StackType_t * ) puxStackBuffer;
 
-            #if ( tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE != 0 ) /*lint !e731 !e9029 Macro has been consolidated for readability reasons. */
+            #if ( tskTCB_RECORDS_ALLOCATION != 0 ) /*lint !e731 !e9029 Macro has been consolidated for readability reasons. */
             {
                 /* Tasks can be created statically or dynamically, so note this
                  * task was created statically in case the task is later deleted. */
                 pxNewTCB->ucStaticallyAllocated = tskSTATICALLY_ALLOCATED_STACK_AND_TCB;
             }
-            #endif /* tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE */
+            #endif /* tskTCB_RECORDS_ALLOCATION */
 
             prvInitialiseNewTask( pxTaskCode, pcName, ulStackDepth, pvParameters, uxPriority, &xReturn, pxNewTCB, NULL );
             prvAddNewTaskToReadyList( pxNewTCB );
@@ -653,13 +1083,13 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
             /* Store the stack location in the TCB. */
             pxNewTCB->pxStack = pxTaskDefinition->puxStackBuffer;
 
-            #if ( tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE != 0 )
+            #if ( tskTCB_RECORDS_ALLOCATION != 0 )
             {
                 /* Tasks can be created statically or dynamically, so note this
                  * task was created statically in case the task is later deleted. */
                 pxNewTCB->ucStaticallyAllocated = tskSTATICALLY_ALLOCATED_STACK_AND_TCB;
             }
-            #endif /* tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE */
+            #endif /* tskTCB_RECORDS_ALLOCATION */
 
             prvInitialiseNewTask( pxTaskDefinition->pvTaskCode,
                                   pxTaskDefinition->pcName,
@@ -703,14 +1133,14 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
                 /* Store the stack location in the TCB. */
                 pxNewTCB->pxStack = pxTaskDefinition->puxStackBuffer;
 
-                #if ( tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE != 0 )
+                #if ( tskTCB_RECORDS_ALLOCATION != 0 )
                 {
                     /* Tasks can be created statically or dynamically, so note
                      * this task had a statically allocated stack in case it is
                      * later deleted.  The TCB was allocated dynamically. */
                     pxNewTCB->ucStaticallyAllocated = tskSTATICALLY_ALLOCATED_STACK_ONLY;
                 }
-                #endif /* tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE */
+                #endif /* tskTCB_RECORDS_ALLOCATION */
 
                 prvInitialiseNewTask( pxTaskDefinition->pvTaskCode,
                                       pxTaskDefinition->pcName,
@@ -732,6 +1162,31 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
 /*-----------------------------------------------------------*/
 
 #if (configUSE_EDF_SCHEDULER == 1 && configSUPPORT_DYNAMIC_ALLOCATION == 1) 
+	#if ( configUSE_EDF_VD == 1 )
+	BaseType_t xTaskPeriodicCreate( TaskFunction_t pxTaskCode,
+                            const char * const pcName, /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+                            const configSTACK_DEPTH_TYPE usStackDepth,
+                            void * const pvParameters,
+                            UBaseType_t uxPriority,
+                            TaskHandle_t * const pxCreatedTask ,
+														TickType_t period)
+    {
+        /* A task without a declared budget is a HI task that keeps its real
+         * deadline. */
+        return xTaskPeriodicCreateMC( pxTaskCode, pcName, usStackDepth, pvParameters, uxPriority, pxCreatedTask, period, tskCRITICALITY_HI, ( TickType_t ) 0U, ( TickType_t ) 0U );
+    }
+
+	BaseType_t xTaskPeriodicCreateMC( TaskFunction_t pxTaskCode,
+                            const char * const pcName, /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+                            const configSTACK_DEPTH_TYPE usStackDepth,
+                            void * const pvParameters,
+                            UBaseType_t uxPriority,
+                            TaskHandle_t * const pxCreatedTask ,
+														TickType_t period,
+														UBaseType_t uxCriticality,
+														TickType_t xWcetLo,
+														TickType_t xWcetHi )
+	#else
 	BaseType_t xTaskPeriodicCreate( TaskFunction_t pxTaskCode,
                             const char * const pcName, /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
                             const configSTACK_DEPTH_TYPE usStackDepth,
@@ -739,6 +1194,7 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
                             UBaseType_t uxPriority,
                             TaskHandle_t * const pxCreatedTask ,
 														TickType_t period)
+	#endif
     {
         TCB_t * pxNewTCB;
         BaseType_t xReturn;
@@ -805,17 +1261,25 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
 
         if( pxNewTCB != NULL )
         {
-            #if ( tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE != 0 ) /*lint !e9029 !e731 Macro has been consolidated for readability reasons. */
+            #if ( tskTCB_RECORDS_ALLOCATION != 0 ) /*lint !e9029 !e731 Macro has been consolidated for readability reasons. */
             {
                 /* Tasks can be created statically or dynamically, so note this
                  * task was created dynamically in case it is later deleted. */
                 pxNewTCB->ucStaticallyAllocated = tskDYNAMICALLY_ALLOCATED_STACK_AND_TCB;
             }
-            #endif /* tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE */
-           
-						prvInitialiseNewTask( pxTaskCode, pcName, ( uint32_t ) usStackDepth, pvParameters, uxPriority, pxCreatedTask, pxNewTCB, NULL );
-						pxNewTCB->xTaskPeriod = period;
-						listSET_LIST_ITEM_VALUE(&((pxNewTCB)->xStateListItem) , (pxNewTCB)->xTaskPeriod+ xTaskGetTickCount() );
+            #endif /* tskTCB_RECORDS_ALLOCATION */
+
+						prvInitialiseNewPeriodicTask( pxTaskCode, pcName, ( uint32_t ) usStackDepth, pvParameters, uxPriority, pxCreatedTask, pxNewTCB, period );
+						#if ( configUSE_EDF_VD == 1 )
+						{
+							configASSERT( ( uxCriticality == tskCRITICALITY_LO ) || ( xWcetHi >= xWcetLo ) );
+							pxNewTCB->uxCriticality = uxCriticality;
+							pxNewTCB->xWcetLo = xWcetLo;
+							pxNewTCB->xWcetHi = xWcetHi;
+							pxNewTCB->xVirtualDeadline = prvGetVirtualDeadline( pxNewTCB );
+						}
+						#endif
+						prvReleaseFirstJob( pxNewTCB );
             prvAddNewTaskToReadyList( pxNewTCB );
             xReturn = pdPASS;
         }
@@ -828,87 +1292,281 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
     }
 
 #endif
-#if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+/*-----------------------------------------------------------*/
 
-    BaseType_t xTaskCreate( TaskFunction_t pxTaskCode,
-                            const char * const pcName, /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
-                            const configSTACK_DEPTH_TYPE usStackDepth,
-                            void * const pvParameters,
-                            UBaseType_t uxPriority,
-                            TaskHandle_t * const pxCreatedTask )
+#if ( ( configUSE_EDF_SCHEDULER == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
+
+    /* Size of a TCB or stack of a table, rounded up so that the next one in the
+     * block stays aligned. */
+    #define tskTABLE_ALIGNED_SIZE( xSize )    ( ( ( size_t ) ( xSize ) + ( size_t ) portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK ) )
+
+    BaseType_t xTaskPeriodicCreateTable( const TaskPeriodicParameters_t * const pxTasks,
+                                         UBaseType_t uxNumberOfTasks,
+                                         TaskHandle_t * const pxCreatedTasks )
     {
+        uint8_t * pucBlock;
+        uint8_t * pucTCBs;
+        uint8_t * pucStacks;
         TCB_t * pxNewTCB;
+        TCB_t * pxFirstTCB = NULL;
+        const TaskPeriodicParameters_t * pxTask;
+        size_t xStackSize, xStacksSize = 0;
+        UBaseType_t uxTask;
         BaseType_t xReturn;
 
-        /* If the stack grows down then allocate the stack then the TCB so the stack
-         * does not grow into the TCB.  Likewise if the stack grows up then allocate
-         * the TCB then the stack. */
-        #if ( portSTACK_GROWTH > 0 )
+        for( uxTask = 0; uxTask < uxNumberOfTasks; uxTask++ )
         {
-            /* Allocate space for the TCB.  Where the memory comes from depends on
-             * the implementation of the port malloc function and whether or not static
-             * allocation is being used. */
-            pxNewTCB = ( TCB_t * ) pvPortMalloc( sizeof( TCB_t ) );
-
-            if( pxNewTCB != NULL )
-            {
-                memset( ( void * ) pxNewTCB, 0x00, sizeof( TCB_t ) );
-
-                /* Allocate space for the stack used by the task being created.
-                 * The base of the stack memory stored in the TCB so the task can
-                 * be deleted later if required. */
-                pxNewTCB->pxStack = ( StackType_t * ) pvPortMallocStack( ( ( ( size_t ) usStackDepth ) * sizeof( StackType_t ) ) ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+            configASSERT( pxTasks[ uxTask ].xPeriod > ( TickType_t ) 0U );
+            configASSERT( ( pxTasks[ uxTask ].xDeadline == pxTasks[ uxTask ].xPeriod ) || ( pxTasks[ uxTask ].xDeadline == ( TickType_t ) 0U ) );
 
-                if( pxNewTCB->pxStack == NULL )
-                {
-                    /* Could not allocate the stack.  Delete the allocated TCB. */
-                    vPortFree( pxNewTCB );
-                    pxNewTCB = NULL;
-                }
-            }
+            xStacksSize += tskTABLE_ALIGNED_SIZE( ( ( size_t ) pxTasks[ uxTask ].usStackDepth ) * sizeof( StackType_t ) );
         }
-        #else /* portSTACK_GROWTH */
-        {
-            StackType_t * pxStack;
 
-            /* Allocate space for the stack used by the task being created. */
-            pxStack = pvPortMallocStack( ( ( ( size_t ) usStackDepth ) * sizeof( StackType_t ) ) ); /*lint !e9079 All values returned by pvPortMalloc() have at least the alignment required by the MCU's stack and this allocation is the stack. */
+        /* The TCBs are contiguous, so the scheduler walks the TCBs of the table
+         * without touching the memory of the stacks in between.  The stacks
+         * grow away from the TCBs: below them when the stack grows down, above
+         * them when it grows up.  pvPortMalloc() returns aligned memory, so
+         * every TCB and stack carved from the block is aligned too. */
+        pucBlock = ( uint8_t * ) pvPortMalloc( ( uxNumberOfTasks * tskTABLE_ALIGNED_SIZE( sizeof( TCB_t ) ) ) + xStacksSize );
 
-            if( pxStack != NULL )
+        if( pucBlock != NULL )
+        {
+            #if ( portSTACK_GROWTH > 0 )
             {
-                /* Allocate space for the TCB. */
-                pxNewTCB = ( TCB_t * ) pvPortMalloc( sizeof( TCB_t ) ); /*lint !e9087 !e9079 All values returned by pvPortMalloc() have at least the alignment required by the MCU's stack, and the first member of TCB_t is always a pointer to the task's stack. */
+                pucTCBs = pucBlock;
+                pucStacks = pucBlock + ( uxNumberOfTasks * tskTABLE_ALIGNED_SIZE( sizeof( TCB_t ) ) );
+            }
+            #else
+            {
+                pucStacks = pucBlock;
+                pucTCBs = pucBlock + xStacksSize;
+            }
+            #endif /* portSTACK_GROWTH */
 
-                if( pxNewTCB != NULL )
+            taskENTER_CRITICAL();
+            {
+                if( uxCurrentNumberOfTasks == ( UBaseType_t ) 0U )
                 {
-                    memset( ( void * ) pxNewTCB, 0x00, sizeof( TCB_t ) );
-
-                    /* Store the stack location in the TCB. */
-                    pxNewTCB->pxStack = pxStack;
+                    /* These are the first tasks created. */
+                    prvInitialiseTaskLists();
                 }
                 else
                 {
-                    /* The stack cannot be used as the TCB was not created.  Free
-                     * it again. */
-                    vPortFreeStack( pxStack );
+                    mtCOVERAGE_TEST_MARKER();
                 }
-            }
-            else
-            {
-                pxNewTCB = NULL;
+
+                for( uxTask = 0; uxTask < uxNumberOfTasks; uxTask++ )
+                {
+                    pxTask = &( pxTasks[ uxTask ] );
+                    xStackSize = tskTABLE_ALIGNED_SIZE( ( ( size_t ) pxTask->usStackDepth ) * sizeof( StackType_t ) );
+
+                    pxNewTCB = ( TCB_t * ) pucTCBs; /*lint !e9087 !e9079 The block is aligned and so is each of its TCBs. */
+                    pucTCBs += tskTABLE_ALIGNED_SIZE( sizeof( TCB_t ) );
+
+                    memset( ( void * ) pxNewTCB, 0x00, sizeof( TCB_t ) );
+                    pxNewTCB->pxStack = ( StackType_t * ) pucStacks; /*lint !e9087 !e9079 The block is aligned and so is each of its stacks. */
+                    pucStacks += xStackSize;
+
+                    /* The memory is part of the block of the table, so it is
+                     * not freed if the task is deleted: the TCB and stack stay
+                     * unused until the next table is created. */
+                    pxNewTCB->ucStaticallyAllocated = tskTABLE_ALLOCATED_STACK_AND_TCB;
+
+                    prvInitialiseNewPeriodicTask( pxTask->pvTaskCode, pxTask->pcName, ( uint32_t ) pxTask->usStackDepth, pxTask->pvParameters, pxTask->uxPriority,
+                                                  ( pxCreatedTasks != NULL ) ? &( pxCreatedTasks[ uxTask ] ) : NULL, pxNewTCB, pxTask->xPeriod );
+
+                    #if ( configUSE_EDF_SLACK_STEALING == 1 )
+                    {
+                        pxNewTCB->xTaskWcet = pxTask->xWcet;
+                    }
+                    #endif
+
+                    prvReleaseFirstJob( pxNewTCB );
+
+                    uxCurrentNumberOfTasks++;
+                    uxTaskNumber++;
+
+                    #if ( configUSE_TRACE_FACILITY == 1 )
+                    {
+                        pxNewTCB->uxTCBNumber = uxTaskNumber;
+                    }
+                    #endif /* configUSE_TRACE_FACILITY */
+                    traceTASK_CREATE( pxNewTCB );
+
+                    prvAddTaskToReadyList( pxNewTCB );
+
+                    portSETUP_TCB( pxNewTCB );
+
+                    /* The first job released on creation with the earliest
+                     * deadline, the first task of the table on a tie. */
+                    if( ( pxFirstTCB == NULL ) || ( prvGetRelativeDeadline( pxNewTCB ) < prvGetRelativeDeadline( pxFirstTCB ) ) )
+                    {
+                        pxFirstTCB = pxNewTCB;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+
+                /* As prvAddNewTaskToReadyList() for a single task. */
+                if( ( pxFirstTCB != NULL ) && ( xSchedulerRunning == pdFALSE ) &&
+                    ( ( pxCurrentTCB == NULL ) || ( taskPREEMPTS_CURRENT_OR_EQUAL( pxFirstTCB ) ) ) )
+                {
+                    pxCurrentTCB = pxFirstTCB;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            taskEXIT_CRITICAL();
+
+            if( ( xSchedulerRunning != pdFALSE ) && ( pxFirstTCB != NULL ) && ( taskPREEMPTS_CURRENT( pxFirstTCB ) ) )
+            {
+                taskYIELD_IF_USING_PREEMPTION();
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            xReturn = pdPASS;
+        }
+        else
+        {
+            xReturn = errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY;
+        }
+
+        return xReturn;
+    }
+
+#endif /* ( configUSE_EDF_SCHEDULER == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) */
+/*-----------------------------------------------------------*/
+
+#if ( ( configUSE_EDF_SCHEDULER == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
+
+    TaskHandle_t xTaskPeriodicCreateStatic( TaskFunction_t pxTaskCode,
+                                            const char * const pcName, /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+                                            const uint32_t ulStackDepth,
+                                            void * const pvParameters,
+                                            UBaseType_t uxPriority,
+                                            StackType_t * const puxStackBuffer,
+                                            StaticPeriodicTask_t * const pxTaskBuffer,
+                                            TickType_t period )
+    {
+        TCB_t * pxNewTCB;
+        TaskHandle_t xReturn;
+
+        configASSERT( puxStackBuffer != NULL );
+        configASSERT( pxTaskBuffer != NULL );
+
+        if( ( pxTaskBuffer != NULL ) && ( puxStackBuffer != NULL ) )
+        {
+            pxNewTCB = ( TCB_t * ) pxTaskBuffer; /*lint !e740 !e9087 Unusual cast is ok as the structures are designed to have the same alignment, and the size is checked at compile time. */
+            memset( ( void * ) pxNewTCB, 0x00, sizeof( TCB_t ) );
+            pxNewTCB->pxStack = ( StackType_t * ) puxStackBuffer;
+
+            #if ( tskTCB_RECORDS_ALLOCATION != 0 ) /*lint !e731 !e9029 Macro has been consolidated for readability reasons. */
+            {
+                pxNewTCB->ucStaticallyAllocated = tskSTATICALLY_ALLOCATED_STACK_AND_TCB;
+            }
+            #endif /* tskTCB_RECORDS_ALLOCATION */
+
+            prvInitialiseNewPeriodicTask( pxTaskCode, pcName, ulStackDepth, pvParameters, uxPriority, &xReturn, pxNewTCB, period );
+            prvReleaseFirstJob( pxNewTCB );
+            prvAddNewTaskToReadyList( pxNewTCB );
+        }
+        else
+        {
+            xReturn = NULL;
+        }
+
+        return xReturn;
+    }
+
+#endif /* ( configUSE_EDF_SCHEDULER == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) */
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+    BaseType_t xTaskCreate( TaskFunction_t pxTaskCode,
+                            const char * const pcName, /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+                            const configSTACK_DEPTH_TYPE usStackDepth,
+                            void * const pvParameters,
+                            UBaseType_t uxPriority,
+                            TaskHandle_t * const pxCreatedTask )
+    {
+        TCB_t * pxNewTCB;
+        BaseType_t xReturn;
+
+        /* If the stack grows down then allocate the stack then the TCB so the stack
+         * does not grow into the TCB.  Likewise if the stack grows up then allocate
+         * the TCB then the stack. */
+        #if ( portSTACK_GROWTH > 0 )
+        {
+            /* Allocate space for the TCB.  Where the memory comes from depends on
+             * the implementation of the port malloc function and whether or not static
+             * allocation is being used. */
+            pxNewTCB = ( TCB_t * ) pvPortMalloc( sizeof( TCB_t ) );
+
+            if( pxNewTCB != NULL )
+            {
+                memset( ( void * ) pxNewTCB, 0x00, sizeof( TCB_t ) );
+
+                /* Allocate space for the stack used by the task being created.
+                 * The base of the stack memory stored in the TCB so the task can
+                 * be deleted later if required. */
+                pxNewTCB->pxStack = ( StackType_t * ) pvPortMallocStack( ( ( ( size_t ) usStackDepth ) * sizeof( StackType_t ) ) ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+
+                if( pxNewTCB->pxStack == NULL )
+                {
+                    /* Could not allocate the stack.  Delete the allocated TCB. */
+                    vPortFree( pxNewTCB );
+                    pxNewTCB = NULL;
+                }
+            }
+        }
+        #else /* portSTACK_GROWTH */
+        {
+            StackType_t * pxStack;
+
+            /* Allocate space for the stack used by the task being created. */
+            pxStack = pvPortMallocStack( ( ( ( size_t ) usStackDepth ) * sizeof( StackType_t ) ) ); /*lint !e9079 All values returned by pvPortMalloc() have at least the alignment required by the MCU's stack and this allocation is the stack. */
+
+            if( pxStack != NULL )
+            {
+                /* Allocate space for the TCB. */
+                pxNewTCB = ( TCB_t * ) pvPortMalloc( sizeof( TCB_t ) ); /*lint !e9087 !e9079 All values returned by pvPortMalloc() have at least the alignment required by the MCU's stack, and the first member of TCB_t is always a pointer to the task's stack. */
+
+                if( pxNewTCB != NULL )
+                {
+                    memset( ( void * ) pxNewTCB, 0x00, sizeof( TCB_t ) );
+
+                    /* Store the stack location in the TCB. */
+                    pxNewTCB->pxStack = pxStack;
+                }
+                else
+                {
+                    /* The stack cannot be used as the TCB was not created.  Free
+                     * it again. */
+                    vPortFreeStack( pxStack );
+                }
+            }
+            else
+            {
+                pxNewTCB = NULL;
             }
         }
         #endif /* portSTACK_GROWTH */
 
         if( pxNewTCB != NULL )
         {
-            #if ( tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE != 0 ) /*lint !e9029 !e731 Macro has been consolidated for readability reasons. */
+            #if ( tskTCB_RECORDS_ALLOCATION != 0 ) /*lint !e9029 !e731 Macro has been consolidated for readability reasons. */
             {
                 /* Tasks can be created statically or dynamically, so note this
                  * task was created dynamically in case it is later deleted. */
                 pxNewTCB->ucStaticallyAllocated = tskDYNAMICALLY_ALLOCATED_STACK_AND_TCB;
             }
-            #endif /* tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE */
+            #endif /* tskTCB_RECORDS_ALLOCATION */
 
             prvInitialiseNewTask( pxTaskCode, pcName, ( uint32_t ) usStackDepth, pvParameters, uxPriority, pxCreatedTask, pxNewTCB, NULL );
             prvAddNewTaskToReadyList( pxNewTCB );
@@ -1022,19 +1680,29 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
         mtCOVERAGE_TEST_MARKER();
     }
 
-    /* This is used as an array index so must ensure it's not too large. */
-    configASSERT( uxPriority < configMAX_PRIORITIES );
-
-    if( uxPriority >= ( UBaseType_t ) configMAX_PRIORITIES )
+    #if ( configUSE_EDF_LEAN == 0 )
     {
-        uxPriority = ( UBaseType_t ) configMAX_PRIORITIES - ( UBaseType_t ) 1U;
+        /* This is used as an array index so must ensure it's not too large. */
+        configASSERT( uxPriority < configMAX_PRIORITIES );
+
+        if( uxPriority >= ( UBaseType_t ) configMAX_PRIORITIES )
+        {
+            uxPriority = ( UBaseType_t ) configMAX_PRIORITIES - ( UBaseType_t ) 1U;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        pxNewTCB->uxPriority = uxPriority;
     }
-    else
+    #else
     {
-        mtCOVERAGE_TEST_MARKER();
+        /* Only the privilege bit of the priority is used. */
+        ( void ) uxPriority;
     }
+    #endif /* configUSE_EDF_LEAN */
 
-    pxNewTCB->uxPriority = uxPriority;
     #if ( configUSE_MUTEXES == 1 )
     {
         pxNewTCB->uxBasePriority = uxPriority;
@@ -1048,10 +1716,22 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
      * back to  the containing TCB from a generic item in a list. */
     listSET_LIST_ITEM_OWNER( &( pxNewTCB->xStateListItem ), pxNewTCB );
 
-    /* Event lists are always in priority order. */
-    listSET_LIST_ITEM_VALUE( &( pxNewTCB->xEventListItem ), ( TickType_t ) configMAX_PRIORITIES - ( TickType_t ) uxPriority ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+    /* Event lists are always in priority order.  In the lean EDF build they
+     * are in deadline order, and the value is set when the task is placed in
+     * one. */
+    #if ( configUSE_EDF_LEAN == 0 )
+    {
+        listSET_LIST_ITEM_VALUE( &( pxNewTCB->xEventListItem ), ( TickType_t ) configMAX_PRIORITIES - ( TickType_t ) uxPriority ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+    }
+    #endif
     listSET_LIST_ITEM_OWNER( &( pxNewTCB->xEventListItem ), pxNewTCB );
 
+    #if ( configUSE_TASK_TRACE_PINS == 1 )
+    {
+        pxNewTCB->uxTracePin = tskNO_TRACE_PIN;
+    }
+    #endif
+
     #if ( portUSING_MPU_WRAPPERS == 1 )
     {
         vPortStoreTaskMPUSettings( &( pxNewTCB->xMPUSettings ), xRegions, pxNewTCB->pxStack, ulStackDepth );
@@ -1168,7 +1848,7 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB )
              * so far. */
             if( xSchedulerRunning == pdFALSE )
             {
-                if( pxCurrentTCB->uxPriority <= pxNewTCB->uxPriority )
+                if( taskPREEMPTS_CURRENT_OR_EQUAL( pxNewTCB ) )
                 {
                     pxCurrentTCB = pxNewTCB;
                 }
@@ -1203,7 +1883,7 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB )
     {
         /* If the created task is of a higher priority than the current task
          * then it should run now. */
-        if( pxCurrentTCB->uxPriority < pxNewTCB->uxPriority )
+        if( taskPREEMPTS_CURRENT( pxNewTCB ) )
         {
             taskYIELD_IF_USING_PREEMPTION();
         }
@@ -1219,6 +1899,63 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB )
 }
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_EDF_SCHEDULER == 1 )
+
+    static void prvInitialiseNewPeriodicTask( TaskFunction_t pxTaskCode,
+                                              const char * const pcName, /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+                                              const uint32_t ulStackDepth,
+                                              void * const pvParameters,
+                                              UBaseType_t uxPriority,
+                                              TaskHandle_t * const pxCreatedTask,
+                                              TCB_t * pxNewTCB,
+                                              TickType_t xPeriod )
+    {
+        /* Hybrid mode: every periodic task runs in the EDF band, whatever
+         * priority it was given. */
+        #if ( configUSE_EDF_HYBRID == 1 )
+        {
+            configASSERT( xPeriod > ( TickType_t ) 0U );
+            uxPriority = ( uxPriority & portPRIVILEGE_BIT ) | ( UBaseType_t ) configEDF_BAND_PRIORITY;
+        }
+        #endif
+
+        prvInitialiseNewTask( pxTaskCode, pcName, ulStackDepth, pvParameters, uxPriority, pxCreatedTask, pxNewTCB, NULL );
+        pxNewTCB->xTaskPeriod = xPeriod;
+
+        #if ( configUSE_EDF_VD == 1 )
+        {
+            pxNewTCB->uxCriticality = tskCRITICALITY_HI;
+            pxNewTCB->xVirtualDeadline = prvGetVirtualDeadline( pxNewTCB );
+        }
+        #endif
+    }
+    /*-----------------------------------------------------------*/
+
+    static void prvReleaseFirstJob( TCB_t * pxNewTCB )
+    {
+        listSET_LIST_ITEM_VALUE( &( pxNewTCB->xStateListItem ), prvGetRelativeDeadline( pxNewTCB ) + xTaskGetTickCount() );
+        pxNewTCB->xJobDeadline = listGET_LIST_ITEM_VALUE( &( pxNewTCB->xStateListItem ) );
+
+        #if ( configUSE_EDF_SLACK_STEALING == 1 )
+        {
+            /* The first job is released on creation. */
+            pxNewTCB->xJobActive = pdTRUE;
+            pxNewTCB->xNextRelease = xTaskGetTickCount() + pxNewTCB->xTaskPeriod;
+
+            taskENTER_CRITICAL();
+            {
+                pxNewTCB->pxNextPeriodicTCB = pxPeriodicTasks;
+                pxPeriodicTasks = pxNewTCB;
+                xSlackStale = pdTRUE;
+            }
+            taskEXIT_CRITICAL();
+        }
+        #endif
+    }
+
+#endif /* configUSE_EDF_SCHEDULER */
+/*-----------------------------------------------------------*/
+
 #if ( INCLUDE_vTaskDelete == 1 )
 
     void vTaskDelete( TaskHandle_t xTaskToDelete )
@@ -1251,6 +1988,27 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB )
                 mtCOVERAGE_TEST_MARKER();
             }
 
+            /* A deleted periodic task no longer takes part in the slack
+             * computation. */
+            #if ( configUSE_EDF_SLACK_STEALING == 1 )
+            {
+                TCB_t ** ppxLink = &pxPeriodicTasks;
+
+                while( *ppxLink != NULL )
+                {
+                    if( *ppxLink == pxTCB )
+                    {
+                        *ppxLink = pxTCB->pxNextPeriodicTCB;
+                        break;
+                    }
+
+                    ppxLink = &( ( *ppxLink )->pxNextPeriodicTCB );
+                }
+
+                xSlackStale = pdTRUE;
+            }
+            #endif
+
             /* Increment the uxTaskNumber also so kernel aware debuggers can
              * detect that the task lists need re-generating.  This is done before
              * portPRE_TASK_DELETE_HOOK() as in the Windows port that macro will
@@ -1376,6 +2134,63 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB )
             /* Update the wake time ready for the next call. */
             *pxPreviousWakeTime = xTimeToWake;
 
+            /* The job is complete, the next one starts with a full budget. */
+            #if ( ( configUSE_EDF_VD == 1 ) || ( configUSE_EDF_SLACK_STEALING == 1 ) )
+            {
+                pxCurrentTCB->xJobExecTime = ( TickType_t ) 0U;
+            }
+            #endif
+
+            #if ( configUSE_EDF_SLACK_STEALING == 1 )
+            {
+                pxCurrentTCB->xJobActive = pdFALSE;
+                pxCurrentTCB->xNextRelease = xTimeToWake;
+                xSlackStale = pdTRUE;
+            }
+            #endif
+
+            #if ( configUSE_TASK_LATENCY_STATS == 1 )
+            {
+                const configRUN_TIME_COUNTER_TYPE ulNow = portGET_RUN_TIME_COUNTER_VALUE();
+                TaskLatencyStats_t * const pxLatency = &( pxCurrentTCB->xLatency );
+                uint32_t ulResponseTime;
+
+                pxLatency->ulDeadline = ( uint32_t ) tskTICKS_TO_RUN_TIME( xTimeIncrement );
+
+                if( pxCurrentTCB->ucJobState == tskJOB_RUNNING )
+                {
+                    ulResponseTime = ( uint32_t ) ( ulNow - pxCurrentTCB->ulJobRelease );
+                    prvRecordLatency( &( pxLatency->xResponseTime ), ulResponseTime );
+
+                    if( ulResponseTime > pxLatency->ulDeadline )
+                    {
+                        ( pxLatency->ulLateJobs )++;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                if( xShouldDelay != pdFALSE )
+                {
+                    pxCurrentTCB->ucJobState = tskJOB_WAITING_RELEASE;
+                }
+                else
+                {
+                    /* The next job was released at xTimeToWake, which has
+                     * already passed, and starts now. */
+                    pxCurrentTCB->ulJobRelease = ulNow - tskTICKS_TO_RUN_TIME( xConstTickCount - xTimeToWake );
+                    prvRecordLatency( &( pxLatency->xStartJitter ), ( uint32_t ) ( ulNow - pxCurrentTCB->ulJobRelease ) );
+                    pxCurrentTCB->ucJobState = tskJOB_RUNNING;
+                }
+            }
+            #endif
+
             if( xShouldDelay != pdFALSE )
             {
                 traceTASK_DELAY_UNTIL( xTimeToWake );
@@ -1552,7 +2367,7 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB )
 #endif /* INCLUDE_eTaskGetState */
 /*-----------------------------------------------------------*/
 
-#if ( INCLUDE_uxTaskPriorityGet == 1 )
+#if ( ( INCLUDE_uxTaskPriorityGet == 1 ) && ( configUSE_EDF_LEAN == 0 ) )
 
     UBaseType_t uxTaskPriorityGet( const TaskHandle_t xTask )
     {
@@ -1574,7 +2389,7 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB )
 #endif /* INCLUDE_uxTaskPriorityGet */
 /*-----------------------------------------------------------*/
 
-#if ( INCLUDE_uxTaskPriorityGet == 1 )
+#if ( ( INCLUDE_uxTaskPriorityGet == 1 ) && ( configUSE_EDF_LEAN == 0 ) )
 
     UBaseType_t uxTaskPriorityGetFromISR( const TaskHandle_t xTask )
     {
@@ -1614,7 +2429,7 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB )
 #endif /* INCLUDE_uxTaskPriorityGet */
 /*-----------------------------------------------------------*/
 
-#if ( INCLUDE_vTaskPrioritySet == 1 )
+#if ( ( INCLUDE_vTaskPrioritySet == 1 ) && ( configUSE_EDF_LEAN == 0 ) )
 
     void vTaskPrioritySet( TaskHandle_t xTask,
                            UBaseType_t uxNewPriority )
@@ -1957,7 +2772,7 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB )
                     prvAddTaskToReadyList( pxTCB );
 
                     /* A higher priority task may have just been resumed. */
-                    if( pxTCB->uxPriority >= pxCurrentTCB->uxPriority )
+                    if( taskPREEMPTS_CURRENT_OR_EQUAL( pxTCB ) )
                     {
                         /* This yield may not cause the task just resumed to run,
                          * but will leave the lists in the correct state for the
@@ -2025,7 +2840,7 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB )
                 {
                     /* Ready lists can be accessed so move the task from the
                      * suspended list to the ready list directly. */
-                    if( pxTCB->uxPriority >= pxCurrentTCB->uxPriority )
+                    if( taskPREEMPTS_CURRENT_OR_EQUAL( pxTCB ) )
                     {
                         xYieldRequired = pdTRUE;
 
@@ -2070,40 +2885,89 @@ void vTaskStartScheduler( void )
     /* Add the idle task at the lowest priority. */
     #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
     {
-        StaticTask_t * pxIdleTaskTCBBuffer = NULL;
         StackType_t * pxIdleTaskStackBuffer = NULL;
         uint32_t ulIdleTaskStackSize;
 
-        /* The Idle task is created using user provided RAM - obtain the
-         * address of the RAM then create the idle task. */
-        vApplicationGetIdleTaskMemory( &pxIdleTaskTCBBuffer, &pxIdleTaskStackBuffer, &ulIdleTaskStackSize );
-        xIdleTaskHandle = xTaskCreateStatic( prvIdleTask,
-                                             configIDLE_TASK_NAME,
-                                             ulIdleTaskStackSize,
-                                             ( void * ) NULL,       /*lint !e961.  The cast is not redundant for all compilers. */
-                                             portPRIVILEGE_BIT,     /* In effect ( tskIDLE_PRIORITY | portPRIVILEGE_BIT ), but tskIDLE_PRIORITY is zero. */
-                                             pxIdleTaskStackBuffer,
-                                             pxIdleTaskTCBBuffer ); /*lint !e961 MISRA exception, justified as it is not a redundant explicit cast to all supported compilers. */
-
-        if( xIdleTaskHandle != NULL )
+        #if ( ( configUSE_EDF_SCHEDULER == 1 ) && ( configUSE_EDF_HYBRID == 0 ) )
         {
-            xReturn = pdPASS;
+            StaticPeriodicTask_t * pxIdleTaskTCBBuffer = NULL;
+
+            /* The periodic idle task of EDF, as in the dynamic case below,
+             * in user provided RAM. */
+            vApplicationGetIdlePeriodicTaskMemory( &pxIdleTaskTCBBuffer, &pxIdleTaskStackBuffer, &ulIdleTaskStackSize );
+            xIdleTaskHandle = xTaskPeriodicCreateStatic( prvIdleTask,
+                                                         configIDLE_TASK_NAME,
+                                                         ulIdleTaskStackSize,
+                                                         ( void * ) NULL,
+                                                         portPRIVILEGE_BIT,
+                                                         pxIdleTaskStackBuffer,
+                                                         pxIdleTaskTCBBuffer,
+                                                         tskEDF_IDLE_PERIOD );
         }
-        else
+        #elif ( configUSE_EDF_SCHEDULER == 1 )
         {
-            xReturn = pdFAIL;
+            StaticPeriodicTask_t * pxIdleTaskTCBBuffer = NULL;
+            TCB_t * pxNewTCB;
+
+            /* In the hybrid mode the idle task is an ordinary task, but its
+             * TCB has the EDF members all the same, which a StaticTask_t has
+             * no room for: it is created as by xTaskCreateStatic(), in the
+             * memory of a periodic task. */
+            vApplicationGetIdlePeriodicTaskMemory( &pxIdleTaskTCBBuffer, &pxIdleTaskStackBuffer, &ulIdleTaskStackSize );
+            configASSERT( pxIdleTaskTCBBuffer != NULL );
+            configASSERT( pxIdleTaskStackBuffer != NULL );
+
+            if( ( pxIdleTaskTCBBuffer != NULL ) && ( pxIdleTaskStackBuffer != NULL ) )
+            {
+                pxNewTCB = ( TCB_t * ) pxIdleTaskTCBBuffer; /*lint !e740 !e9087 As in xTaskPeriodicCreateStatic(). */
+                memset( ( void * ) pxNewTCB, 0x00, sizeof( TCB_t ) );
+                pxNewTCB->pxStack = pxIdleTaskStackBuffer;
+
+                #if ( tskTCB_RECORDS_ALLOCATION != 0 ) /*lint !e731 !e9029 Macro has been consolidated for readability reasons. */
+                {
+                    pxNewTCB->ucStaticallyAllocated = tskSTATICALLY_ALLOCATED_STACK_AND_TCB;
+                }
+                #endif /* tskTCB_RECORDS_ALLOCATION */
+
+                prvInitialiseNewTask( prvIdleTask, configIDLE_TASK_NAME, ulIdleTaskStackSize, ( void * ) NULL, portPRIVILEGE_BIT, &xIdleTaskHandle, pxNewTCB, NULL );
+                prvAddNewTaskToReadyList( pxNewTCB );
+            }
+        }
+        #else
+        {
+            StaticTask_t * pxIdleTaskTCBBuffer = NULL;
+
+            /* The Idle task is created using user provided RAM - obtain the
+             * address of the RAM then create the idle task. */
+            vApplicationGetIdleTaskMemory( &pxIdleTaskTCBBuffer, &pxIdleTaskStackBuffer, &ulIdleTaskStackSize );
+            xIdleTaskHandle = xTaskCreateStatic( prvIdleTask,
+                                                 configIDLE_TASK_NAME,
+                                                 ulIdleTaskStackSize,
+                                                 ( void * ) NULL,       /*lint !e961.  The cast is not redundant for all compilers. */
+                                                 portPRIVILEGE_BIT,     /* In effect ( tskIDLE_PRIORITY | portPRIVILEGE_BIT ), but tskIDLE_PRIORITY is zero. */
+                                                 pxIdleTaskStackBuffer,
+                                                 pxIdleTaskTCBBuffer ); /*lint !e961 MISRA exception, justified as it is not a redundant explicit cast to all supported compilers. */
+        }
+        #endif /* configUSE_EDF_SCHEDULER */
+
+        if( xIdleTaskHandle != NULL )
+        {
+            xReturn = pdPASS;
+        }
+        else
+        {
+            xReturn = pdFAIL;
         }
     }
     #else /* if ( configSUPPORT_STATIC_ALLOCATION == 1 ) */
     {
        
-		#if configUSE_EDF_SCHEDULER == 1
+		#if ( ( configUSE_EDF_SCHEDULER == 1 ) && ( configUSE_EDF_HYBRID == 0 ) )
 			{
-             TickType_t initIDLEPeriod = 150;
              xReturn =xTaskPeriodicCreate( prvIdleTask, "IDLE",
                             							configMINIMAL_STACK_SIZE,(void * ) NULL, 
 																					portPRIVILEGE_BIT ,
-																					&xIdleTaskHandle , initIDLEPeriod );
+																					&xIdleTaskHandle , tskEDF_IDLE_PERIOD );
       }
 		
 		#else
@@ -2136,6 +3000,14 @@ void vTaskStartScheduler( void )
 
     if( xReturn == pdPASS )
     {
+        /* All the tasks of the initial task set exist now, so the EDF-VD
+         * virtual deadlines can be computed from its utilisation. */
+        #if ( configUSE_EDF_VD == 1 )
+        {
+            prvComputeVirtualDeadlines();
+        }
+        #endif
+
         /* freertos_tasks_c_additions_init() should only be called if the user
          * definable macro FREERTOS_TASKS_C_ADDITIONS_INIT() is defined, as that is
          * the only macro called by the function. */
@@ -2172,6 +3044,13 @@ void vTaskStartScheduler( void )
          * FreeRTOSConfig.h file. */
         portCONFIGURE_TIMER_FOR_RUN_TIME_STATS();
 
+        /* The first CPU load window starts with the scheduler. */
+        #if ( configUSE_CPU_LOAD_MONITOR == 1 )
+        {
+            ulCpuLoadLastTotal = portGET_RUN_TIME_COUNTER_VALUE();
+        }
+        #endif
+
         traceTASK_SWITCHED_IN();
 
         /* Setting up the timer tick is hardware specific and thus in the
@@ -2235,7 +3114,7 @@ void vTaskSuspendAll( void )
 }
 /*----------------------------------------------------------*/
 
-#if ( configUSE_TICKLESS_IDLE != 0 )
+#if ( ( configUSE_TICKLESS_IDLE != 0 ) && ( configUSE_EDF_LEAN == 0 ) )
 
     static TickType_t prvGetExpectedIdleTime( void )
     {
@@ -2295,7 +3174,32 @@ void vTaskSuspendAll( void )
         return xReturn;
     }
 
-#endif /* configUSE_TICKLESS_IDLE */
+#endif /* ( configUSE_TICKLESS_IDLE != 0 ) && ( configUSE_EDF_LEAN == 0 ) */
+/*----------------------------------------------------------*/
+
+#if ( ( configUSE_TICKLESS_IDLE != 0 ) && ( configUSE_EDF_LEAN == 1 ) )
+
+    static TickType_t prvGetExpectedIdleTime( void )
+    {
+        TickType_t xReturn;
+
+        /* The idle task can only sleep when it is the only ready task, in
+         * the lean EDF build every ready task is in the EDF ready list. */
+        if( ( pxCurrentTCB != xIdleTaskHandle ) ||
+            ( listCURRENT_LIST_LENGTH( &xReadyTasksListEDF ) > tskEDF_IDLE_ENTRIES ) ||
+            ( prvSlackTaskSelectable() != pdFALSE ) )
+        {
+            xReturn = 0;
+        }
+        else
+        {
+            xReturn = xNextTaskUnblockTime - xTickCount;
+        }
+
+        return xReturn;
+    }
+
+#endif /* ( configUSE_TICKLESS_IDLE != 0 ) && ( configUSE_EDF_LEAN == 1 ) */
 /*----------------------------------------------------------*/
 
 BaseType_t xTaskResumeAll( void )
@@ -2328,11 +3232,12 @@ BaseType_t xTaskResumeAll( void )
                     listREMOVE_ITEM( &( pxTCB->xEventListItem ) );
                     portMEMORY_BARRIER();
                     listREMOVE_ITEM( &( pxTCB->xStateListItem ) );
+                    prvRestoreJobDeadline( pxTCB );
                     prvAddTaskToReadyList( pxTCB );
 
                     /* If the moved task has a priority higher than or equal to
                      * the current task then a yield must be performed. */
-                    if( pxTCB->uxPriority >= pxCurrentTCB->uxPriority )
+                    if( taskPREEMPTS_CURRENT_OR_EQUAL( pxTCB ) )
                     {
                         xYieldPending = pdTRUE;
                     }
@@ -2560,17 +3465,53 @@ char * pcTaskGetName( TaskHandle_t xTaskToQuery ) /*lint !e971 Unqualified char
         vTaskSuspendAll();
         {
             /* Search the ready lists. */
-            do
+            #if ( configUSE_EDF_LEAN == 0 )
             {
-                uxQueue--;
-                pxTCB = prvSearchForNameWithinSingleList( ( List_t * ) &( pxReadyTasksLists[ uxQueue ] ), pcNameToQuery );
+                do
+                {
+                    uxQueue--;
+                    pxTCB = prvSearchForNameWithinSingleList( ( List_t * ) &( pxReadyTasksLists[ uxQueue ] ), pcNameToQuery );
 
-                if( pxTCB != NULL )
+                    if( pxTCB != NULL )
+                    {
+                        /* Found the handle. */
+                        break;
+                    }
+                } while( uxQueue > ( UBaseType_t ) tskIDLE_PRIORITY ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+            }
+            #else
+            {
+                ( void ) uxQueue;
+                pxTCB = NULL;
+            }
+            #endif /* configUSE_EDF_LEAN */
+
+            #if ( configUSE_EDF_SCHEDULER == 1 )
+            {
+                if( pxTCB == NULL )
                 {
-                    /* Found the handle. */
-                    break;
+                    pxTCB = prvSearchForNameWithinSingleList( &xReadyTasksListEDF, pcNameToQuery );
+                }
+
+                #if ( configUSE_EDF_VD == 1 )
+                {
+                    if( pxTCB == NULL )
+                    {
+                        pxTCB = prvSearchForNameWithinSingleList( &xDroppedTasksListEDF, pcNameToQuery );
+                    }
                 }
-            } while( uxQueue > ( UBaseType_t ) tskIDLE_PRIORITY ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+                #endif
+
+                #if ( configUSE_EDF_SLACK_STEALING == 1 )
+                {
+                    if( pxTCB == NULL )
+                    {
+                        pxTCB = prvSearchForNameWithinSingleList( &xSlackReadyTasksList, pcNameToQuery );
+                    }
+                }
+                #endif
+            }
+            #endif /* configUSE_EDF_SCHEDULER */
 
             /* Search the delayed lists. */
             if( pxTCB == NULL )
@@ -2626,11 +3567,37 @@ char * pcTaskGetName( TaskHandle_t xTaskToQuery ) /*lint !e971 Unqualified char
             {
                 /* Fill in an TaskStatus_t structure with information on each
                  * task in the Ready state. */
-                do
+                #if ( configUSE_EDF_LEAN == 0 )
                 {
-                    uxQueue--;
-                    uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), &( pxReadyTasksLists[ uxQueue ] ), eReady );
-                } while( uxQueue > ( UBaseType_t ) tskIDLE_PRIORITY ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+                    do
+                    {
+                        uxQueue--;
+                        uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), &( pxReadyTasksLists[ uxQueue ] ), eReady );
+                    } while( uxQueue > ( UBaseType_t ) tskIDLE_PRIORITY ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+                }
+                #else
+                {
+                    ( void ) uxQueue;
+                }
+                #endif /* configUSE_EDF_LEAN */
+
+                #if ( configUSE_EDF_SCHEDULER == 1 )
+                {
+                    uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), &xReadyTasksListEDF, eReady );
+
+                    #if ( configUSE_EDF_VD == 1 )
+                    {
+                        uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), &xDroppedTasksListEDF, eReady );
+                    }
+                    #endif
+
+                    #if ( configUSE_EDF_SLACK_STEALING == 1 )
+                    {
+                        uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), &xSlackReadyTasksList, eReady );
+                    }
+                    #endif
+                }
+                #endif /* configUSE_EDF_SCHEDULER */
 
                 /* Fill in an TaskStatus_t structure with information on each
                  * task in the Blocked state. */
@@ -2764,6 +3731,64 @@ BaseType_t xTaskCatchUpTicks( TickType_t xTicksToCatchUp )
 }
 /*----------------------------------------------------------*/
 
+TickType_t xTaskGetExpectedIdleTime( void )
+{
+    UBaseType_t uxReadyTasks;
+    TickType_t xReturn = ( TickType_t ) 0U;
+
+    if( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE )
+    {
+        /* Count the tasks in every list a ready task can be in, the idle
+         * task included. */
+        uxReadyTasks = listCURRENT_LIST_LENGTH( &xPendingReadyList );
+
+        #if ( configUSE_EDF_LEAN == 0 )
+        {
+            UBaseType_t uxPriority;
+
+            for( uxPriority = ( UBaseType_t ) 0U; uxPriority < ( UBaseType_t ) configMAX_PRIORITIES; uxPriority++ )
+            {
+                uxReadyTasks += listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ uxPriority ] ) );
+            }
+        }
+        #endif
+
+        #if ( configUSE_EDF_SCHEDULER == 1 )
+        {
+            uxReadyTasks += listCURRENT_LIST_LENGTH( &xReadyTasksListEDF );
+        }
+        #endif
+
+        #if ( configUSE_EDF_VD == 1 )
+        {
+            uxReadyTasks += listCURRENT_LIST_LENGTH( &xDroppedTasksListEDF );
+        }
+        #endif
+
+        #if ( configUSE_EDF_SLACK_STEALING == 1 )
+        {
+            uxReadyTasks += listCURRENT_LIST_LENGTH( &xSlackReadyTasksList );
+        }
+        #endif
+
+        if( ( uxReadyTasks == ( UBaseType_t ) 1U ) && ( pxCurrentTCB == xIdleTaskHandle ) )
+        {
+            xReturn = xNextTaskUnblockTime - xTickCount;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    return xReturn;
+}
+/*----------------------------------------------------------*/
+
 #if ( INCLUDE_xTaskAbortDelay == 1 )
 
     BaseType_t xTaskAbortDelay( TaskHandle_t xTask )
@@ -2809,6 +3834,7 @@ BaseType_t xTaskCatchUpTicks( TickType_t xTicksToCatchUp )
                 taskEXIT_CRITICAL();
 
                 /* Place the unblocked task into the appropriate ready list. */
+                prvRestoreJobDeadline( pxTCB );
                 prvAddTaskToReadyList( pxTCB );
 
                 /* A task being unblocked cannot cause an immediate context
@@ -2818,7 +3844,7 @@ BaseType_t xTaskCatchUpTicks( TickType_t xTicksToCatchUp )
                     /* Preemption is on, but a context switch should only be
                      * performed if the unblocked task has a priority that is
                      * higher than the currently executing task. */
-                    if( pxTCB->uxPriority > pxCurrentTCB->uxPriority )
+                    if( taskPREEMPTS_CURRENT( pxTCB ) )
                     {
                         /* Pend the yield to be performed when the scheduler
                          * is unsuspended. */
@@ -2850,6 +3876,10 @@ BaseType_t xTaskIncrementTick( void )
     TickType_t xItemValue;
     BaseType_t xSwitchRequired = pdFALSE;
 
+    #if ( configUSE_EDF_SCHEDULER == 1 )
+        BaseType_t xWaitTimedOut;
+    #endif
+
     /* Called by the portable layer each time a tick interrupt occurs.
      * Increments the tick then checks to see if the new tick value will cause any
      * tasks to be unblocked. */
@@ -2921,6 +3951,26 @@ BaseType_t xTaskIncrementTick( void )
 
                     /* Is the task waiting on an event also?  If so remove
                      * it from the event list. */
+                    #if ( configUSE_EDF_SCHEDULER == 1 )
+                    {
+                        xWaitTimedOut = ( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) != NULL ) ? pdTRUE : pdFALSE;
+
+                        #if ( configUSE_TASK_NOTIFICATIONS == 1 )
+                        {
+                            UBaseType_t uxIndex;
+
+                            for( uxIndex = 0; uxIndex < configTASK_NOTIFICATION_ARRAY_ENTRIES; uxIndex++ )
+                            {
+                                if( pxTCB->ucNotifyState[ uxIndex ] == taskWAITING_NOTIFICATION )
+                                {
+                                    xWaitTimedOut = pdTRUE;
+                                }
+                            }
+                        }
+                        #endif
+                    }
+                    #endif
+
                     if( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) != NULL )
                     {
                         listREMOVE_ITEM( &( pxTCB->xEventListItem ) );
@@ -2930,13 +3980,50 @@ BaseType_t xTaskIncrementTick( void )
                         mtCOVERAGE_TEST_MARKER();
                     }
 
+                    /* A task waking from xTaskDelayUntil() is released, time
+                     * the job from here. */
+                    #if ( configUSE_TASK_LATENCY_STATS == 1 )
+                    {
+                        if( pxTCB->ucJobState == tskJOB_WAITING_RELEASE )
+                        {
+                            pxTCB->ulJobRelease = portGET_RUN_TIME_COUNTER_VALUE();
+                            pxTCB->ucJobState = tskJOB_WAITING_START;
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
+                    }
+                    #endif
+
                     /* Place the unblocked task into the appropriate ready
                      * list. */
 										
 										/* Edit EDF Configuration */
 										#if configUSE_EDF_SCHEDULER == 1
 										
-										listSET_LIST_ITEM_VALUE( &( ( pxTCB )->xStateListItem ), ( pxTCB )->xTaskPeriod + xTaskGetTickCount());
+										if( xWaitTimedOut == pdFALSE )
+										{
+											listSET_LIST_ITEM_VALUE( &( ( pxTCB )->xStateListItem ), prvGetRelativeDeadline( pxTCB ) + xTaskGetTickCount());
+											pxTCB->xJobDeadline = listGET_LIST_ITEM_VALUE( &( pxTCB->xStateListItem ) );
+
+											/* Slack stealing: a task waking from its
+											 * periodic delay starts a new job. */
+											#if ( configUSE_EDF_SLACK_STEALING == 1 )
+											if( pxTCB->xJobActive == pdFALSE )
+											{
+												pxTCB->xJobActive = pdTRUE;
+												pxTCB->xNextRelease = xConstTickCount + pxTCB->xTaskPeriod;
+												xSlackStale = pdTRUE;
+											}
+											#endif
+											traceTASK_RELEASED( pxTCB );
+										}
+										else
+										{
+											/* The wait of the job for an event timed out. */
+											prvRestoreJobDeadline( pxTCB );
+										}
 											 /* Add the task in read  */
 										prvAddTaskToReadyList( pxTCB );	
 										xSwitchRequired = pdTRUE;
@@ -2955,7 +4042,7 @@ BaseType_t xTaskIncrementTick( void )
                          * processing time (which happens when both
                          * preemption and time slicing are on) is
                          * handled below.*/
-                        if( pxTCB->uxPriority > pxCurrentTCB->uxPriority )
+                        if( taskPREEMPTS_CURRENT( pxTCB ) )
                         {
                             xSwitchRequired = pdTRUE;
                         }
@@ -2969,10 +4056,157 @@ BaseType_t xTaskIncrementTick( void )
             }
         }
 
+        /* A job still ready when the tick reaches its deadline has missed it.
+         * Under EDF they are at the head of the ready list, so the walk stops
+         * at the first job with a later deadline.  Under EDF-VD the list holds
+         * virtual deadlines, which a job may overrun. */
+        #if ( ( configUSE_EDF_SCHEDULER == 1 ) && ( configUSE_EDF_VD == 0 ) && defined( traceTASK_DEADLINE_MISSED ) )
+        {
+            const ListItem_t * pxItem = listGET_HEAD_ENTRY( &xReadyTasksListEDF );
+            const ListItem_t * const pxEnd = listGET_END_MARKER( &xReadyTasksListEDF );
+
+            while( ( pxItem != pxEnd ) && ( listGET_LIST_ITEM_VALUE( pxItem ) <= xConstTickCount ) )
+            {
+                if( listGET_LIST_ITEM_VALUE( pxItem ) == xConstTickCount )
+                {
+                    pxTCB = listGET_LIST_ITEM_OWNER( pxItem ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+
+                    if( pxTCB != xIdleTaskHandle )
+                    {
+                        traceTASK_DEADLINE_MISSED( pxTCB );
+                    }
+                }
+
+                pxItem = listGET_NEXT( pxItem );
+            }
+        }
+        #endif
+
+        /* EDF-VD: charge the tick to the running job.  A HI job that runs past
+         * its LO budget switches the system to HI mode. */
+        #if ( ( configUSE_EDF_VD == 1 ) || ( configUSE_EDF_SLACK_STEALING == 1 ) )
+        {
+            pxCurrentTCB->xJobExecTime++;
+        }
+        #endif
+
+        #if ( configUSE_EDF_VD == 1 )
+        {
+            if( ( uxCriticalityMode == tskCRITICALITY_LO ) &&
+                ( pxCurrentTCB->uxCriticality == tskCRITICALITY_HI ) &&
+                ( pxCurrentTCB->xWcetLo != ( TickType_t ) 0U ) &&
+                ( pxCurrentTCB->xJobExecTime > pxCurrentTCB->xWcetLo ) )
+            {
+                prvSwitchToHiCriticality();
+                xSwitchRequired = pdTRUE;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            /* A HI job past its HI budget is outside of what the EDF-VD test
+             * assumed.  It is reported once, on the tick it overran, and runs
+             * on against its real deadline. */
+            if( ( uxCriticalityMode == tskCRITICALITY_HI ) &&
+                ( pxCurrentTCB->uxCriticality == tskCRITICALITY_HI ) &&
+                ( pxCurrentTCB->xWcetHi != ( TickType_t ) 0U ) &&
+                ( pxCurrentTCB->xJobExecTime == ( pxCurrentTCB->xWcetHi + ( TickType_t ) 1U ) ) )
+            {
+                traceTASK_HI_BUDGET_OVERRUN( pxCurrentTCB );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        #endif /* configUSE_EDF_VD */
+
+        /* Slack stealing: the slack is only recomputed, now the hard jobs
+         * have been charged and released, when a release, a completion or a
+         * slack task made ready has marked it stale.  Otherwise the tick that
+         * elapsed is taken off: the slack drops by one when the tick went to
+         * a slack task or to the idle task, and by at most one when it went to
+         * a hard job, so the count never exceeds the slack.  The slack tasks
+         * are switched out as soon as it reaches zero, and switched in as soon
+         * as it is positive again. */
+        #if ( configUSE_EDF_SLACK_STEALING == 1 )
+        {
+            if( listLIST_IS_EMPTY( &xSlackReadyTasksList ) == pdFALSE )
+            {
+                BaseType_t xSlackSelectable;
+
+                if( xSlackStale != pdFALSE )
+                {
+                    xSlackStale = pdFALSE;
+                    xAvailableSlack = prvComputeSlack( xConstTickCount );
+                }
+                else if( xAvailableSlack > ( TickType_t ) 0U )
+                {
+                    xAvailableSlack--;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                xSlackSelectable = prvSlackTaskSelectable();
+
+                if( ( ( pxCurrentTCB->xSlackTask != pdFALSE ) && ( xSlackSelectable == pdFALSE ) ) ||
+                    ( ( pxCurrentTCB->xSlackTask == pdFALSE ) && ( xSlackSelectable != pdFALSE ) ) )
+                {
+                    xSwitchRequired = pdTRUE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        #endif /* configUSE_EDF_SLACK_STEALING */
+
+        /* The CPU load is only computed once per window, not on every
+         * context switch. */
+        #if ( configUSE_CPU_LOAD_MONITOR == 1 )
+        {
+            xCpuLoadTicks++;
+
+            if( xCpuLoadTicks >= ( TickType_t ) configCPU_LOAD_WINDOW_TICKS )
+            {
+                xCpuLoadTicks = ( TickType_t ) 0U;
+                prvUpdateCpuLoad();
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        #endif /* configUSE_CPU_LOAD_MONITOR */
+
+        /* Limited-preemptive EDF: a deferred preemption is forced once the
+         * running task reaches its maximum non-preemptive length. */
+        #if ( configUSE_EDF_LIMITED_PREEMPTION == 1 )
+        {
+            if( ( xPreemptionDeferred != pdFALSE ) &&
+                ( ( xConstTickCount - pxCurrentTCB->xNonPreemptiveStart ) >= pxCurrentTCB->xMaxNonPreemptive ) )
+            {
+                xSwitchRequired = pdTRUE;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        #endif /* configUSE_EDF_LIMITED_PREEMPTION */
+
         /* Tasks of equal priority to the currently running task will share
          * processing time (time slice) if preemption is on, and the application
          * writer has not explicitly turned time slicing off. */
-        #if ( ( configUSE_PREEMPTION == 1 ) && ( configUSE_TIME_SLICING == 1 ) )
+        #if ( ( configUSE_PREEMPTION == 1 ) && ( configUSE_TIME_SLICING == 1 ) && ( configUSE_EDF_LEAN == 0 ) )
         {
             if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ pxCurrentTCB->uxPriority ] ) ) > ( UBaseType_t ) 1 )
             {
@@ -2983,7 +4217,7 @@ BaseType_t xTaskIncrementTick( void )
                 mtCOVERAGE_TEST_MARKER();
             }
         }
-        #endif /* ( ( configUSE_PREEMPTION == 1 ) && ( configUSE_TIME_SLICING == 1 ) ) */
+        #endif /* ( ( configUSE_PREEMPTION == 1 ) && ( configUSE_TIME_SLICING == 1 ) && ( configUSE_EDF_LEAN == 0 ) ) */
 
         #if ( configUSE_TICK_HOOK == 1 )
         {
@@ -3060,6 +4294,25 @@ BaseType_t xTaskIncrementTick( void )
 #endif /* configUSE_APPLICATION_TASK_TAG */
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_TASK_TRACE_PINS == 1 )
+
+    void vTaskSetTracePin( TaskHandle_t xTask,
+                           UBaseType_t uxPin )
+    {
+        TCB_t * pxTCB;
+
+        /* The pin is read by the trace hooks on every context switch. */
+        taskENTER_CRITICAL();
+        {
+            pxTCB = prvGetTCBFromHandle( xTask );
+            pxTCB->uxTracePin = uxPin;
+        }
+        taskEXIT_CRITICAL();
+    }
+
+#endif /* configUSE_TASK_TRACE_PINS */
+/*-----------------------------------------------------------*/
+
 #if ( configUSE_APPLICATION_TASK_TAG == 1 )
 
     TaskHookFunction_t xTaskGetApplicationTaskTag( TaskHandle_t xTask )
@@ -3194,19 +4447,82 @@ void vTaskSwitchContext( void )
         #endif
 
         /* Select a new task to run using either the generic C or port
-         * optimised asm code. */
-				 #if configUSE_EDF_SCHEDULER == 1
-				 {
-					 pxCurrentTCB = (TCB_t * ) listGET_OWNER_OF_HEAD_ENTRY( &(xReadyTasksListEDF ) );
-				 }
-				 #else
+         * optimised asm code.  In the hybrid mode the EDF band is only
+         * consulted when no fixed priority task above it is ready. */
+				 #if ( configUSE_EDF_HYBRID == 1 )
+				 if( prvEDFBandOnTop() == pdFALSE )
 				 {
 				 	 taskSELECT_HIGHEST_PRIORITY_TASK(); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
 				 }
+				 else
 				 #endif
-        
-        traceTASK_SWITCHED_IN();
-
+				 #if ( ( configUSE_EDF_SCHEDULER == 1 ) && ( configUSE_EDF_LIMITED_PREEMPTION == 1 ) )
+				 {
+					 TCB_t * pxEarliestTCB = prvGetEarliestTCBEDF();
+
+					 if( prvNonPreemptiveRegionActive( pxCurrentTCB ) )
+					 {
+						 /* The running job keeps the processor until its next
+						  * preemption point. */
+						 if( pxEarliestTCB != pxCurrentTCB )
+						 {
+							 xPreemptionDeferred = pdTRUE;
+						 }
+					 }
+					 else
+					 {
+						 xPreemptionDeferred = pdFALSE;
+						 xPreemptionPointReached = pdFALSE;
+
+						 if( pxEarliestTCB != pxCurrentTCB )
+						 {
+							 prvRecordNonPreemptiveRegion( pxCurrentTCB );
+							 pxCurrentTCB = pxEarliestTCB;
+							 pxCurrentTCB->xNonPreemptiveStart = xTickCount;
+						 }
+					 }
+				 }
+				 #elif ( ( configUSE_EDF_SCHEDULER == 1 ) && ( configUSE_EDF_NON_PREEMPTIVE == 1 ) )
+				 {
+					 /* Non-preemptive EDF: a new job is only selected once the
+					  * running one completes or blocks.  The idle task is not a
+					  * job, so it always gives way. */
+					 if( ( pxCurrentTCB == xIdleTaskHandle ) ||
+						 ( listIS_CONTAINED_WITHIN( &xReadyTasksListEDF, &( pxCurrentTCB->xStateListItem ) ) == pdFALSE ) )
+					 {
+						 pxCurrentTCB = prvGetEarliestTCBEDF();
+					 }
+					 else
+					 {
+						 mtCOVERAGE_TEST_MARKER();
+					 }
+				 }
+				 #elif configUSE_EDF_SCHEDULER == 1
+				 {
+					 pxCurrentTCB = prvGetEarliestTCBEDF();
+				 }
+				 #else
+				 {
+				 	 taskSELECT_HIGHEST_PRIORITY_TASK(); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+				 }
+				 #endif
+
+        #if ( configUSE_TASK_LATENCY_STATS == 1 )
+        {
+            if( pxCurrentTCB->ucJobState == tskJOB_WAITING_START )
+            {
+                prvRecordLatency( &( pxCurrentTCB->xLatency.xStartJitter ), ( uint32_t ) ( ulTotalRunTime - pxCurrentTCB->ulJobRelease ) );
+                pxCurrentTCB->ucJobState = tskJOB_RUNNING;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        #endif
+        
+        traceTASK_SWITCHED_IN();
+
         /* After the new task is switched in, update the global errno. */
         #if ( configUSE_POSIX_ERRNO == 1 )
         {
@@ -3243,7 +4559,16 @@ void vTaskPlaceOnEventList( List_t * const pxEventList,
      * Therefore, the event list is sorted in descending priority order.
      *
      * The queue that contains the event list is locked, preventing
-     * simultaneous access from interrupts. */
+     * simultaneous access from interrupts.
+     *
+     * In the lean EDF build there is no priority, the event list is sorted by
+     * deadline instead so the earliest job is the first to be woken. */
+    #if ( configUSE_EDF_LEAN == 1 )
+    {
+        listSET_LIST_ITEM_VALUE( &( pxCurrentTCB->xEventListItem ), listGET_LIST_ITEM_VALUE( &( pxCurrentTCB->xStateListItem ) ) );
+    }
+    #endif
+
     vListInsert( pxEventList, &( pxCurrentTCB->xEventListItem ) );
 
     prvAddCurrentTaskToDelayedList( xTicksToWait, pdTRUE );
@@ -3336,6 +4661,7 @@ BaseType_t xTaskRemoveFromEventList( const List_t * const pxEventList )
     if( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE )
     {
         listREMOVE_ITEM( &( pxUnblockedTCB->xStateListItem ) );
+        prvRestoreJobDeadline( pxUnblockedTCB );
         prvAddTaskToReadyList( pxUnblockedTCB );
 
         #if ( configUSE_TICKLESS_IDLE != 0 )
@@ -3359,7 +4685,7 @@ BaseType_t xTaskRemoveFromEventList( const List_t * const pxEventList )
         listINSERT_END( &( xPendingReadyList ), &( pxUnblockedTCB->xEventListItem ) );
     }
 
-    if( pxUnblockedTCB->uxPriority > pxCurrentTCB->uxPriority )
+    if( taskPREEMPTS_CURRENT( pxUnblockedTCB ) )
     {
         /* Return true if the task removed from the event list has a higher
          * priority than the calling task.  This allows the calling task to know if
@@ -3415,9 +4741,10 @@ void vTaskRemoveFromUnorderedEventList( ListItem_t * pxEventListItem,
      * scheduler is suspended so interrupts will not be accessing the ready
      * lists. */
     listREMOVE_ITEM( &( pxUnblockedTCB->xStateListItem ) );
+    prvRestoreJobDeadline( pxUnblockedTCB );
     prvAddTaskToReadyList( pxUnblockedTCB );
 
-    if( pxUnblockedTCB->uxPriority > pxCurrentTCB->uxPriority )
+    if( taskPREEMPTS_CURRENT( pxUnblockedTCB ) )
     {
         /* The unblocked task has a priority above that of the calling task, so
          * a context switch is required.  This function is called with the
@@ -3601,12 +4928,44 @@ static portTASK_FUNCTION( prvIdleTask, pvParameters )
 				/* EDF Edit */
 				#if configUSE_EDF_SCHEDULER == 1
 				{
-					listSET_LIST_ITEM_VALUE( &( ( pxCurrentTCB )->xStateListItem ), ( pxCurrentTCB )->xTaskPeriod + xTaskGetTickCount());					listINSERT_END( &xReadyTasksListEDF, &( pxCurrentTCB->xStateListItem ) );
-					listINSERT_END( &xReadyTasksListEDF, &( pxCurrentTCB->xStateListItem ) );
+					BaseType_t xYieldRequired = pdFALSE;
+
+					/* The idle task is already in the EDF ready list, so it is
+					 * removed before being re-inserted behind its new deadline.
+					 * In the hybrid mode it is in its fixed priority list. */
+					taskENTER_CRITICAL();
+					{
+						#if ( configUSE_EDF_HYBRID == 0 )
+						{
+							( void ) uxListRemove( &( pxCurrentTCB->xStateListItem ) );
+							listSET_LIST_ITEM_VALUE( &( ( pxCurrentTCB )->xStateListItem ), ( pxCurrentTCB )->xTaskPeriod + xTickCount );
+							vListInsert( &xReadyTasksListEDF, &( pxCurrentTCB->xStateListItem ) );
+						}
+						#endif
+
+						/* EDF-VD: with only the idle task ready no HI job is
+						 * pending, so this is an idle instant and the system can
+						 * return to LO mode. */
+						#if ( configUSE_EDF_VD == 1 )
+						{
+							if( ( uxCriticalityMode == tskCRITICALITY_HI ) &&
+								( listCURRENT_LIST_LENGTH( &xReadyTasksListEDF ) == tskEDF_IDLE_ENTRIES ) )
+							{
+								xYieldRequired = prvSwitchToLoCriticality();
+							}
+						}
+						#endif
+					}
+					taskEXIT_CRITICAL();
+
+					if( xYieldRequired != pdFALSE )
+					{
+						taskYIELD();
+					}
 				}
 				#endif
 
-        #if ( ( configUSE_PREEMPTION == 1 ) && ( configIDLE_SHOULD_YIELD == 1 ) )
+        #if ( ( configUSE_PREEMPTION == 1 ) && ( configIDLE_SHOULD_YIELD == 1 ) && ( configUSE_EDF_LEAN == 0 ) )
         {
             /* When using preemption tasks of equal priority will be
              * timesliced.  If a task that is sharing the idle priority is ready
@@ -3626,7 +4985,7 @@ static portTASK_FUNCTION( prvIdleTask, pvParameters )
                 mtCOVERAGE_TEST_MARKER();
             }
         }
-        #endif /* ( ( configUSE_PREEMPTION == 1 ) && ( configIDLE_SHOULD_YIELD == 1 ) ) */
+        #endif /* ( ( configUSE_PREEMPTION == 1 ) && ( configIDLE_SHOULD_YIELD == 1 ) && ( configUSE_EDF_LEAN == 0 ) ) */
 
         #if ( configUSE_IDLE_HOOK == 1 )
         {
@@ -3809,12 +5168,16 @@ static portTASK_FUNCTION( prvIdleTask, pvParameters )
 
 static void prvInitialiseTaskLists( void )
 {
-    UBaseType_t uxPriority;
-
-    for( uxPriority = ( UBaseType_t ) 0U; uxPriority < ( UBaseType_t ) configMAX_PRIORITIES; uxPriority++ )
+    #if ( configUSE_EDF_LEAN == 0 )
     {
-        vListInitialise( &( pxReadyTasksLists[ uxPriority ] ) );
+        UBaseType_t uxPriority;
+
+        for( uxPriority = ( UBaseType_t ) 0U; uxPriority < ( UBaseType_t ) configMAX_PRIORITIES; uxPriority++ )
+        {
+            vListInitialise( &( pxReadyTasksLists[ uxPriority ] ) );
+        }
     }
+    #endif
 
     vListInitialise( &xDelayedTaskList1 );
     vListInitialise( &xDelayedTaskList2 );
@@ -3824,6 +5187,14 @@ static void prvInitialiseTaskLists( void )
 		#if configUSE_EDF_SCHEDULER == 1
 			vListInitialise( &xReadyTasksListEDF);
 		#endif
+
+		#if ( configUSE_EDF_VD == 1 )
+			vListInitialise( &xDroppedTasksListEDF );
+		#endif
+
+		#if ( configUSE_EDF_SLACK_STEALING == 1 )
+			vListInitialise( &xSlackReadyTasksList );
+		#endif
     
 		#if ( INCLUDE_vTaskDelete == 1 )
     {
@@ -3886,7 +5257,16 @@ static void prvCheckTasksWaitingTermination( void )
 
         pxTaskStatus->xHandle = ( TaskHandle_t ) pxTCB;
         pxTaskStatus->pcTaskName = ( const char * ) &( pxTCB->pcTaskName[ 0 ] );
-        pxTaskStatus->uxCurrentPriority = pxTCB->uxPriority;
+        #if ( configUSE_EDF_LEAN == 0 )
+        {
+            pxTaskStatus->uxCurrentPriority = pxTCB->uxPriority;
+        }
+        #else
+        {
+            /* Every task runs at the same priority, scheduled by its deadline. */
+            pxTaskStatus->uxCurrentPriority = tskIDLE_PRIORITY;
+        }
+        #endif
         pxTaskStatus->pxStackBase = pxTCB->pxStack;
         #if ( ( portSTACK_GROWTH > 0 ) && ( configRECORD_STACK_HIGH_ADDRESS == 1 ) )
             pxTaskStatus->pxTopOfStack = pxTCB->pxTopOfStack;
@@ -4011,7 +5391,7 @@ static void prvCheckTasksWaitingTermination( void )
 #endif /* configUSE_TRACE_FACILITY */
 /*-----------------------------------------------------------*/
 
-#if ( ( configUSE_TRACE_FACILITY == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark2 == 1 ) )
+#if ( ( configUSE_TRACE_FACILITY == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark2 == 1 ) || ( configUSE_STACK_PROFILING == 1 ) )
 
     static configSTACK_DEPTH_TYPE prvTaskCheckFreeStackSpace( const uint8_t * pucStackByte )
     {
@@ -4025,154 +5405,1086 @@ static void prvCheckTasksWaitingTermination( void )
 
         ulCount /= ( uint32_t ) sizeof( StackType_t ); /*lint !e961 Casting is not redundant on smaller architectures. */
 
-        return ( configSTACK_DEPTH_TYPE ) ulCount;
+        return ( configSTACK_DEPTH_TYPE ) ulCount;
+    }
+
+#endif /* ( ( configUSE_TRACE_FACILITY == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark2 == 1 ) || ( configUSE_STACK_PROFILING == 1 ) ) */
+/*-----------------------------------------------------------*/
+
+#if ( INCLUDE_uxTaskGetStackHighWaterMark2 == 1 )
+
+/* uxTaskGetStackHighWaterMark() and uxTaskGetStackHighWaterMark2() are the
+ * same except for their return type.  Using configSTACK_DEPTH_TYPE allows the
+ * user to determine the return type.  It gets around the problem of the value
+ * overflowing on 8-bit types without breaking backward compatibility for
+ * applications that expect an 8-bit return type. */
+    configSTACK_DEPTH_TYPE uxTaskGetStackHighWaterMark2( TaskHandle_t xTask )
+    {
+        TCB_t * pxTCB;
+        uint8_t * pucEndOfStack;
+        configSTACK_DEPTH_TYPE uxReturn;
+
+        /* uxTaskGetStackHighWaterMark() and uxTaskGetStackHighWaterMark2() are
+         * the same except for their return type.  Using configSTACK_DEPTH_TYPE
+         * allows the user to determine the return type.  It gets around the
+         * problem of the value overflowing on 8-bit types without breaking
+         * backward compatibility for applications that expect an 8-bit return
+         * type. */
+
+        pxTCB = prvGetTCBFromHandle( xTask );
+
+        #if portSTACK_GROWTH < 0
+        {
+            pucEndOfStack = ( uint8_t * ) pxTCB->pxStack;
+        }
+        #else
+        {
+            pucEndOfStack = ( uint8_t * ) pxTCB->pxEndOfStack;
+        }
+        #endif
+
+        uxReturn = prvTaskCheckFreeStackSpace( pucEndOfStack );
+
+        return uxReturn;
+    }
+
+#endif /* INCLUDE_uxTaskGetStackHighWaterMark2 */
+/*-----------------------------------------------------------*/
+
+#if ( INCLUDE_uxTaskGetStackHighWaterMark == 1 )
+
+    UBaseType_t uxTaskGetStackHighWaterMark( TaskHandle_t xTask )
+    {
+        TCB_t * pxTCB;
+        uint8_t * pucEndOfStack;
+        UBaseType_t uxReturn;
+
+        pxTCB = prvGetTCBFromHandle( xTask );
+
+        #if portSTACK_GROWTH < 0
+        {
+            pucEndOfStack = ( uint8_t * ) pxTCB->pxStack;
+        }
+        #else
+        {
+            pucEndOfStack = ( uint8_t * ) pxTCB->pxEndOfStack;
+        }
+        #endif
+
+        uxReturn = ( UBaseType_t ) prvTaskCheckFreeStackSpace( pucEndOfStack );
+
+        return uxReturn;
+    }
+
+#endif /* INCLUDE_uxTaskGetStackHighWaterMark */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_STACK_PROFILING == 1 )
+
+    void vTaskGetStackProfile( TaskHandle_t xTask,
+                               TaskStackProfile_t * pxProfile )
+    {
+        TCB_t * pxTCB;
+        uint8_t * pucEndOfStack;
+        uint32_t ulUsed, ulRecommended;
+        const uint32_t ulAlignmentWords = ( uint32_t ) ( ( portBYTE_ALIGNMENT + sizeof( StackType_t ) - 1U ) / sizeof( StackType_t ) );
+
+        configASSERT( pxProfile );
+
+        pxTCB = prvGetTCBFromHandle( xTask );
+
+        #if portSTACK_GROWTH < 0
+        {
+            pucEndOfStack = ( uint8_t * ) pxTCB->pxStack;
+        }
+        #else
+        {
+            pucEndOfStack = ( uint8_t * ) pxTCB->pxEndOfStack;
+        }
+        #endif
+
+        /* pxEndOfStack is the highest word of the stack in both directions of
+         * growth, once aligned when the stack grows down. */
+        pxProfile->usStackDepth = ( configSTACK_DEPTH_TYPE ) ( ( pxTCB->pxEndOfStack - pxTCB->pxStack ) + 1 );
+        ulUsed = ( uint32_t ) pxProfile->usStackDepth - ( uint32_t ) prvTaskCheckFreeStackSpace( pucEndOfStack );
+        pxProfile->usStackUsed = ( configSTACK_DEPTH_TYPE ) ulUsed;
+
+        /* The margin, then whole alignment units.  When the stack grows down
+         * the alignment of its top can cost up to one unit less a word of the
+         * depth passed to xTaskCreate(), so that is added too. */
+        ulRecommended = ulUsed + ( ( ulUsed * ( uint32_t ) configSTACK_PROFILING_MARGIN ) + 99U ) / 100U;
+        ulRecommended = ( ( ulRecommended + ulAlignmentWords - 1U ) / ulAlignmentWords ) * ulAlignmentWords;
+
+        #if portSTACK_GROWTH < 0
+        {
+            ulRecommended += ulAlignmentWords - 1U;
+        }
+        #endif
+
+        pxProfile->usRecommendedDepth = ( configSTACK_DEPTH_TYPE ) ulRecommended;
+    }
+
+#endif /* configUSE_STACK_PROFILING */
+/*-----------------------------------------------------------*/
+
+#if ( INCLUDE_vTaskDelete == 1 )
+
+    static void prvDeleteTCB( TCB_t * pxTCB )
+    {
+        /* This call is required specifically for the TriCore port.  It must be
+         * above the vPortFree() calls.  The call is also used by ports/demos that
+         * want to allocate and clean RAM statically. */
+        portCLEAN_UP_TCB( pxTCB );
+
+        #if ( ( configUSE_NEWLIB_REENTRANT == 1 ) || ( configUSE_C_RUNTIME_TLS_SUPPORT == 1 ) )
+        {
+            /* Free up the memory allocated for the task's TLS Block. */
+            configDEINIT_TLS_BLOCK( pxCurrentTCB->xTLSBlock );
+        }
+        #endif
+
+        #if ( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( tskTCB_RECORDS_ALLOCATION == 0 ) )
+        {
+            /* The task can only have been allocated dynamically - free both
+             * the stack and TCB. */
+            vPortFreeStack( pxTCB->pxStack );
+            vPortFree( pxTCB );
+        }
+        #elif ( tskTCB_RECORDS_ALLOCATION != 0 ) /*lint !e731 !e9029 Macro has been consolidated for readability reasons. */
+        {
+            /* The task could have been allocated statically or dynamically, or
+             * in the block of a table, so check what was statically allocated
+             * before trying to free the memory. */
+            if( pxTCB->ucStaticallyAllocated == tskDYNAMICALLY_ALLOCATED_STACK_AND_TCB )
+            {
+                /* Both the stack and TCB were allocated dynamically, so both
+                 * must be freed. */
+                vPortFreeStack( pxTCB->pxStack );
+                vPortFree( pxTCB );
+            }
+            else if( pxTCB->ucStaticallyAllocated == tskSTATICALLY_ALLOCATED_STACK_ONLY )
+            {
+                /* Only the stack was statically allocated, so the TCB is the
+                 * only memory that must be freed. */
+                vPortFree( pxTCB );
+            }
+            else
+            {
+                /* Neither the stack nor the TCB were allocated dynamically, or
+                 * they belong to the block of a table, so nothing needs to be
+                 * freed. */
+                configASSERT( ( pxTCB->ucStaticallyAllocated == tskSTATICALLY_ALLOCATED_STACK_AND_TCB ) ||
+                              ( pxTCB->ucStaticallyAllocated == tskTABLE_ALLOCATED_STACK_AND_TCB ) );
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        #endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+    }
+
+#endif /* INCLUDE_vTaskDelete */
+/*-----------------------------------------------------------*/
+
+static void prvResetNextTaskUnblockTime( void )
+{
+    if( listLIST_IS_EMPTY( pxDelayedTaskList ) != pdFALSE )
+    {
+        /* The new current delayed list is empty.  Set xNextTaskUnblockTime to
+         * the maximum possible value so it is  extremely unlikely that the
+         * if( xTickCount >= xNextTaskUnblockTime ) test will pass until
+         * there is an item in the delayed list. */
+        xNextTaskUnblockTime = portMAX_DELAY;
+    }
+    else
+    {
+        /* The new current delayed list is not empty, get the value of
+         * the item at the head of the delayed list.  This is the time at
+         * which the task at the head of the delayed list should be removed
+         * from the Blocked state. */
+        xNextTaskUnblockTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxDelayedTaskList );
+    }
+}
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_EDF_VD == 1 )
+
+    static TickType_t prvGetVirtualDeadline( const TCB_t * const pxTCB )
+    {
+        TickType_t xDeadline = pxTCB->xTaskPeriod;
+
+        /* Only HI tasks that declared a LO budget are scaled. */
+        if( ( pxTCB->uxCriticality == tskCRITICALITY_HI ) && ( pxTCB->xWcetLo != ( TickType_t ) 0U ) )
+        {
+            xDeadline = ( TickType_t ) ( ( pxTCB->xTaskPeriod * uxVirtualDeadlineScale ) / tskEDF_VD_SCALE_ONE );
+
+            /* A job cannot meet a deadline shorter than its own budget. */
+            if( xDeadline < pxTCB->xWcetLo )
+            {
+                xDeadline = pxTCB->xWcetLo;
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return xDeadline;
+    }
+    /*-----------------------------------------------------------*/
+
+    static void prvGetCriticalityUtilisations( UBaseType_t * puxLoTasksLo,
+                                               UBaseType_t * puxHiTasksLo,
+                                               UBaseType_t * puxHiTasksHi )
+    {
+        const ListItem_t * pxEndMarker = listGET_END_MARKER( &xReadyTasksListEDF );
+        ListItem_t * pxIterator;
+        TCB_t * pxTCB;
+
+        *puxLoTasksLo = ( UBaseType_t ) 0U;
+        *puxHiTasksLo = ( UBaseType_t ) 0U;
+        *puxHiTasksHi = ( UBaseType_t ) 0U;
+
+        /* Only valid before the scheduler starts, when every task of the
+         * initial task set is in the EDF ready list.  The utilisations are
+         * rounded up so the virtual deadlines are never too long. */
+        for( pxIterator = listGET_HEAD_ENTRY( &xReadyTasksListEDF ); pxIterator != pxEndMarker; pxIterator = listGET_NEXT( pxIterator ) )
+        {
+            pxTCB = listGET_LIST_ITEM_OWNER( pxIterator ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+
+            if( pxTCB->uxCriticality == tskCRITICALITY_LO )
+            {
+                *puxLoTasksLo += ( UBaseType_t ) ( ( ( pxTCB->xWcetLo * tskEDF_VD_SCALE_ONE ) + pxTCB->xTaskPeriod - 1U ) / pxTCB->xTaskPeriod );
+            }
+            else
+            {
+                *puxHiTasksLo += ( UBaseType_t ) ( ( ( pxTCB->xWcetLo * tskEDF_VD_SCALE_ONE ) + pxTCB->xTaskPeriod - 1U ) / pxTCB->xTaskPeriod );
+                *puxHiTasksHi += ( UBaseType_t ) ( ( ( pxTCB->xWcetHi * tskEDF_VD_SCALE_ONE ) + pxTCB->xTaskPeriod - 1U ) / pxTCB->xTaskPeriod );
+            }
+        }
+    }
+    /*-----------------------------------------------------------*/
+
+    static BaseType_t prvEDFVDSchedulable( UBaseType_t uxLoTasksLo,
+                                           UBaseType_t uxHiTasksLo,
+                                           UBaseType_t uxHiTasksHi,
+                                           UBaseType_t * puxScale )
+    {
+        BaseType_t xReturn = pdFALSE;
+
+        /* x = U_HI(LO) / ( 1 - U_LO(LO) ).  If the LO level is already
+         * overloaded there is no room for virtual deadlines, the HI tasks
+         * keep their real ones and the set is not schedulable. */
+        if( ( uxLoTasksLo < tskEDF_VD_SCALE_ONE ) &&
+            ( uxHiTasksLo < ( tskEDF_VD_SCALE_ONE - uxLoTasksLo ) ) )
+        {
+            *puxScale = ( ( uxHiTasksLo * tskEDF_VD_SCALE_ONE ) + ( tskEDF_VD_SCALE_ONE - uxLoTasksLo ) - 1U ) / ( tskEDF_VD_SCALE_ONE - uxLoTasksLo );
+
+            /* The HI mode fits if x * U_LO(LO) + U_HI(HI) <= 1. */
+            if( ( ( ( *puxScale * uxLoTasksLo ) + tskEDF_VD_SCALE_ONE - 1U ) / tskEDF_VD_SCALE_ONE ) + uxHiTasksHi <= tskEDF_VD_SCALE_ONE )
+            {
+                xReturn = pdTRUE;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            *puxScale = tskEDF_VD_SCALE_ONE;
+        }
+
+        return xReturn;
+    }
+    /*-----------------------------------------------------------*/
+
+    static void prvComputeVirtualDeadlines( void )
+    {
+        List_t xSortedList;
+        TCB_t * pxTCB;
+        UBaseType_t uxLoTasksLo, uxHiTasksLo, uxHiTasksHi;
+        BaseType_t xSchedulable;
+
+        prvGetCriticalityUtilisations( &uxLoTasksLo, &uxHiTasksLo, &uxHiTasksHi );
+        xSchedulable = prvEDFVDSchedulable( uxLoTasksLo, uxHiTasksLo, uxHiTasksHi, &uxVirtualDeadlineScale );
+
+        /* The application can check the task set itself with
+         * xTaskCheckEDFVDSchedulability() before it starts the scheduler. */
+        configASSERT( xSchedulable != pdFALSE );
+        ( void ) xSchedulable;
+
+        /* Re-key every task on its new deadline.  The tasks are sorted into a
+         * temporary list first as changing the item values in place would
+         * break the ordering of the ready list. */
+        vListInitialise( &xSortedList );
+
+        while( listLIST_IS_EMPTY( &xReadyTasksListEDF ) == pdFALSE )
+        {
+            pxTCB = listGET_OWNER_OF_HEAD_ENTRY( &xReadyTasksListEDF ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+            ( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+            pxTCB->xVirtualDeadline = prvGetVirtualDeadline( pxTCB );
+            listSET_LIST_ITEM_VALUE( &( pxTCB->xStateListItem ), pxTCB->xVirtualDeadline + xTickCount );
+            pxTCB->xJobDeadline = listGET_LIST_ITEM_VALUE( &( pxTCB->xStateListItem ) );
+            vListInsert( &xSortedList, &( pxTCB->xStateListItem ) );
+        }
+
+        while( listLIST_IS_EMPTY( &xSortedList ) == pdFALSE )
+        {
+            pxTCB = listGET_OWNER_OF_HEAD_ENTRY( &xSortedList ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+            ( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+            listINSERT_END( &xReadyTasksListEDF, &( pxTCB->xStateListItem ) );
+        }
+
+        /* Start with the earliest deadline rather than the last task created. */
+        pxCurrentTCB = listGET_OWNER_OF_HEAD_ENTRY( &xReadyTasksListEDF ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+    }
+    /*-----------------------------------------------------------*/
+
+    static void prvSwitchToHiCriticality( void )
+    {
+        List_t xSortedList;
+        TCB_t * pxTCB;
+
+        /* Called from the tick interrupt. */
+        uxCriticalityMode = tskCRITICALITY_HI;
+
+        /* Drop the ready LO tasks and move the ready HI jobs from their
+         * virtual deadline back to their real deadline. */
+        vListInitialise( &xSortedList );
+
+        while( listLIST_IS_EMPTY( &xReadyTasksListEDF ) == pdFALSE )
+        {
+            pxTCB = listGET_OWNER_OF_HEAD_ENTRY( &xReadyTasksListEDF ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+            ( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+
+            if( pxTCB->uxCriticality == tskCRITICALITY_LO )
+            {
+                listINSERT_END( &xDroppedTasksListEDF, &( pxTCB->xStateListItem ) );
+            }
+            else
+            {
+                listSET_LIST_ITEM_VALUE( &( pxTCB->xStateListItem ), listGET_LIST_ITEM_VALUE( &( pxTCB->xStateListItem ) ) + ( pxTCB->xTaskPeriod - pxTCB->xVirtualDeadline ) );
+                pxTCB->xJobDeadline = listGET_LIST_ITEM_VALUE( &( pxTCB->xStateListItem ) );
+                vListInsert( &xSortedList, &( pxTCB->xStateListItem ) );
+            }
+        }
+
+        while( listLIST_IS_EMPTY( &xSortedList ) == pdFALSE )
+        {
+            pxTCB = listGET_OWNER_OF_HEAD_ENTRY( &xSortedList ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+            ( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+            listINSERT_END( &xReadyTasksListEDF, &( pxTCB->xStateListItem ) );
+        }
+    }
+    /*-----------------------------------------------------------*/
+
+    static BaseType_t prvSwitchToLoCriticality( void )
+    {
+        TCB_t * pxTCB;
+        BaseType_t xTaskRestored = pdFALSE;
+
+        /* Called from the idle task, inside a critical section, when no HI
+         * job is pending. */
+        uxCriticalityMode = tskCRITICALITY_LO;
+
+        /* The dropped LO tasks are released again with a fresh deadline and
+         * a full budget. */
+        while( listLIST_IS_EMPTY( &xDroppedTasksListEDF ) == pdFALSE )
+        {
+            pxTCB = listGET_OWNER_OF_HEAD_ENTRY( &xDroppedTasksListEDF ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+            ( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+            pxTCB->xJobExecTime = ( TickType_t ) 0U;
+            listSET_LIST_ITEM_VALUE( &( pxTCB->xStateListItem ), prvGetRelativeDeadline( pxTCB ) + xTickCount );
+            pxTCB->xJobDeadline = listGET_LIST_ITEM_VALUE( &( pxTCB->xStateListItem ) );
+            prvAddTaskToReadyList( pxTCB );
+            xTaskRestored = pdTRUE;
+        }
+
+        return xTaskRestored;
+    }
+    /*-----------------------------------------------------------*/
+
+    UBaseType_t uxTaskGetCriticalityMode( void )
+    {
+        return uxCriticalityMode;
+    }
+    /*-----------------------------------------------------------*/
+
+    BaseType_t xTaskCheckEDFVDSchedulability( void )
+    {
+        UBaseType_t uxLoTasksLo, uxHiTasksLo, uxHiTasksHi, uxScale;
+        BaseType_t xReturn;
+
+        configASSERT( xSchedulerRunning == pdFALSE );
+
+        taskENTER_CRITICAL();
+        {
+            prvGetCriticalityUtilisations( &uxLoTasksLo, &uxHiTasksLo, &uxHiTasksHi );
+            xReturn = prvEDFVDSchedulable( uxLoTasksLo, uxHiTasksLo, uxHiTasksHi, &uxScale );
+        }
+        taskEXIT_CRITICAL();
+
+        return xReturn;
+    }
+
+#endif /* configUSE_EDF_VD */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_EDF_LIMITED_PREEMPTION == 1 )
+
+    void vTaskSetMaxNonPreemptiveLength( TaskHandle_t xTask,
+                                         TickType_t xMaxNonPreemptive )
+    {
+        TCB_t * pxTCB;
+
+        taskENTER_CRITICAL();
+        {
+            pxTCB = prvGetTCBFromHandle( xTask );
+            pxTCB->xMaxNonPreemptive = xMaxNonPreemptive;
+            pxTCB->xNonPreemptiveStart = xTickCount;
+        }
+        taskEXIT_CRITICAL();
+    }
+    /*-----------------------------------------------------------*/
+
+    TickType_t xTaskGetLongestNonPreemptiveRegion( TaskHandle_t xTask )
+    {
+        TCB_t * pxTCB;
+        TickType_t xReturn;
+
+        taskENTER_CRITICAL();
+        {
+            pxTCB = prvGetTCBFromHandle( xTask );
+            xReturn = pxTCB->xLongestNonPreemptive;
+        }
+        taskEXIT_CRITICAL();
+
+        return xReturn;
+    }
+    /*-----------------------------------------------------------*/
+
+    void vTaskPreemptionPoint( void )
+    {
+        BaseType_t xYieldRequired = pdFALSE;
+
+        taskENTER_CRITICAL();
+        {
+            /* The non-preemptive region ends here, a new one starts unless a
+             * deferred preemption takes the processor away first. */
+            prvRecordNonPreemptiveRegion( pxCurrentTCB );
+            pxCurrentTCB->xNonPreemptiveStart = xTickCount;
+
+            if( xPreemptionDeferred != pdFALSE )
+            {
+                xPreemptionPointReached = pdTRUE;
+                xYieldRequired = pdTRUE;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        if( xYieldRequired != pdFALSE )
+        {
+            portYIELD_WITHIN_API();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+
+#endif /* configUSE_EDF_LIMITED_PREEMPTION */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_CPU_LOAD_MONITOR == 1 )
+
+    static void prvUpdateCpuLoad( void )
+    {
+        configRUN_TIME_COUNTER_TYPE ulTotal, ulIdle, ulTotalDelta, ulIdleDelta;
+        uint32_t ulIdlePerMille, ulSample;
+
+        ulTotal = portGET_RUN_TIME_COUNTER_VALUE();
+        ulIdle = xIdleTaskHandle->ulRunTimeCounter;
+
+        /* The counter of the idle task is only updated when it is switched
+         * out, so add the time it has been running for if it is running now. */
+        if( pxCurrentTCB == xIdleTaskHandle )
+        {
+            ulIdle += ( ulTotal - ulTaskSwitchedInTime );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        ulTotalDelta = ulTotal - ulCpuLoadLastTotal;
+        ulIdleDelta = ulIdle - ulCpuLoadLastIdle;
+        ulCpuLoadLastTotal = ulTotal;
+        ulCpuLoadLastIdle = ulIdle;
+
+        if( ulTotalDelta > ( configRUN_TIME_COUNTER_TYPE ) 0 )
+        {
+            /* Integer only, ulIdleDelta * 1000 is kept from overflowing by
+             * scaling the divisor instead when the window is long. */
+            if( ulTotalDelta > ( ( configRUN_TIME_COUNTER_TYPE ) ~( configRUN_TIME_COUNTER_TYPE ) 0 / ( configRUN_TIME_COUNTER_TYPE ) 1000 ) )
+            {
+                ulIdlePerMille = ( uint32_t ) ( ulIdleDelta / ( ulTotalDelta / ( configRUN_TIME_COUNTER_TYPE ) 1000 ) );
+            }
+            else
+            {
+                ulIdlePerMille = ( uint32_t ) ( ( ulIdleDelta * ( configRUN_TIME_COUNTER_TYPE ) 1000 ) / ulTotalDelta );
+            }
+
+            if( ulIdlePerMille > 1000UL )
+            {
+                ulIdlePerMille = 1000UL;
+            }
+
+            ulSample = ( 1000UL - ulIdlePerMille ) << tskCPU_LOAD_FRACTION_BITS;
+
+            /* The longer windows are exponentially weighted moving averages
+             * of the window load, each new window weighing 1 / N. */
+            ulCpuLoad[ tskCPU_LOAD_WINDOW ] = ulSample;
+            ulCpuLoad[ tskCPU_LOAD_MEDIUM ] = ( uint32_t ) ( ( int32_t ) ulCpuLoad[ tskCPU_LOAD_MEDIUM ] + ( ( ( int32_t ) ulSample - ( int32_t ) ulCpuLoad[ tskCPU_LOAD_MEDIUM ] ) / ( int32_t ) configCPU_LOAD_MEDIUM_WINDOWS ) );
+            ulCpuLoad[ tskCPU_LOAD_LONG ] = ( uint32_t ) ( ( int32_t ) ulCpuLoad[ tskCPU_LOAD_LONG ] + ( ( ( int32_t ) ulSample - ( int32_t ) ulCpuLoad[ tskCPU_LOAD_LONG ] ) / ( int32_t ) configCPU_LOAD_LONG_WINDOWS ) );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    /*-----------------------------------------------------------*/
+
+    UBaseType_t uxTaskGetCpuLoad( UBaseType_t uxWindow )
+    {
+        UBaseType_t uxReturn = ( UBaseType_t ) 0U;
+
+        if( uxWindow <= tskCPU_LOAD_LONG )
+        {
+            uxReturn = ( UBaseType_t ) ( ulCpuLoad[ uxWindow ] >> tskCPU_LOAD_FRACTION_BITS );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return uxReturn;
+    }
+
+#endif /* configUSE_CPU_LOAD_MONITOR */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TASK_LATENCY_STATS == 1 )
+
+    static void prvRecordLatency( TaskLatencyHistogram_t * const pxHistogram,
+                                  uint32_t ulValue )
+    {
+        uint32_t ulBucket, ulShift = 0UL, ulHigh;
+
+        if( ulValue >= ( ( uint32_t ) 1UL << configLATENCY_HISTOGRAM_RANGE_BITS ) )
+        {
+            ulBucket = ( uint32_t ) tskLATENCY_BUCKETS - 1UL;
+        }
+        else if( ulValue < tskLATENCY_SUB_BUCKETS )
+        {
+            ulBucket = ulValue;
+        }
+        else
+        {
+            /* ulShift is the position of the most significant bit of ulHigh,
+             * found by halving as the ARM7TDMI has no count leading zeros
+             * instruction.  ulValue >> ulShift then lies in
+             * [ tskLATENCY_SUB_BUCKETS, 2 * tskLATENCY_SUB_BUCKETS ). */
+            ulHigh = ulValue >> configLATENCY_HISTOGRAM_PRECISION_BITS;
+
+            if( ulHigh >= 0x10000UL )
+            {
+                ulHigh >>= 16;
+                ulShift += 16UL;
+            }
+
+            if( ulHigh >= 0x100UL )
+            {
+                ulHigh >>= 8;
+                ulShift += 8UL;
+            }
+
+            if( ulHigh >= 0x10UL )
+            {
+                ulHigh >>= 4;
+                ulShift += 4UL;
+            }
+
+            if( ulHigh >= 0x4UL )
+            {
+                ulHigh >>= 2;
+                ulShift += 2UL;
+            }
+
+            if( ulHigh >= 0x2UL )
+            {
+                ulShift += 1UL;
+            }
+
+            ulBucket = ( ( ulShift + 1UL ) << configLATENCY_HISTOGRAM_PRECISION_BITS ) + ( ( ulValue >> ulShift ) - tskLATENCY_SUB_BUCKETS );
+        }
+
+        ( pxHistogram->ulBuckets[ ulBucket ] )++;
+        ( pxHistogram->ulCount )++;
+
+        if( ulValue > pxHistogram->ulMax )
+        {
+            pxHistogram->ulMax = ulValue;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    /*-----------------------------------------------------------*/
+
+    void vTaskGetLatencyStats( TaskHandle_t xTask,
+                               TaskLatencyStats_t * pxStats,
+                               BaseType_t xReset )
+    {
+        TCB_t * pxTCB;
+
+        configASSERT( pxStats );
+
+        taskENTER_CRITICAL();
+        {
+            pxTCB = prvGetTCBFromHandle( xTask );
+            ( void ) memcpy( ( void * ) pxStats, ( void * ) &( pxTCB->xLatency ), sizeof( TaskLatencyStats_t ) );
+
+            if( xReset != pdFALSE )
+            {
+                ( void ) memset( ( void * ) &( pxTCB->xLatency.xResponseTime ), 0x00, sizeof( TaskLatencyHistogram_t ) );
+                ( void ) memset( ( void * ) &( pxTCB->xLatency.xStartJitter ), 0x00, sizeof( TaskLatencyHistogram_t ) );
+                pxTCB->xLatency.ulLateJobs = 0UL;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        taskEXIT_CRITICAL();
+    }
+    /*-----------------------------------------------------------*/
+
+    uint32_t ulTaskLatencyPercentile( const TaskLatencyHistogram_t * pxHistogram,
+                                      uint32_t ulPerMille )
+    {
+        uint32_t ulRank, ulSeen = 0UL, ulBucket, ulShift, ulReturn = 0UL;
+
+        configASSERT( pxHistogram );
+        configASSERT( ulPerMille <= 1000UL );
+
+        if( pxHistogram->ulCount > 0UL )
+        {
+            /* The rank of the percentile, rounded up, computed in two parts so
+             * ulCount * ulPerMille cannot overflow. */
+            ulRank = ( ( pxHistogram->ulCount / 1000UL ) * ulPerMille ) + ( ( ( ( pxHistogram->ulCount % 1000UL ) * ulPerMille ) + 999UL ) / 1000UL );
+
+            if( ulRank == 0UL )
+            {
+                ulRank = 1UL;
+            }
+
+            for( ulBucket = 0UL; ulBucket < ( uint32_t ) tskLATENCY_BUCKETS; ulBucket++ )
+            {
+                ulSeen += pxHistogram->ulBuckets[ ulBucket ];
+
+                if( ulSeen >= ulRank )
+                {
+                    break;
+                }
+            }
+
+            if( ulBucket < tskLATENCY_SUB_BUCKETS )
+            {
+                ulReturn = ulBucket;
+            }
+            else if( ulBucket < ( ( uint32_t ) tskLATENCY_BUCKETS - 1UL ) )
+            {
+                /* The inverse of prvRecordLatency(): the last value that maps
+                 * to the bucket. */
+                ulShift = ( ulBucket >> configLATENCY_HISTOGRAM_PRECISION_BITS ) - 1UL;
+                ulReturn = ( ( ( ulBucket & ( tskLATENCY_SUB_BUCKETS - 1UL ) ) + tskLATENCY_SUB_BUCKETS + 1UL ) << ulShift ) - 1UL;
+            }
+            else
+            {
+                /* The last bucket also holds the values above the range. */
+                ulReturn = pxHistogram->ulMax;
+            }
+
+            if( ulReturn > pxHistogram->ulMax )
+            {
+                ulReturn = pxHistogram->ulMax;
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return ulReturn;
+    }
+
+#endif /* configUSE_TASK_LATENCY_STATS */
+/*-----------------------------------------------------------*/
+
+#if ( ( configUSE_EDF_VD == 1 ) || ( configUSE_EDF_SLACK_STEALING == 1 ) || ( configUSE_EDF_HYBRID == 1 ) )
+
+    static void prvAddTaskToReadyListEDF( TCB_t * pxTCB )
+    {
+        #if ( configUSE_EDF_SLACK_STEALING == 1 )
+            if( pxTCB->xSlackTask != pdFALSE )
+            {
+                /* Slack tasks have no deadline and are served in FIFO order:
+                 * every hard job that wakes goes before them.  The slack is
+                 * not counted down while none is ready. */
+                listSET_LIST_ITEM_VALUE( &( pxTCB->xStateListItem ), portMAX_DELAY );
+                listINSERT_END( &xSlackReadyTasksList, &( pxTCB->xStateListItem ) );
+                xSlackStale = pdTRUE;
+            }
+            else
+        #endif
+        #if ( configUSE_EDF_HYBRID == 1 )
+            if( pxTCB->xTaskPeriod == ( TickType_t ) 0U )
+            {
+                /* Not a periodic task, so it is scheduled by its fixed
+                 * priority. */
+                taskRECORD_READY_PRIORITY( pxTCB->uxPriority );
+                listINSERT_END( &( pxReadyTasksLists[ pxTCB->uxPriority ] ), &( pxTCB->xStateListItem ) );
+                tracePOST_MOVED_TASK_TO_READY_STATE( pxTCB );
+            }
+            else
+        #endif
+        #if ( configUSE_EDF_VD == 1 )
+            if( ( uxCriticalityMode == tskCRITICALITY_HI ) && ( pxTCB->uxCriticality == tskCRITICALITY_LO ) )
+            {
+                /* LO tasks are not allowed to run while the system is in HI
+                 * mode. */
+                listINSERT_END( &xDroppedTasksListEDF, &( pxTCB->xStateListItem ) );
+            }
+            else
+        #endif
+        {
+            vListInsert( &( xReadyTasksListEDF ), &( pxTCB->xStateListItem ) );
+        }
+    }
+
+#endif /* ( configUSE_EDF_VD == 1 ) || ( configUSE_EDF_SLACK_STEALING == 1 ) || ( configUSE_EDF_HYBRID == 1 ) */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_EDF_HYBRID == 1 )
+
+    static BaseType_t prvEDFBandOnTop( void )
+    {
+        UBaseType_t uxPriority;
+        BaseType_t xReturn = pdTRUE;
+
+        if( ( listLIST_IS_EMPTY( &xReadyTasksListEDF ) != pdFALSE ) && ( prvSlackTaskSelectable() == pdFALSE ) )
+        {
+            xReturn = pdFALSE;
+        }
+        else
+        {
+            /* Only the few priorities above the band are checked, so the cost
+             * does not depend on the number of tasks. */
+            for( uxPriority = ( UBaseType_t ) configEDF_BAND_PRIORITY + ( UBaseType_t ) 1U; uxPriority < ( UBaseType_t ) configMAX_PRIORITIES; uxPriority++ )
+            {
+                if( listLIST_IS_EMPTY( &( pxReadyTasksLists[ uxPriority ] ) ) == pdFALSE )
+                {
+                    xReturn = pdFALSE;
+                    break;
+                }
+            }
+        }
+
+        return xReturn;
+    }
+
+#endif /* configUSE_EDF_HYBRID */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_EDF_SLACK_STEALING == 1 )
+
+    static TickType_t prvDemandBefore( TickType_t xTimeNow,
+                                       TickType_t xWindow )
+    {
+        const TCB_t * pxTCB;
+        TickType_t xDemand = ( TickType_t ) 0U;
+        TickType_t xRelease;
+
+        /* Processor time the hard jobs need before xTimeNow + xWindow: what
+         * is left of the current jobs due in the window, plus the WCET of
+         * every later job released and due in the window.  All the times are
+         * relative to xTimeNow. */
+        for( pxTCB = pxPeriodicTasks; pxTCB != NULL; pxTCB = pxTCB->pxNextPeriodicTCB )
+        {
+            if( ( pxTCB->xSlackTask != pdFALSE ) || ( pxTCB->xTaskWcet == ( TickType_t ) 0U ) )
+            {
+                continue;
+            }
+
+            if( ( pxTCB->xJobActive != pdFALSE ) &&
+                ( pxTCB->xJobExecTime < pxTCB->xTaskWcet ) &&
+                ( ( TickType_t ) ( pxTCB->xJobDeadline - xTimeNow ) <= xWindow ) )
+            {
+                xDemand += pxTCB->xTaskWcet - pxTCB->xJobExecTime;
+            }
+
+            xRelease = ( TickType_t ) ( pxTCB->xNextRelease - xTimeNow );
+
+            if( ( xRelease <= xWindow ) && ( ( xWindow - xRelease ) >= pxTCB->xTaskPeriod ) )
+            {
+                xDemand += ( ( ( xWindow - xRelease ) / pxTCB->xTaskPeriod ) * pxTCB->xTaskWcet );
+            }
+        }
+
+        return xDemand;
+    }
+    /*-----------------------------------------------------------*/
+
+    static TickType_t prvComputeSlack( TickType_t xTimeNow )
+    {
+        const TCB_t * pxTCB;
+        TickType_t xSlack = configEDF_SLACK_HORIZON;
+        TickType_t xDeadline, xDemand;
+
+        /* The slack is the smallest gap between a deadline and the demand due
+         * by that deadline.  The demand only steps up at deadlines, so only
+         * the deadlines inside the horizon need to be checked. */
+        for( pxTCB = pxPeriodicTasks; ( pxTCB != NULL ) && ( xSlack > ( TickType_t ) 0U ); pxTCB = pxTCB->pxNextPeriodicTCB )
+        {
+            if( ( pxTCB->xSlackTask != pdFALSE ) || ( pxTCB->xTaskWcet == ( TickType_t ) 0U ) )
+            {
+                continue;
+            }
+
+            if( pxTCB->xJobActive != pdFALSE )
+            {
+                xDeadline = ( TickType_t ) ( pxTCB->xJobDeadline - xTimeNow );
+
+                if( ( xDeadline == ( TickType_t ) 0U ) || ( xDeadline > ( portMAX_DELAY / ( TickType_t ) 2U ) ) )
+                {
+                    /* The job is at or past its deadline, nothing can be
+                     * given away until it completes. */
+                    xSlack = ( TickType_t ) 0U;
+                    break;
+                }
+            }
+            else
+            {
+                xDeadline = ( TickType_t ) ( pxTCB->xNextRelease - xTimeNow ) + pxTCB->xTaskPeriod;
+            }
+
+            for( ; ( xDeadline <= configEDF_SLACK_HORIZON ) && ( xSlack > ( TickType_t ) 0U ); xDeadline += pxTCB->xTaskPeriod )
+            {
+                xDemand = prvDemandBefore( xTimeNow, xDeadline );
+
+                if( xDemand >= xDeadline )
+                {
+                    xSlack = ( TickType_t ) 0U;
+                }
+                else if( ( xDeadline - xDemand ) < xSlack )
+                {
+                    xSlack = xDeadline - xDemand;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+        }
+
+        return xSlack;
     }
+    /*-----------------------------------------------------------*/
 
-#endif /* ( ( configUSE_TRACE_FACILITY == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark2 == 1 ) ) */
-/*-----------------------------------------------------------*/
+    void vTaskSetWcet( TaskHandle_t xTask,
+                       TickType_t xWcet )
+    {
+        TCB_t * pxTCB;
 
-#if ( INCLUDE_uxTaskGetStackHighWaterMark2 == 1 )
+        taskENTER_CRITICAL();
+        {
+            pxTCB = prvGetTCBFromHandle( xTask );
+            pxTCB->xTaskWcet = xWcet;
+            xSlackStale = pdTRUE;
+        }
+        taskEXIT_CRITICAL();
+    }
+    /*-----------------------------------------------------------*/
 
-/* uxTaskGetStackHighWaterMark() and uxTaskGetStackHighWaterMark2() are the
- * same except for their return type.  Using configSTACK_DEPTH_TYPE allows the
- * user to determine the return type.  It gets around the problem of the value
- * overflowing on 8-bit types without breaking backward compatibility for
- * applications that expect an 8-bit return type. */
-    configSTACK_DEPTH_TYPE uxTaskGetStackHighWaterMark2( TaskHandle_t xTask )
+    #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+    BaseType_t xTaskRunInSlack( TaskFunction_t pxTaskCode,
+                                const char * const pcName, /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+                                const configSTACK_DEPTH_TYPE usStackDepth,
+                                void * const pvParameters,
+                                TaskHandle_t * const pxCreatedTask )
     {
+        TaskHandle_t xHandle = NULL;
         TCB_t * pxTCB;
-        uint8_t * pucEndOfStack;
-        configSTACK_DEPTH_TYPE uxReturn;
+        BaseType_t xReturn;
 
-        /* uxTaskGetStackHighWaterMark() and uxTaskGetStackHighWaterMark2() are
-         * the same except for their return type.  Using configSTACK_DEPTH_TYPE
-         * allows the user to determine the return type.  It gets around the
-         * problem of the value overflowing on 8-bit types without breaking
-         * backward compatibility for applications that expect an 8-bit return
-         * type. */
+        /* The task is created as an aperiodic task, with no job deadline and
+         * out of the slack computation, then moved to the slack class before
+         * the scheduler can select it. */
+        vTaskSuspendAll();
+        {
+            xReturn = xTaskCreate( pxTaskCode, pcName, usStackDepth, pvParameters, tskIDLE_PRIORITY, &xHandle );
 
-        pxTCB = prvGetTCBFromHandle( xTask );
+            if( xReturn == pdPASS )
+            {
+                pxTCB = xHandle;
 
-        #if portSTACK_GROWTH < 0
-        {
-            pucEndOfStack = ( uint8_t * ) pxTCB->pxStack;
-        }
-        #else
-        {
-            pucEndOfStack = ( uint8_t * ) pxTCB->pxEndOfStack;
+                taskENTER_CRITICAL();
+                {
+                    if( uxListRemove( &( pxTCB->xStateListItem ) ) == ( UBaseType_t ) 0 )
+                    {
+                        taskRESET_READY_PRIORITY( pxTCB->uxPriority );
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    pxTCB->xSlackTask = pdTRUE;
+                    prvAddTaskToReadyList( pxTCB );
+
+                    /* Before the scheduler starts the current task is the one
+                     * it starts with, which is not to be a slack task. */
+                    if( ( xSchedulerRunning == pdFALSE ) && ( pxCurrentTCB == pxTCB ) &&
+                        ( listLIST_IS_EMPTY( &xReadyTasksListEDF ) == pdFALSE ) )
+                    {
+                        pxCurrentTCB = listGET_OWNER_OF_HEAD_ENTRY( &xReadyTasksListEDF ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                taskEXIT_CRITICAL();
+
+                if( pxCreatedTask != NULL )
+                {
+                    *pxCreatedTask = xHandle;
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
         }
-        #endif
+        ( void ) xTaskResumeAll();
 
-        uxReturn = prvTaskCheckFreeStackSpace( pucEndOfStack );
+        return xReturn;
+    }
 
-        return uxReturn;
+    #endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+    /*-----------------------------------------------------------*/
+
+    TickType_t xTaskGetAvailableSlack( void )
+    {
+        return xAvailableSlack;
     }
 
-#endif /* INCLUDE_uxTaskGetStackHighWaterMark2 */
+#endif /* configUSE_EDF_SLACK_STEALING */
 /*-----------------------------------------------------------*/
 
-#if ( INCLUDE_uxTaskGetStackHighWaterMark == 1 )
+#if ( configUSE_EDF_SCHEDULER == 1 )
 
-    UBaseType_t uxTaskGetStackHighWaterMark( TaskHandle_t xTask )
+    static BaseType_t prvNonPreemptiveWindowFits( const TickType_t * pxPeriods,
+                                                  const TickType_t * pxWcets,
+                                                  UBaseType_t uxNumberOfTasks,
+                                                  UBaseType_t uxTask,
+                                                  TickType_t xL )
     {
-        TCB_t * pxTCB;
-        uint8_t * pucEndOfStack;
-        UBaseType_t uxReturn;
+        TickType_t xDemand = pxWcets[ uxTask ];
+        UBaseType_t uxOther;
 
-        pxTCB = prvGetTCBFromHandle( xTask );
-
-        #if portSTACK_GROWTH < 0
-        {
-            pucEndOfStack = ( uint8_t * ) pxTCB->pxStack;
-        }
-        #else
+        /* A job of task uxTask released at the start of the window can be
+         * blocked by a job already started, then has to wait for the jobs of
+         * the tasks with shorter periods released in the window. */
+        for( uxOther = 0U; uxOther < uxNumberOfTasks; uxOther++ )
         {
-            pucEndOfStack = ( uint8_t * ) pxTCB->pxEndOfStack;
+            if( pxPeriods[ uxOther ] < pxPeriods[ uxTask ] )
+            {
+                xDemand += ( ( xL - ( TickType_t ) 1U ) / pxPeriods[ uxOther ] ) * pxWcets[ uxOther ];
+            }
         }
-        #endif
-
-        uxReturn = ( UBaseType_t ) prvTaskCheckFreeStackSpace( pucEndOfStack );
 
-        return uxReturn;
+        return ( xL >= xDemand ) ? pdTRUE : pdFALSE;
     }
+    /*-----------------------------------------------------------*/
 
-#endif /* INCLUDE_uxTaskGetStackHighWaterMark */
-/*-----------------------------------------------------------*/
-
-#if ( INCLUDE_vTaskDelete == 1 )
-
-    static void prvDeleteTCB( TCB_t * pxTCB )
+    BaseType_t xTaskCheckNonPreemptiveSchedulability( const TickType_t * pxPeriods,
+                                                      const TickType_t * pxWcets,
+                                                      UBaseType_t uxNumberOfTasks )
     {
-        /* This call is required specifically for the TriCore port.  It must be
-         * above the vPortFree() calls.  The call is also used by ports/demos that
-         * want to allocate and clean RAM statically. */
-        portCLEAN_UP_TCB( pxTCB );
+        BaseType_t xReturn = pdTRUE;
+        UBaseType_t uxTask, uxOther;
+        TickType_t xShortestPeriod = portMAX_DELAY;
+        TickType_t xL;
+        uint32_t ulUtilisation = 0UL;
 
-        #if ( ( configUSE_NEWLIB_REENTRANT == 1 ) || ( configUSE_C_RUNTIME_TLS_SUPPORT == 1 ) )
+        configASSERT( pxPeriods );
+        configASSERT( pxWcets );
+
+        /* Condition 1: the utilisation must not exceed 1.  It is summed in
+         * per mille, rounded up. */
+        for( uxTask = 0U; uxTask < uxNumberOfTasks; uxTask++ )
         {
-            /* Free up the memory allocated for the task's TLS Block. */
-            configDEINIT_TLS_BLOCK( pxCurrentTCB->xTLSBlock );
+            configASSERT( pxPeriods[ uxTask ] > ( TickType_t ) 0U );
+            ulUtilisation += ( uint32_t ) ( ( ( pxWcets[ uxTask ] * 1000UL ) + pxPeriods[ uxTask ] - 1UL ) / pxPeriods[ uxTask ] );
+
+            if( pxPeriods[ uxTask ] < xShortestPeriod )
+            {
+                xShortestPeriod = pxPeriods[ uxTask ];
+            }
         }
-        #endif
 
-        #if ( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) && ( portUSING_MPU_WRAPPERS == 0 ) )
+        if( ulUtilisation > 1000UL )
         {
-            /* The task can only have been allocated dynamically - free both
-             * the stack and TCB. */
-            vPortFreeStack( pxTCB->pxStack );
-            vPortFree( pxTCB );
+            xReturn = pdFALSE;
         }
-        #elif ( tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE != 0 ) /*lint !e731 !e9029 Macro has been consolidated for readability reasons. */
+
+        /* Condition 2, for every window P1 < L < Pi.  The demand only grows at
+         * L = k * Pj + 1, so L - demand is smallest just above P1 or at one of
+         * those steps, and only these points are checked. */
+        for( uxTask = 0U; ( uxTask < uxNumberOfTasks ) && ( xReturn != pdFALSE ); uxTask++ )
         {
-            /* The task could have been allocated statically or dynamically, so
-             * check what was statically allocated before trying to free the
-             * memory. */
-            if( pxTCB->ucStaticallyAllocated == tskDYNAMICALLY_ALLOCATED_STACK_AND_TCB )
-            {
-                /* Both the stack and TCB were allocated dynamically, so both
-                 * must be freed. */
-                vPortFreeStack( pxTCB->pxStack );
-                vPortFree( pxTCB );
-            }
-            else if( pxTCB->ucStaticallyAllocated == tskSTATICALLY_ALLOCATED_STACK_ONLY )
+            xL = xShortestPeriod + ( TickType_t ) 1U;
+
+            if( xL < pxPeriods[ uxTask ] )
             {
-                /* Only the stack was statically allocated, so the TCB is the
-                 * only memory that must be freed. */
-                vPortFree( pxTCB );
+                xReturn = prvNonPreemptiveWindowFits( pxPeriods, pxWcets, uxNumberOfTasks, uxTask, xL );
             }
-            else
+
+            for( uxOther = 0U; ( uxOther < uxNumberOfTasks ) && ( xReturn != pdFALSE ); uxOther++ )
             {
-                /* Neither the stack nor the TCB were allocated dynamically, so
-                 * nothing needs to be freed. */
-                configASSERT( pxTCB->ucStaticallyAllocated == tskSTATICALLY_ALLOCATED_STACK_AND_TCB );
-                mtCOVERAGE_TEST_MARKER();
+                if( pxPeriods[ uxOther ] < pxPeriods[ uxTask ] )
+                {
+                    for( xL = pxPeriods[ uxOther ] + ( TickType_t ) 1U; ( xL < pxPeriods[ uxTask ] ) && ( xReturn != pdFALSE ); xL += pxPeriods[ uxOther ] )
+                    {
+                        if( xL > xShortestPeriod )
+                        {
+                            xReturn = prvNonPreemptiveWindowFits( pxPeriods, pxWcets, uxNumberOfTasks, uxTask, xL );
+                        }
+                    }
+                }
             }
         }
-        #endif /* configSUPPORT_DYNAMIC_ALLOCATION */
-    }
-
-#endif /* INCLUDE_vTaskDelete */
-/*-----------------------------------------------------------*/
 
-static void prvResetNextTaskUnblockTime( void )
-{
-    if( listLIST_IS_EMPTY( pxDelayedTaskList ) != pdFALSE )
-    {
-        /* The new current delayed list is empty.  Set xNextTaskUnblockTime to
-         * the maximum possible value so it is  extremely unlikely that the
-         * if( xTickCount >= xNextTaskUnblockTime ) test will pass until
-         * there is an item in the delayed list. */
-        xNextTaskUnblockTime = portMAX_DELAY;
-    }
-    else
-    {
-        /* The new current delayed list is not empty, get the value of
-         * the item at the head of the delayed list.  This is the time at
-         * which the task at the head of the delayed list should be removed
-         * from the Blocked state. */
-        xNextTaskUnblockTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxDelayedTaskList );
+        return xReturn;
     }
-}
+
+#endif /* configUSE_EDF_SCHEDULER */
 /*-----------------------------------------------------------*/
 
 #if ( ( INCLUDE_xTaskGetCurrentTaskHandle == 1 ) || ( configUSE_MUTEXES == 1 ) )
@@ -4813,6 +7125,131 @@ static void prvResetNextTaskUnblockTime( void )
 #endif /* ( ( configGENERATE_RUN_TIME_STATS == 1 ) && ( configUSE_STATS_FORMATTING_FUNCTIONS > 0 ) ) */
 /*-----------------------------------------------------------*/
 
+#if ( ( configUSE_TASK_LATENCY_STATS == 1 ) && ( configUSE_STATS_FORMATTING_FUNCTIONS > 0 ) && ( configUSE_TRACE_FACILITY == 1 ) )
+
+    static uint32_t prvRunTimeToMicroseconds( uint32_t ulCounts )
+    {
+        return ( uint32_t ) ( ( ( uint64_t ) ulCounts * 1000000ULL ) / ( uint64_t ) configRUN_TIME_COUNTER_HZ );
+    }
+    /*-----------------------------------------------------------*/
+
+    static char * prvWriteLatencyHistogram( char * pcBuffer,
+                                            const TaskLatencyHistogram_t * pxHistogram )
+    {
+        uint32_t ulP50, ulP99, ulP999, ulMax;
+
+        ulP50 = prvRunTimeToMicroseconds( ulTaskLatencyPercentile( pxHistogram, 500UL ) );
+        ulP99 = prvRunTimeToMicroseconds( ulTaskLatencyPercentile( pxHistogram, 990UL ) );
+        ulP999 = prvRunTimeToMicroseconds( ulTaskLatencyPercentile( pxHistogram, 999UL ) );
+        ulMax = prvRunTimeToMicroseconds( pxHistogram->ulMax );
+
+        #ifdef portLU_PRINTF_SPECIFIER_REQUIRED
+        {
+            sprintf( pcBuffer, "\t%lu\t%lu\t%lu\t%lu", ulP50, ulP99, ulP999, ulMax );
+        }
+        #else
+        {
+            /* sizeof( int ) == sizeof( long ) so a smaller
+             * printf() library can be used. */
+            sprintf( pcBuffer, "\t%u\t%u\t%u\t%u", ( unsigned int ) ulP50, ( unsigned int ) ulP99, ( unsigned int ) ulP999, ( unsigned int ) ulMax ); /*lint !e586 sprintf() allowed as this is compiled with many compilers and this is a utility function only - not part of the core kernel implementation. */
+        }
+        #endif
+
+        return pcBuffer + strlen( pcBuffer );
+    }
+    /*-----------------------------------------------------------*/
+
+    void vTaskGetLatencyReport( char * pcWriteBuffer,
+                                BaseType_t xReset )
+    {
+        TaskStatus_t * pxTaskStatusArray;
+        TaskLatencyStats_t * pxStats;
+        UBaseType_t uxArraySize, x;
+        int32_t lLateness;
+
+        /*
+         * PLEASE NOTE:
+         *
+         * This function is provided for convenience only, like
+         * vTaskGetRunTimeStats().  It calls uxTaskGetSystemState() for the
+         * tasks, then vTaskGetLatencyStats() for each of them, and formats
+         * the percentiles of their histograms into a human readable table.
+         * Production systems should call vTaskGetLatencyStats() and
+         * ulTaskLatencyPercentile() directly.
+         */
+
+        /* Make sure the write buffer does not contain a string. */
+        *pcWriteBuffer = ( char ) 0x00;
+
+        /* Take a snapshot of the number of tasks in case it changes while this
+         * function is executing. */
+        uxArraySize = uxCurrentNumberOfTasks;
+
+        /* The statistics of a task are too large for the stack of most tasks,
+         * so they are allocated with the status array.  NOTE!  If
+         * configSUPPORT_DYNAMIC_ALLOCATION is set to 0 then pvPortMalloc()
+         * will equate to NULL. */
+        pxTaskStatusArray = pvPortMalloc( uxCurrentNumberOfTasks * sizeof( TaskStatus_t ) ); /*lint !e9079 All values returned by pvPortMalloc() have at least the alignment required by the MCU's stack and this allocation allocates a struct that has the alignment requirements of a pointer. */
+        pxStats = pvPortMalloc( sizeof( TaskLatencyStats_t ) ); /*lint !e9079 As above. */
+
+        if( ( pxTaskStatusArray != NULL ) && ( pxStats != NULL ) )
+        {
+            uxArraySize = uxTaskGetSystemState( pxTaskStatusArray, uxArraySize, NULL );
+
+            sprintf( pcWriteBuffer, "Task\tjobs\tlate\tRT p50\tp99\tp99.9\tmax\tSJ p50\tp99\tp99.9\tmax\tlateness (us)\r\n" ); /*lint !e586 sprintf() allowed as this is compiled with many compilers and this is a utility function only - not part of the core kernel implementation. */
+            pcWriteBuffer += strlen( pcWriteBuffer ); /*lint !e9016 Pointer arithmetic ok on char pointers especially as in this case where it best denotes the intent of the code. */
+
+            for( x = 0; x < uxArraySize; x++ )
+            {
+                vTaskGetLatencyStats( pxTaskStatusArray[ x ].xHandle, pxStats, xReset );
+
+                if( pxStats->xResponseTime.ulCount > 0UL )
+                {
+                    pcWriteBuffer = prvWriteNameToBuffer( pcWriteBuffer, pxTaskStatusArray[ x ].pcTaskName );
+
+                    #ifdef portLU_PRINTF_SPECIFIER_REQUIRED
+                    {
+                        sprintf( pcWriteBuffer, "\t%lu\t%lu", pxStats->xResponseTime.ulCount, pxStats->ulLateJobs );
+                    }
+                    #else
+                    {
+                        /* sizeof( int ) == sizeof( long ) so a smaller
+                         * printf() library can be used. */
+                        sprintf( pcWriteBuffer, "\t%u\t%u", ( unsigned int ) pxStats->xResponseTime.ulCount, ( unsigned int ) pxStats->ulLateJobs ); /*lint !e586 sprintf() allowed as this is compiled with many compilers and this is a utility function only - not part of the core kernel implementation. */
+                    }
+                    #endif
+                    pcWriteBuffer += strlen( pcWriteBuffer ); /*lint !e9016 Pointer arithmetic ok on char pointers especially as in this case where it best denotes the intent of the code. */
+
+                    pcWriteBuffer = prvWriteLatencyHistogram( pcWriteBuffer, &( pxStats->xResponseTime ) );
+                    pcWriteBuffer = prvWriteLatencyHistogram( pcWriteBuffer, &( pxStats->xStartJitter ) );
+
+                    /* The lateness is the response time minus the deadline, so
+                     * its distribution is the response time histogram shifted
+                     * by ulDeadline and only its maximum is printed. */
+                    lLateness = ( int32_t ) prvRunTimeToMicroseconds( pxStats->xResponseTime.ulMax ) - ( int32_t ) prvRunTimeToMicroseconds( pxStats->ulDeadline );
+                    sprintf( pcWriteBuffer, "\t%d\r\n", ( int ) lLateness ); /*lint !e586 sprintf() allowed as this is compiled with many compilers and this is a utility function only - not part of the core kernel implementation. */
+                    pcWriteBuffer += strlen( pcWriteBuffer ); /*lint !e9016 Pointer arithmetic ok on char pointers especially as in this case where it best denotes the intent of the code. */
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        /* Free the arrays again.  NOTE!  If configSUPPORT_DYNAMIC_ALLOCATION
+         * is 0 then vPortFree() will be #defined to nothing. */
+        vPortFree( pxStats );
+        vPortFree( pxTaskStatusArray );
+    }
+
+#endif /* ( ( configUSE_TASK_LATENCY_STATS == 1 ) && ( configUSE_STATS_FORMATTING_FUNCTIONS > 0 ) && ( configUSE_TRACE_FACILITY == 1 ) ) */
+/*-----------------------------------------------------------*/
+
 TickType_t uxTaskResetEventItemValue( void )
 {
     TickType_t uxReturn;
@@ -4820,8 +7257,13 @@ TickType_t uxTaskResetEventItemValue( void )
     uxReturn = listGET_LIST_ITEM_VALUE( &( pxCurrentTCB->xEventListItem ) );
 
     /* Reset the event list item to its normal value - so it can be used with
-     * queues and semaphores. */
-    listSET_LIST_ITEM_VALUE( &( pxCurrentTCB->xEventListItem ), ( ( TickType_t ) configMAX_PRIORITIES - ( TickType_t ) pxCurrentTCB->uxPriority ) ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+     * queues and semaphores.  In the lean EDF build the value is set when the
+     * task is placed in an event list. */
+    #if ( configUSE_EDF_LEAN == 0 )
+    {
+        listSET_LIST_ITEM_VALUE( &( pxCurrentTCB->xEventListItem ), ( ( TickType_t ) configMAX_PRIORITIES - ( TickType_t ) pxCurrentTCB->uxPriority ) ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+    }
+    #endif
 
     return uxReturn;
 }
@@ -5080,6 +7522,7 @@ TickType_t uxTaskResetEventItemValue( void )
             if( ucOriginalNotifyState == taskWAITING_NOTIFICATION )
             {
                 listREMOVE_ITEM( &( pxTCB->xStateListItem ) );
+                prvRestoreJobDeadline( pxTCB );
                 prvAddTaskToReadyList( pxTCB );
 
                 /* The task should not have been on an event list. */
@@ -5101,7 +7544,7 @@ TickType_t uxTaskResetEventItemValue( void )
                 }
                 #endif
 
-                if( pxTCB->uxPriority > pxCurrentTCB->uxPriority )
+                if( taskPREEMPTS_CURRENT( pxTCB ) )
                 {
                     /* The notified task has a priority above the currently
                      * executing task so a yield is required. */
@@ -5227,6 +7670,7 @@ TickType_t uxTaskResetEventItemValue( void )
                 if( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE )
                 {
                     listREMOVE_ITEM( &( pxTCB->xStateListItem ) );
+                    prvRestoreJobDeadline( pxTCB );
                     prvAddTaskToReadyList( pxTCB );
                 }
                 else
@@ -5236,7 +7680,7 @@ TickType_t uxTaskResetEventItemValue( void )
                     listINSERT_END( &( xPendingReadyList ), &( pxTCB->xEventListItem ) );
                 }
 
-                if( pxTCB->uxPriority > pxCurrentTCB->uxPriority )
+                if( taskPREEMPTS_CURRENT( pxTCB ) )
                 {
                     /* The notified task has a priority above the currently
                      * executing task so a yield is required. */
@@ -5318,6 +7762,7 @@ TickType_t uxTaskResetEventItemValue( void )
                 if( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE )
                 {
                     listREMOVE_ITEM( &( pxTCB->xStateListItem ) );
+                    prvRestoreJobDeadline( pxTCB );
                     prvAddTaskToReadyList( pxTCB );
                 }
                 else
@@ -5327,7 +7772,7 @@ TickType_t uxTaskResetEventItemValue( void )
                     listINSERT_END( &( xPendingReadyList ), &( pxTCB->xEventListItem ) );
                 }
 
-                if( pxTCB->uxPriority > pxCurrentTCB->uxPriority )
+                if( taskPREEMPTS_CURRENT( pxTCB ) )
                 {
                     /* The notified task has a priority above the currently
                      * executing task so a yield is required. */
@@ -5415,6 +7860,20 @@ TickType_t uxTaskResetEventItemValue( void )
 #endif /* configUSE_TASK_NOTIFICATIONS */
 /*-----------------------------------------------------------*/
 
+#if ( configGENERATE_RUN_TIME_STATS == 1 )
+
+    configRUN_TIME_COUNTER_TYPE ulTaskGetRunTimeCounter( const TaskHandle_t xTask )
+    {
+        const TCB_t * pxTCB;
+
+        pxTCB = prvGetTCBFromHandle( xTask );
+
+        return pxTCB->ulRunTimeCounter;
+    }
+
+#endif
+/*-----------------------------------------------------------*/
+
 #if ( ( configGENERATE_RUN_TIME_STATS == 1 ) && ( INCLUDE_xTaskGetIdleTaskHandle == 1 ) )
 
     configRUN_TIME_COUNTER_TYPE ulTaskGetIdleRunTimeCounter( void )
@@ -5469,16 +7928,24 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
 
     /* Remove the task from the ready list before adding it to the blocked list
      * as the same list item is used for both lists. */
-    if( uxListRemove( &( pxCurrentTCB->xStateListItem ) ) == ( UBaseType_t ) 0 )
+    #if ( configUSE_EDF_LEAN == 0 )
     {
-        /* The current task must be in a ready list, so there is no need to
-         * check, and the port reset macro can be called directly. */
-        portRESET_READY_PRIORITY( pxCurrentTCB->uxPriority, uxTopReadyPriority ); /*lint !e931 pxCurrentTCB cannot change as it is the calling task.  pxCurrentTCB->uxPriority and uxTopReadyPriority cannot change as called with scheduler suspended or in a critical section. */
+        if( uxListRemove( &( pxCurrentTCB->xStateListItem ) ) == ( UBaseType_t ) 0 )
+        {
+            /* The current task must be in a ready list, so there is no need to
+             * check, and the port reset macro can be called directly. */
+            portRESET_READY_PRIORITY( pxCurrentTCB->uxPriority, uxTopReadyPriority ); /*lint !e931 pxCurrentTCB cannot change as it is the calling task.  pxCurrentTCB->uxPriority and uxTopReadyPriority cannot change as called with scheduler suspended or in a critical section. */
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
     }
-    else
+    #else
     {
-        mtCOVERAGE_TEST_MARKER();
+        ( void ) uxListRemove( &( pxCurrentTCB->xStateListItem ) );
     }
+    #endif /* configUSE_EDF_LEAN */
 
     #if ( INCLUDE_vTaskSuspend == 1 )
     {
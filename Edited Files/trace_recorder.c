@@ -0,0 +1,57 @@
+/*
+ * Binary scheduling trace recorder, see trace_recorder.h.
+ */
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+#if ( configUSE_TRACE_RECORDER == 1 )
+
+TraceRecorder_t xTraceRecorder =
+{
+    traceRECORDER_MAGIC,
+    traceRECORDER_VERSION,
+    configTRACE_RECORDER_EVENTS,
+    configTRACE_RECORDER_TIMER_HZ,
+    configTICK_RATE_HZ,
+    0UL,
+    { { 0UL, 0U, 0U, 0U } }
+};
+
+void vTraceRecordTaskCreate( uint8_t ucTask,
+                             uint16_t usPeriod,
+                             const char * pcName )
+{
+    uint32_t ulChars;
+    uint16_t usOffset, x = 4U;
+
+    traceRECORD( traceEVT_TASK_CREATE, ucTask, usPeriod );
+
+    /* The name follows in events of 4 characters, the last one padded with
+     * zeros.  A chunk shorter than 4 characters ends the name. */
+    for( usOffset = 0U; ( x == 4U ) && ( usOffset < ( uint16_t ) configMAX_TASK_NAME_LEN ) && ( pcName[ usOffset ] != '\0' ); usOffset += 4U )
+    {
+        ulChars = 0UL;
+
+        for( x = 0U; ( x < 4U ) && ( ( usOffset + x ) < ( uint16_t ) configMAX_TASK_NAME_LEN ) && ( pcName[ usOffset + x ] != '\0' ); x++ )
+        {
+            ulChars |= ( ( uint32_t ) ( uint8_t ) pcName[ usOffset + x ] ) << ( 8U * x );
+        }
+
+        {
+            /* As traceRECORD(), with the characters in place of the
+             * timestamp. */
+            uint32_t ulSlot = xTraceRecorder.ulHead;
+            TraceEvent_t * const pxEvent = &( xTraceRecorder.xEvents[ ulSlot & ( configTRACE_RECORDER_EVENTS - 1U ) ] );
+
+            pxEvent->ulTimestamp = ulChars;
+            pxEvent->ucType = ( uint8_t ) traceEVT_TASK_NAME;
+            pxEvent->ucObject = ucTask;
+            pxEvent->usArg = usOffset;
+            xTraceRecorder.ulHead = ulSlot + 1U;
+        }
+    }
+}
+
+#endif /* configUSE_TRACE_RECORDER */
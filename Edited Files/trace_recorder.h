@@ -0,0 +1,103 @@
+/*
+ * Binary scheduling trace recorder.
+ *
+ * Scheduling events are written to a ring buffer in RAM by the trace hooks
+ * defined in FreeRTOSConfig.h.  Each event is 8 bytes: a timer timestamp, the
+ * event type, the task or queue number and a 16 bit argument.  Recording an
+ * event is a handful of loads and stores: there is no lock, no allocation and
+ * no call.
+ *
+ * The buffer is not locked because every hook that records an event already
+ * runs with interrupts disabled on this port: the context switch, the tick,
+ * task creation and the queue operations all record from inside the kernel's
+ * own critical sections or from the IRQ handler.  Do not call traceRECORD()
+ * from anywhere else.
+ *
+ * To read the trace, halt the target and save xTraceRecorder, for example from
+ * the Keil command window:
+ *
+ *     SAVE trace.hex &xTraceRecorder, ((char *)&xTraceRecorder) + sizeof(xTraceRecorder) - 1
+ *
+ * then decode it on the host with Host_Tools/trace_decode.py.
+ */
+
+#ifndef TRACE_RECORDER_H
+#define TRACE_RECORDER_H
+
+#include <stdint.h>
+
+#ifndef configUSE_TRACE_RECORDER
+    #define configUSE_TRACE_RECORDER    0
+#endif
+
+#ifndef configTRACE_RECORDER_EVENTS
+    #define configTRACE_RECORDER_EVENTS    64
+#endif
+
+#if ( ( configTRACE_RECORDER_EVENTS & ( configTRACE_RECORDER_EVENTS - 1 ) ) != 0 )
+    #error configTRACE_RECORDER_EVENTS must be a power of 2
+#endif
+
+/* Identifies a dump of xTraceRecorder, "EDFT" in little endian. */
+#define traceRECORDER_MAGIC      ( 0x54464445UL )
+#define traceRECORDER_VERSION    ( 1U )
+
+/* Event types.  The meaning of ucObject and usArg for each type is given in
+ * the comment. */
+#define traceEVT_SWITCH_IN         ( 1U ) /* Task, unused. */
+#define traceEVT_SWITCH_OUT        ( 2U ) /* Task, 1 if the task is still ready (preempted), 0 if it blocked, completed its job or was deleted. */
+#define traceEVT_RELEASE           ( 3U ) /* Task, relative deadline of the new job in ticks. */
+#define traceEVT_DEADLINE_MISS     ( 4U ) /* Task, unused. */
+#define traceEVT_QUEUE_SEND        ( 5U ) /* Queue, messages waiting after the send. */
+#define traceEVT_QUEUE_RECEIVE     ( 6U ) /* Queue, messages waiting after the receive. */
+#define traceEVT_TASK_CREATE       ( 7U ) /* Task, period in ticks, 0 for a task that is not periodic. */
+#define traceEVT_TASK_NAME         ( 8U ) /* Task, offset in the name of the 4 characters held in ulTimestamp. */
+
+typedef struct xTRACE_EVENT
+{
+    uint32_t ulTimestamp;
+    uint8_t ucType;
+    uint8_t ucObject;
+    uint16_t usArg;
+} TraceEvent_t;
+
+typedef struct xTRACE_RECORDER
+{
+    uint32_t ulMagic;
+    uint16_t usVersion;
+    uint16_t usEvents;          /*< Size of xEvents. */
+    uint32_t ulTimerHz;         /*< Frequency of the timestamps. */
+    uint32_t ulTickHz;          /*< Frequency of the RTOS tick. */
+    volatile uint32_t ulHead;   /*< Number of events recorded since reset, the buffer holds the last usEvents. */
+    TraceEvent_t xEvents[ configTRACE_RECORDER_EVENTS ];
+} TraceRecorder_t;
+
+#if ( configUSE_TRACE_RECORDER == 1 )
+
+extern TraceRecorder_t xTraceRecorder;
+
+#define traceRECORD( uxType, uxObject, uxArg )                                                                              \
+    do {                                                                                                                    \
+        uint32_t ulTraceSlot = xTraceRecorder.ulHead;                                                                       \
+        TraceEvent_t * const pxTraceEvent = &( xTraceRecorder.xEvents[ ulTraceSlot & ( configTRACE_RECORDER_EVENTS - 1U ) ] ); \
+        pxTraceEvent->ulTimestamp = ( uint32_t ) configTRACE_RECORDER_TIMESTAMP();                                          \
+        pxTraceEvent->ucType = ( uint8_t ) ( uxType );                                                                      \
+        pxTraceEvent->ucObject = ( uint8_t ) ( uxObject );                                                                  \
+        pxTraceEvent->usArg = ( uint16_t ) ( uxArg );                                                                       \
+        xTraceRecorder.ulHead = ulTraceSlot + 1U;                                                                           \
+    } while( 0 )
+
+/* Records the creation of a task followed by its name.  Not on a hot path, so
+ * this one is a function. */
+void vTraceRecordTaskCreate( uint8_t ucTask,
+                             uint16_t usPeriod,
+                             const char * pcName );
+
+#else /* configUSE_TRACE_RECORDER */
+
+#define traceRECORD( uxType, uxObject, uxArg )
+#define vTraceRecordTaskCreate( ucTask, usPeriod, pcName )
+
+#endif /* configUSE_TRACE_RECORDER */
+
+#endif /* TRACE_RECORDER_H */
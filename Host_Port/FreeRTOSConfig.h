@@ -0,0 +1,99 @@
+/*
+ * FreeRTOS configuration of the host builds in Host_Port.
+ *
+ * The kernel options follow Edited Files/FreeRTOSConfig.h.  The target
+ * specific parts are left out: the timer 1 counter, the trace pins and the
+ * trace recorder.  The EDF options can be overridden from the make command
+ * line, for example:
+ *
+ *     make bench CONFIG="-DconfigUSE_EDF_NON_PREEMPTIVE=1"
+ */
+
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+/* EDF Configuration */
+#ifndef configUSE_EDF_SCHEDULER
+    #define configUSE_EDF_SCHEDULER 1
+#endif
+#ifndef configUSE_EDF_VD
+    #define configUSE_EDF_VD 0
+#endif
+#ifndef configUSE_EDF_LIMITED_PREEMPTION
+    #define configUSE_EDF_LIMITED_PREEMPTION 0
+#endif
+#ifndef configUSE_EDF_NON_PREEMPTIVE
+    #define configUSE_EDF_NON_PREEMPTIVE 0
+#endif
+#ifndef configUSE_EDF_SLACK_STEALING
+    #define configUSE_EDF_SLACK_STEALING 0
+#endif
+#ifndef configEDF_SLACK_HORIZON
+    #define configEDF_SLACK_HORIZON 100
+#endif
+#ifndef configUSE_EDF_HYBRID
+    #define configUSE_EDF_HYBRID 0
+#endif
+#ifndef configEDF_BAND_PRIORITY
+    #define configEDF_BAND_PRIORITY 2
+#endif
+#ifndef configUSE_EDF_LEAN
+    #define configUSE_EDF_LEAN 0
+#endif
+/****************************************/
+#ifndef configSUPPORT_DYNAMIC_ALLOCATION
+    #define configSUPPORT_DYNAMIC_ALLOCATION 1
+#endif
+/* The idle task in the memory of idle_memory.c. */
+#ifndef configSUPPORT_STATIC_ALLOCATION
+    #define configSUPPORT_STATIC_ALLOCATION 0
+#endif
+/****************************************/
+
+
+#define configUSE_PREEMPTION		1
+#define configUSE_IDLE_HOOK			0
+#define configUSE_TICK_HOOK			0
+#define configCPU_CLOCK_HZ			( ( unsigned long ) 60000000 )
+#define configTICK_RATE_HZ			( ( TickType_t ) 1000 )
+#define configMAX_PRIORITIES		( 4 )
+#define configMINIMAL_STACK_SIZE	( ( unsigned short ) 128 )
+#define configTOTAL_HEAP_SIZE		( ( size_t ) 4 * 1024 * 1024 )
+#define configMAX_TASK_NAME_LEN		( 8 )
+#define configUSE_TRACE_FACILITY  1
+#define configUSE_16_BIT_TICKS		0
+#define configIDLE_SHOULD_YIELD		1
+
+#define configUSE_TIME_SLICING    1
+#define configQUEUE_REGISTRY_SIZE 	0
+#define configUSE_QUEUE_SETS      1
+
+/* Index 1 for the waits of the ring buffers of spsc_ring.c, index 0 is the
+ * one of xTaskNotify(). */
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES    2
+
+#define configUSE_STATS_FORMATTING_FUNCTIONS 0
+#define configGENERATE_RUN_TIME_STATS             0
+
+/* Co-routine definitions. */
+#define configUSE_CO_ROUTINES 		0
+#define configMAX_CO_ROUTINE_PRIORITIES ( 2 )
+
+#define configUSE_APPLICATION_TASK_TAG 0
+
+/* Set the following definitions to 1 to include the API function, or zero
+to exclude the API function. */
+
+#define INCLUDE_vTaskPrioritySet		1
+#define INCLUDE_uxTaskPriorityGet		1
+#define INCLUDE_vTaskDelete				1
+#define INCLUDE_vTaskCleanUpResources	0
+#define INCLUDE_vTaskSuspend			1
+#define INCLUDE_vTaskDelayUntil			1
+#define INCLUDE_vTaskDelay				1
+
+/* A failed assertion stops the host build with the file and line. */
+extern void vAssertCalled( const char * pcFile, unsigned long ulLine );
+#define configASSERT( x )    if( ( x ) == 0 ) vAssertCalled( __FILE__, __LINE__ )
+
+#endif /* FREERTOS_CONFIG_H */
@@ -0,0 +1,617 @@
+/*
+ * Scheduler overhead benchmarks of the EDF kernel, on the host.
+ *
+ * Each run creates a periodic task set, starts the scheduler on the host port
+ * (port.c) and plays the tasks: on every tick the running task consumes one
+ * tick of its job, and a task whose job is done calls xTaskDelayUntil().  The
+ * kernel paths are timed as they are called:
+ *
+ *   tick           xTaskIncrementTick() on a tick that releases no job
+ *   release        xTaskIncrementTick() on a tick that releases jobs, per job
+ *   switch         vTaskSwitchContext()
+ *   delay_until    xTaskDelayUntil() at the end of a job
+ *   ready_insert   prvAddTaskToReadyList() of a ready task, with the ready
+ *                  list as it stands
+ *
+ * The sweep covers the task counts, period distributions and utilizations
+ * given on the command line.  The execution times come from UUniFast, in
+ * thousandths of a tick: a job that completes within a tick hands the rest of
+ * it to the next task.  u_eff in the output is the utilization once rounded.  Each
+ * configuration runs in its own process, so each starts from a fresh kernel.
+ * tasks.c is included rather than linked so that the static
+ * prvAddTaskToReadyList() can be timed.
+ *
+ * With --cold the TCBs are flushed from the caches before each timed call, so
+ * that a path pays for every cache line of a TCB it touches, as it does after
+ * an interrupt has run or on a part with a small cache.  The TCBs otherwise
+ * stay in the L1 cache of the host, where their layout makes no difference.
+ * x86 hosts only.
+ *
+ * Usage:
+ *   bench [--tasks 4,8,16] [--dist uniform,loguniform,harmonic]
+ *         [--util 0.5,0.9] [--ticks 20000] [--seed 1] [--format csv|json]
+ *         [--cold]
+ *
+ * Times are in nanoseconds of CLOCK_MONOTONIC_RAW, less the cost of reading
+ * the clock.
+ */
+
+#define _GNU_SOURCE
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#if defined( __x86_64__ ) || defined( __i386__ )
+    #include <emmintrin.h>
+    #define benchCAN_FLUSH    1
+#else
+    #define benchCAN_FLUSH    0
+#endif
+
+/* The kernel, with its static functions. */
+#include "tasks.c"
+
+#if ( configUSE_EDF_SCHEDULER != 1 )
+    #error The benchmarks time the EDF paths, build with configUSE_EDF_SCHEDULER set to 1
+#endif
+
+#define benchMAX_TASKS      256
+#define benchMAX_LIST       16
+#define benchPRIORITY       ( configUSE_EDF_HYBRID == 1 ? configEDF_BAND_PRIORITY : 1 )
+#define benchTICK_UNITS     1000U /* Execution times are in thousandths of a tick. */
+#define benchCACHE_LINE     64U
+
+extern volatile BaseType_t xPortYieldPending;
+
+typedef enum
+{
+    eBenchTick = 0,
+    eBenchRelease,
+    eBenchSwitch,
+    eBenchDelayUntil,
+    eBenchReadyInsert,
+    eBenchPaths
+} BenchPath_t;
+
+static const char * const pcPathNames[ eBenchPaths ] = { "tick", "release", "switch", "delay_until", "ready_insert" };
+
+typedef struct
+{
+    uint64_t * pullValues;
+    size_t xCount;
+    size_t xSize;
+} Samples_t;
+
+typedef struct
+{
+    unsigned uTasks;
+    const char * pcDist;
+    double dUtil;
+    unsigned long ulTicks;
+    unsigned long ulSeed;
+    int iCold;
+} BenchConfig_t;
+
+static Samples_t xSamples[ eBenchPaths ];
+static uint64_t ullClockCost;
+static uint64_t ullRandom;
+static double dEffectiveUtil; /* Of the task set once the execution times are rounded to ticks. */
+
+static TaskHandle_t xHandles[ benchMAX_TASKS ];
+static TickType_t xPeriods[ benchMAX_TASKS ];
+static uint32_t ulWcets[ benchMAX_TASKS ];
+static uint32_t ulRemaining[ benchMAX_TASKS ];
+static TickType_t xWakeTimes[ benchMAX_TASKS ];
+static unsigned uTasks;
+static int iCold;
+/*-----------------------------------------------------------*/
+
+static uint64_t prvNow( void )
+{
+    struct timespec xTime;
+
+    clock_gettime( CLOCK_MONOTONIC_RAW, &xTime );
+    return ( uint64_t ) xTime.tv_sec * 1000000000ULL + ( uint64_t ) xTime.tv_nsec;
+}
+
+static void prvAddSample( BenchPath_t ePath,
+                          uint64_t ullStart,
+                          uint64_t ullEnd,
+                          unsigned uDivisor )
+{
+    Samples_t * pxSamples = &xSamples[ ePath ];
+    uint64_t ullValue = ullEnd - ullStart;
+
+    ullValue = ( ullValue > ullClockCost ) ? ullValue - ullClockCost : 0U;
+
+    if( pxSamples->xCount == pxSamples->xSize )
+    {
+        pxSamples->xSize = ( pxSamples->xSize == 0U ) ? 4096U : pxSamples->xSize * 2U;
+        pxSamples->pullValues = realloc( pxSamples->pullValues, pxSamples->xSize * sizeof( uint64_t ) );
+
+        if( pxSamples->pullValues == NULL )
+        {
+            fprintf( stderr, "bench: out of memory\n" );
+            exit( 1 );
+        }
+    }
+
+    pxSamples->pullValues[ pxSamples->xCount++ ] = ullValue / uDivisor;
+}
+
+static int prvCompare( const void * pvA,
+                       const void * pvB )
+{
+    uint64_t ullA = *( const uint64_t * ) pvA, ullB = *( const uint64_t * ) pvB;
+
+    return ( ullA > ullB ) - ( ullA < ullB );
+}
+
+/* With --cold, flushes the TCBs of the task set and of the idle task from the
+ * caches before a timed call. */
+static void prvEvictTCBs( void )
+{
+    #if ( benchCAN_FLUSH == 1 )
+    {
+        const uint8_t * pucLine;
+        const uint8_t * pucEnd;
+        unsigned i;
+
+        if( iCold != 0 )
+        {
+            for( i = 0; i <= uTasks; i++ )
+            {
+                pucLine = ( const uint8_t * ) ( ( i < uTasks ) ? xHandles[ i ] : xIdleTaskHandle );
+                pucEnd = pucLine + sizeof( TCB_t );
+
+                for( ; pucLine < pucEnd; pucLine += benchCACHE_LINE )
+                {
+                    _mm_clflush( pucLine );
+                }
+            }
+
+            _mm_mfence();
+        }
+    }
+    #endif
+}
+
+/* The cheapest of many back to back clock reads, taken off every sample. */
+static void prvCalibrateClock( void )
+{
+    uint64_t ullStart, ullCost;
+    int i;
+
+    ullClockCost = UINT64_MAX;
+
+    for( i = 0; i < 10000; i++ )
+    {
+        ullStart = prvNow();
+        ullCost = prvNow() - ullStart;
+
+        if( ullCost < ullClockCost )
+        {
+            ullClockCost = ullCost;
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+/* xorshift64*, so a seed gives the same task set on every host. */
+static double prvRandom( void )
+{
+    ullRandom ^= ullRandom >> 12;
+    ullRandom ^= ullRandom << 25;
+    ullRandom ^= ullRandom >> 27;
+    return ( double ) ( ( ullRandom * 2685821657736338717ULL ) >> 11 ) / 9007199254740992.0;
+}
+
+/* The tasks are never run, the benchmark plays them. */
+static void prvBenchTask( void * pvParameters )
+{
+    ( void ) pvParameters;
+}
+
+static TickType_t prvPeriod( const char * pcDist )
+{
+    if( strcmp( pcDist, "uniform" ) == 0 )
+    {
+        return ( TickType_t ) ( 10 + ( int ) ( prvRandom() * 91.0 ) );
+    }
+    else if( strcmp( pcDist, "loguniform" ) == 0 )
+    {
+        return ( TickType_t ) lround( exp( log( 10.0 ) + prvRandom() * ( log( 1000.0 ) - log( 10.0 ) ) ) );
+    }
+    else
+    {
+        /* Harmonic: 10, 20, 40, 80 or 160 ticks. */
+        return ( TickType_t ) ( 10 << ( int ) ( prvRandom() * 5.0 ) );
+    }
+}
+
+/* UUniFast: utilizations summing to dUtil, uniformly distributed. */
+static void prvCreateTaskSet( const BenchConfig_t * pxConfig )
+{
+    double dSum = pxConfig->dUtil, dNext;
+    char cName[ configMAX_TASK_NAME_LEN ];
+    unsigned i;
+
+    for( i = 0; i < pxConfig->uTasks; i++ )
+    {
+        if( i + 1U < pxConfig->uTasks )
+        {
+            dNext = dSum * pow( prvRandom(), 1.0 / ( double ) ( pxConfig->uTasks - i - 1U ) );
+        }
+        else
+        {
+            dNext = 0.0;
+        }
+
+        xPeriods[ i ] = prvPeriod( pxConfig->pcDist );
+        ulWcets[ i ] = ( uint32_t ) lround( ( dSum - dNext ) * ( double ) xPeriods[ i ] * benchTICK_UNITS );
+
+        if( ulWcets[ i ] == 0U )
+        {
+            ulWcets[ i ] = 1U;
+        }
+
+        dEffectiveUtil += ( double ) ulWcets[ i ] / ( ( double ) xPeriods[ i ] * benchTICK_UNITS );
+        ulRemaining[ i ] = ulWcets[ i ];
+        xWakeTimes[ i ] = 0U;
+        dSum = dNext;
+
+        snprintf( cName, sizeof( cName ), "B%u", i );
+
+        if( xTaskPeriodicCreate( prvBenchTask, cName, configMINIMAL_STACK_SIZE, NULL, benchPRIORITY, &xHandles[ i ], xPeriods[ i ] ) != pdPASS )
+        {
+            fprintf( stderr, "bench: could not create task %u\n", i );
+            exit( 1 );
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static int prvCurrentTask( unsigned uTasks )
+{
+    unsigned i;
+
+    for( i = 0; i < uTasks; i++ )
+    {
+        if( xHandles[ i ] == ( TaskHandle_t ) pxCurrentTCB )
+        {
+            return ( int ) i;
+        }
+    }
+
+    return -1;
+}
+
+static void prvSwitch( void )
+{
+    uint64_t ullStart;
+
+    xPortYieldPending = pdFALSE;
+    prvEvictTCBs();
+    ullStart = prvNow();
+    vTaskSwitchContext();
+    prvAddSample( eBenchSwitch, ullStart, prvNow(), 1U );
+}
+
+/* One pass of the idle task loop: it moves its deadline ahead of the tick and
+ * yields if that puts a job before it.  Returns pdTRUE if it yielded to a
+ * task. */
+static BaseType_t prvIdleRuns( void )
+{
+    #if ( configUSE_EDF_HYBRID == 0 )
+    {
+        ( void ) uxListRemove( &( pxCurrentTCB->xStateListItem ) );
+        listSET_LIST_ITEM_VALUE( &( pxCurrentTCB->xStateListItem ), pxCurrentTCB->xTaskPeriod + xTickCount );
+        vListInsert( &xReadyTasksListEDF, &( pxCurrentTCB->xStateListItem ) );
+
+        if( listGET_OWNER_OF_HEAD_ENTRY( &xReadyTasksListEDF ) != pxCurrentTCB )
+        {
+            prvSwitch();
+        }
+    }
+    #else
+    {
+        if( prvEDFBandOnTop() != pdFALSE )
+        {
+            prvSwitch();
+        }
+    }
+    #endif
+
+    return ( pxCurrentTCB != xIdleTaskHandle ) ? pdTRUE : pdFALSE;
+}
+
+/* Times prvAddTaskToReadyList() on a ready task picked at random.  The last
+ * of the tasks with the same deadline is taken, so putting it back leaves
+ * the list as it was. */
+static void prvTimeReadyInsert( void )
+{
+    UBaseType_t uxLength = listCURRENT_LIST_LENGTH( &xReadyTasksListEDF );
+    ListItem_t * pxItem;
+    TCB_t * pxTCB;
+    uint64_t ullStart;
+    UBaseType_t x;
+
+    if( uxLength == 0U )
+    {
+        return;
+    }
+
+    pxItem = listGET_HEAD_ENTRY( &xReadyTasksListEDF );
+
+    for( x = ( UBaseType_t ) ( prvRandom() * ( double ) uxLength ); x > 0U; x-- )
+    {
+        pxItem = listGET_NEXT( pxItem );
+    }
+
+    while( ( listGET_NEXT( pxItem ) != listGET_END_MARKER( &xReadyTasksListEDF ) ) &&
+           ( listGET_LIST_ITEM_VALUE( listGET_NEXT( pxItem ) ) == listGET_LIST_ITEM_VALUE( pxItem ) ) )
+    {
+        pxItem = listGET_NEXT( pxItem );
+    }
+
+    pxTCB = listGET_LIST_ITEM_OWNER( pxItem );
+    ( void ) uxListRemove( pxItem );
+
+    prvEvictTCBs();
+    ullStart = prvNow();
+    prvAddTaskToReadyList( pxTCB );
+    prvAddSample( eBenchReadyInsert, ullStart, prvNow(), 1U );
+}
+
+static UBaseType_t prvDelayedTasks( void )
+{
+    return listCURRENT_LIST_LENGTH( pxDelayedTaskList ) + listCURRENT_LIST_LENGTH( pxOverflowDelayedTaskList );
+}
+
+static void prvRun( const BenchConfig_t * pxConfig )
+{
+    unsigned long ulTick;
+    UBaseType_t uxBefore, uxReleased;
+    uint64_t ullStart, ullEnd;
+    BaseType_t xSwitch;
+    uint32_t ulLeft, ulRun;
+    int iTask;
+
+    prvCreateTaskSet( pxConfig );
+    vTaskStartScheduler();
+    xPortYieldPending = pdFALSE;
+    uTasks = pxConfig->uTasks;
+    iCold = pxConfig->iCold;
+
+    for( ulTick = 0; ulTick < pxConfig->ulTicks; ulTick++ )
+    {
+        uxBefore = prvDelayedTasks();
+        prvEvictTCBs();
+        ullStart = prvNow();
+        xSwitch = xTaskIncrementTick();
+        ullEnd = prvNow();
+        uxReleased = uxBefore - prvDelayedTasks();
+
+        if( uxReleased > 0U )
+        {
+            prvAddSample( eBenchRelease, ullStart, ullEnd, ( unsigned ) uxReleased );
+        }
+        else
+        {
+            prvAddSample( eBenchTick, ullStart, ullEnd, 1U );
+        }
+
+        if( ( xSwitch != pdFALSE ) || ( xPortYieldPending != pdFALSE ) )
+        {
+            prvSwitch();
+        }
+
+        prvTimeReadyInsert();
+
+        /* The tasks execute for the rest of the tick. */
+        for( ulLeft = benchTICK_UNITS; ulLeft > 0U; )
+        {
+            iTask = prvCurrentTask( pxConfig->uTasks );
+
+            if( iTask < 0 )
+            {
+                if( prvIdleRuns() == pdFALSE )
+                {
+                    break;
+                }
+
+                continue;
+            }
+
+            ulRun = ( ulRemaining[ iTask ] < ulLeft ) ? ulRemaining[ iTask ] : ulLeft;
+            ulRemaining[ iTask ] -= ulRun;
+            ulLeft -= ulRun;
+
+            if( ulRemaining[ iTask ] == 0U )
+            {
+                ulRemaining[ iTask ] = ulWcets[ iTask ];
+
+                prvEvictTCBs();
+                ullStart = prvNow();
+                ( void ) xTaskDelayUntil( &xWakeTimes[ iTask ], xPeriods[ iTask ] );
+                prvAddSample( eBenchDelayUntil, ullStart, prvNow(), 1U );
+
+                if( xPortYieldPending != pdFALSE )
+                {
+                    prvSwitch();
+                }
+            }
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvReport( const BenchConfig_t * pxConfig,
+                       int iJson,
+                       int iFirst )
+{
+    Samples_t * pxSamples;
+    uint64_t ullSum;
+    size_t x;
+    int i;
+
+    for( i = 0; i < eBenchPaths; i++ )
+    {
+        pxSamples = &xSamples[ i ];
+
+        if( pxSamples->xCount == 0U )
+        {
+            continue;
+        }
+
+        qsort( pxSamples->pullValues, pxSamples->xCount, sizeof( uint64_t ), prvCompare );
+
+        for( ullSum = 0U, x = 0; x < pxSamples->xCount; x++ )
+        {
+            ullSum += pxSamples->pullValues[ x ];
+        }
+
+        if( iJson != 0 )
+        {
+            printf( "%s  {\"tasks\": %u, \"dist\": \"%s\", \"util\": %.2f, \"u_eff\": %.3f, \"seed\": %lu, \"ticks\": %lu, "
+                    "\"path\": \"%s\", \"samples\": %zu, \"mean_ns\": %.1f, \"p50_ns\": %llu, \"p99_ns\": %llu, \"max_ns\": %llu}",
+                    iFirst ? "" : ",\n", pxConfig->uTasks, pxConfig->pcDist, pxConfig->dUtil, dEffectiveUtil, pxConfig->ulSeed, pxConfig->ulTicks,
+                    pcPathNames[ i ], pxSamples->xCount, ( double ) ullSum / ( double ) pxSamples->xCount,
+                    ( unsigned long long ) pxSamples->pullValues[ pxSamples->xCount / 2U ],
+                    ( unsigned long long ) pxSamples->pullValues[ ( pxSamples->xCount * 99U ) / 100U ],
+                    ( unsigned long long ) pxSamples->pullValues[ pxSamples->xCount - 1U ] );
+            iFirst = 0;
+        }
+        else
+        {
+            printf( "%u,%s,%.2f,%.3f,%lu,%lu,%s,%zu,%.1f,%llu,%llu,%llu\n",
+                    pxConfig->uTasks, pxConfig->pcDist, pxConfig->dUtil, dEffectiveUtil, pxConfig->ulSeed, pxConfig->ulTicks,
+                    pcPathNames[ i ], pxSamples->xCount, ( double ) ullSum / ( double ) pxSamples->xCount,
+                    ( unsigned long long ) pxSamples->pullValues[ pxSamples->xCount / 2U ],
+                    ( unsigned long long ) pxSamples->pullValues[ ( pxSamples->xCount * 99U ) / 100U ],
+                    ( unsigned long long ) pxSamples->pullValues[ pxSamples->xCount - 1U ] );
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static int prvSplit( char * pcList,
+                     char * pcItems[],
+                     int iMax )
+{
+    int iCount = 0;
+    char * pcItem = strtok( pcList, "," );
+
+    while( ( pcItem != NULL ) && ( iCount < iMax ) )
+    {
+        pcItems[ iCount++ ] = pcItem;
+        pcItem = strtok( NULL, "," );
+    }
+
+    return iCount;
+}
+
+int main( int argc,
+          char * argv[] )
+{
+    char cTasks[ 128 ] = "2,4,8,16,32,64", cDists[ 128 ] = "uniform,loguniform,harmonic", cUtils[ 128 ] = "0.5,0.7,0.9";
+    char * pcTasks[ benchMAX_LIST ], * pcDists[ benchMAX_LIST ], * pcUtils[ benchMAX_LIST ];
+    int iTasks, iDists, iUtils, t, d, u, iJson = 0, iStatus, iFirst = 1;
+    BenchConfig_t xConfig = { 0U, NULL, 0.0, 20000UL, 1UL, 0 };
+    pid_t xChild;
+
+    for( t = 1; t < argc; t++ )
+    {
+        if( ( strcmp( argv[ t ], "--tasks" ) == 0 ) && ( t + 1 < argc ) )
+        {
+            snprintf( cTasks, sizeof( cTasks ), "%s", argv[ ++t ] );
+        }
+        else if( ( strcmp( argv[ t ], "--dist" ) == 0 ) && ( t + 1 < argc ) )
+        {
+            snprintf( cDists, sizeof( cDists ), "%s", argv[ ++t ] );
+        }
+        else if( ( strcmp( argv[ t ], "--util" ) == 0 ) && ( t + 1 < argc ) )
+        {
+            snprintf( cUtils, sizeof( cUtils ), "%s", argv[ ++t ] );
+        }
+        else if( ( strcmp( argv[ t ], "--ticks" ) == 0 ) && ( t + 1 < argc ) )
+        {
+            xConfig.ulTicks = strtoul( argv[ ++t ], NULL, 0 );
+        }
+        else if( ( strcmp( argv[ t ], "--seed" ) == 0 ) && ( t + 1 < argc ) )
+        {
+            xConfig.ulSeed = strtoul( argv[ ++t ], NULL, 0 );
+        }
+        else if( ( strcmp( argv[ t ], "--format" ) == 0 ) && ( t + 1 < argc ) )
+        {
+            iJson = ( strcmp( argv[ ++t ], "json" ) == 0 );
+        }
+        else if( ( strcmp( argv[ t ], "--cold" ) == 0 ) && ( benchCAN_FLUSH == 1 ) )
+        {
+            xConfig.iCold = 1;
+        }
+        else
+        {
+            fprintf( stderr, "usage: %s [--tasks 4,8] [--dist uniform,loguniform,harmonic] [--util 0.5,0.9] "
+                             "[--ticks N] [--seed N] [--format csv|json]%s\n", argv[ 0 ], benchCAN_FLUSH ? " [--cold]" : "" );
+            return 2;
+        }
+    }
+
+    iTasks = prvSplit( cTasks, pcTasks, benchMAX_LIST );
+    iDists = prvSplit( cDists, pcDists, benchMAX_LIST );
+    iUtils = prvSplit( cUtils, pcUtils, benchMAX_LIST );
+
+    printf( iJson ? "[\n" : "tasks,dist,util,u_eff,seed,ticks,path,samples,mean_ns,p50_ns,p99_ns,max_ns\n" );
+
+    for( t = 0; t < iTasks; t++ )
+    {
+        for( d = 0; d < iDists; d++ )
+        {
+            for( u = 0; u < iUtils; u++ )
+            {
+                xConfig.uTasks = ( unsigned ) atoi( pcTasks[ t ] );
+                xConfig.pcDist = pcDists[ d ];
+                xConfig.dUtil = atof( pcUtils[ u ] );
+
+                if( ( xConfig.uTasks == 0U ) || ( xConfig.uTasks > benchMAX_TASKS ) )
+                {
+                    fprintf( stderr, "bench: between 1 and %d tasks\n", benchMAX_TASKS );
+                    return 2;
+                }
+
+                fflush( stdout );
+                xChild = fork();
+
+                if( xChild == 0 )
+                {
+                    ullRandom = ( xConfig.ulSeed * 0x9E3779B97F4A7C15ULL ) | 1U;
+                    prvCalibrateClock();
+                    prvRun( &xConfig );
+                    prvReport( &xConfig, iJson, iFirst );
+                    fflush( stdout );
+                    _exit( 0 );
+                }
+
+                if( ( xChild < 0 ) || ( waitpid( xChild, &iStatus, 0 ) < 0 ) ||
+                    !WIFEXITED( iStatus ) || ( WEXITSTATUS( iStatus ) != 0 ) )
+                {
+                    fprintf( stderr, "bench: run with %u tasks, %s periods, utilization %.2f failed\n",
+                             xConfig.uTasks, xConfig.pcDist, xConfig.dUtil );
+                    return 1;
+                }
+
+                iFirst = 0;
+            }
+        }
+    }
+
+    printf( iJson ? "\n]\n" : "" );
+    return 0;
+}
@@ -0,0 +1,388 @@
+/*
+ * Allocator benchmark, on the host: the time pvPortMalloc() and vPortFree()
+ * take, and the fragmentation they leave, under the allocations of mode
+ * changes.
+ *
+ * The heap is included: the Makefile builds one binary for each of heap_2.c,
+ * heap_4.c and Edited Files/heap_tlsf.c.  A run first creates --live objects,
+ * then plays --changes mode changes: each deletes a --churn fraction of the
+ * objects, picked at random, and creates as many new ones.  Objects are what
+ * the application allocates at run time, with the sizes they have on the
+ * LPC2129:
+ *
+ *   task     a stack of 64 to 512 words, then a TCB, as xTaskCreate() does on
+ *            a port whose stack grows down
+ *   queue    the queue structure and its storage in one block, for 1 to 32
+ *            items of 1 to 16 bytes, as xQueueCreate() does
+ *
+ * Two tasks are created for each queue.  Each call is timed on its own.  After
+ * each mode change the fragmentation is 1 - largest free block / free bytes: 0
+ * when the free space is in one block.  A request that fails is counted and
+ * not retried.
+ *
+ * Usage:
+ *   heapbench [--live 512] [--changes 2000] [--churn 0.25] [--seed 1]
+ *             [--header]
+ *
+ * Prints one CSV line for malloc and one for free, with a header line first
+ * if --header is given.  Times are in nanoseconds of CLOCK_MONOTONIC_RAW, less
+ * the cost of reading the clock.
+ */
+
+#define _GNU_SOURCE
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* The heap, included rather than linked so that the largest free block of
+ * heap_2.c, which keeps no statistics, can be read from its free list. */
+#include benchHEAP_SOURCE
+
+#ifndef benchHEAP
+    #define benchHEAP    "heap"
+#endif
+
+#define benchMAX_OBJECTS    65536U
+#define benchTCB_SIZE       144U /* sizeof( TCB_t ) on the target, rounded up. */
+#define benchQUEUE_SIZE     80U  /* sizeof( Queue_t ) on the target, rounded up. */
+#define benchWORD_SIZE      4U   /* sizeof( StackType_t ) on the target. */
+
+typedef enum
+{
+    eBenchMalloc = 0,
+    eBenchFree,
+    eBenchPaths
+} BenchPath_t;
+
+static const char * const pcPathNames[ eBenchPaths ] = { "malloc", "free" };
+
+typedef struct
+{
+    uint64_t * pullValues;
+    size_t xCount;
+    size_t xSize;
+} Samples_t;
+
+/* A task has a stack and a TCB, a queue only the first block. */
+typedef struct
+{
+    void * pvFirst;
+    void * pvSecond;
+} Object_t;
+
+static Samples_t xSamples[ eBenchPaths ];
+static uint64_t ullClockCost;
+static uint64_t ullRandom;
+static Object_t xObjects[ benchMAX_OBJECTS ];
+static unsigned long ulFailures;
+static double dFragmentationSum, dFragmentationMax;
+static unsigned long ulFragmentationSamples;
+/*-----------------------------------------------------------*/
+
+/* The allocators suspend the scheduler, which is not running here. */
+void vTaskSuspendAll( void )
+{
+}
+
+BaseType_t xTaskResumeAll( void )
+{
+    return pdFALSE;
+}
+
+void vPortEnterCritical( void )
+{
+}
+
+void vPortExitCritical( void )
+{
+}
+
+void vAssertCalled( const char * pcFile,
+                    unsigned long ulLine )
+{
+    fprintf( stderr, "heapbench: assertion failed at %s:%lu\n", pcFile, ulLine );
+    exit( 1 );
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvNow( void )
+{
+    struct timespec xTime;
+
+    clock_gettime( CLOCK_MONOTONIC_RAW, &xTime );
+    return ( uint64_t ) xTime.tv_sec * 1000000000ULL + ( uint64_t ) xTime.tv_nsec;
+}
+
+static void prvAddSample( BenchPath_t ePath,
+                          uint64_t ullStart,
+                          uint64_t ullEnd )
+{
+    Samples_t * pxSamples = &xSamples[ ePath ];
+    uint64_t ullValue = ullEnd - ullStart;
+
+    ullValue = ( ullValue > ullClockCost ) ? ullValue - ullClockCost : 0U;
+
+    if( pxSamples->xCount == pxSamples->xSize )
+    {
+        pxSamples->xSize = ( pxSamples->xSize == 0U ) ? 4096U : pxSamples->xSize * 2U;
+        pxSamples->pullValues = realloc( pxSamples->pullValues, pxSamples->xSize * sizeof( uint64_t ) );
+
+        if( pxSamples->pullValues == NULL )
+        {
+            fprintf( stderr, "heapbench: out of memory\n" );
+            exit( 1 );
+        }
+    }
+
+    pxSamples->pullValues[ pxSamples->xCount++ ] = ullValue;
+}
+
+static int prvCompare( const void * pvA,
+                       const void * pvB )
+{
+    uint64_t ullA = *( const uint64_t * ) pvA, ullB = *( const uint64_t * ) pvB;
+
+    return ( ullA > ullB ) - ( ullA < ullB );
+}
+
+/* The cheapest of many back to back clock reads, taken off every sample. */
+static void prvCalibrateClock( void )
+{
+    uint64_t ullStart, ullCost;
+    int i;
+
+    ullClockCost = UINT64_MAX;
+
+    for( i = 0; i < 10000; i++ )
+    {
+        ullStart = prvNow();
+        ullCost = prvNow() - ullStart;
+
+        if( ullCost < ullClockCost )
+        {
+            ullClockCost = ullCost;
+        }
+    }
+}
+
+/* xorshift64*, so a seed gives the same workload on every host. */
+static uint32_t prvRandom( uint32_t ulRange )
+{
+    ullRandom ^= ullRandom >> 12;
+    ullRandom ^= ullRandom << 25;
+    ullRandom ^= ullRandom >> 27;
+    return ( uint32_t ) ( ( ( ullRandom * 2685821657736338717ULL ) >> 32 ) % ulRange );
+}
+/*-----------------------------------------------------------*/
+
+static void * prvMalloc( size_t xSize )
+{
+    uint64_t ullStart = prvNow();
+    void * pv = pvPortMalloc( xSize );
+
+    prvAddSample( eBenchMalloc, ullStart, prvNow() );
+
+    if( pv == NULL )
+    {
+        ulFailures++;
+    }
+
+    return pv;
+}
+
+static void prvFree( void * pv )
+{
+    uint64_t ullStart;
+
+    if( pv != NULL )
+    {
+        ullStart = prvNow();
+        vPortFree( pv );
+        prvAddSample( eBenchFree, ullStart, prvNow() );
+    }
+}
+
+static void prvCreate( Object_t * pxObject )
+{
+    if( prvRandom( 3U ) != 0U )
+    {
+        /* As xTaskCreate() does, the TCB is not allocated without a stack,
+         * and the stack is freed again without a TCB. */
+        pxObject->pvFirst = prvMalloc( ( 64U + prvRandom( 449U ) ) * benchWORD_SIZE );
+        pxObject->pvSecond = ( pxObject->pvFirst != NULL ) ? prvMalloc( benchTCB_SIZE ) : NULL;
+
+        if( ( pxObject->pvFirst != NULL ) && ( pxObject->pvSecond == NULL ) )
+        {
+            prvFree( pxObject->pvFirst );
+            pxObject->pvFirst = NULL;
+        }
+    }
+    else
+    {
+        pxObject->pvFirst = prvMalloc( benchQUEUE_SIZE + ( 1U + prvRandom( 32U ) ) * ( 1U + prvRandom( 16U ) ) );
+        pxObject->pvSecond = NULL;
+    }
+}
+
+static void prvDelete( Object_t * pxObject )
+{
+    /* A task is deleted TCB first, as prvDeleteTCB() does. */
+    prvFree( pxObject->pvSecond );
+    prvFree( pxObject->pvFirst );
+    pxObject->pvFirst = NULL;
+    pxObject->pvSecond = NULL;
+}
+
+static size_t prvLargestFreeBlock( void )
+{
+    #if defined( configADJUSTED_HEAP_SIZE )
+    {
+        /* heap_2.c keeps its free list in order of size. */
+        BlockLink_t * pxBlock = &xStart;
+
+        while( pxBlock->pxNextFreeBlock != &xEnd )
+        {
+            pxBlock = pxBlock->pxNextFreeBlock;
+        }
+
+        return pxBlock->xBlockSize;
+    }
+    #else
+    {
+        HeapStats_t xStats;
+
+        vPortGetHeapStats( &xStats );
+        return xStats.xSizeOfLargestFreeBlockInBytes;
+    }
+    #endif
+}
+
+static void prvSampleFragmentation( void )
+{
+    size_t xFree = xPortGetFreeHeapSize();
+    double dFragmentation;
+
+    dFragmentation = ( xFree != 0U ) ? 1.0 - ( double ) prvLargestFreeBlock() / ( double ) xFree : 0.0;
+    dFragmentationSum += dFragmentation;
+    ulFragmentationSamples++;
+
+    if( dFragmentation > dFragmentationMax )
+    {
+        dFragmentationMax = dFragmentation;
+    }
+}
+/*-----------------------------------------------------------*/
+
+int main( int argc,
+          char * argv[] )
+{
+    unsigned long ulLive = 512UL, ulChanges = 2000UL, ulSeed = 1UL, c, x, ulChurn;
+    double dChurn = 0.25;
+    int t, iHeader = 0;
+    Samples_t * pxSamples;
+    uint64_t ullSum;
+
+    for( t = 1; t < argc; t++ )
+    {
+        if( ( strcmp( argv[ t ], "--live" ) == 0 ) && ( t + 1 < argc ) )
+        {
+            ulLive = strtoul( argv[ ++t ], NULL, 0 );
+        }
+        else if( ( strcmp( argv[ t ], "--changes" ) == 0 ) && ( t + 1 < argc ) )
+        {
+            ulChanges = strtoul( argv[ ++t ], NULL, 0 );
+        }
+        else if( ( strcmp( argv[ t ], "--churn" ) == 0 ) && ( t + 1 < argc ) )
+        {
+            dChurn = atof( argv[ ++t ] );
+        }
+        else if( ( strcmp( argv[ t ], "--seed" ) == 0 ) && ( t + 1 < argc ) )
+        {
+            ulSeed = strtoul( argv[ ++t ], NULL, 0 );
+        }
+        else if( strcmp( argv[ t ], "--header" ) == 0 )
+        {
+            iHeader = 1;
+        }
+        else
+        {
+            fprintf( stderr, "usage: %s [--live N] [--changes N] [--churn F] [--seed N] [--header]\n", argv[ 0 ] );
+            return 2;
+        }
+    }
+
+    if( ( ulLive == 0UL ) || ( ulLive > benchMAX_OBJECTS ) || ( dChurn <= 0.0 ) || ( dChurn > 1.0 ) )
+    {
+        fprintf( stderr, "heapbench: between 1 and %u live objects, and a churn in ( 0, 1 ]\n", benchMAX_OBJECTS );
+        return 2;
+    }
+
+    /* The pages of the heap are touched first so that their faults are not
+     * timed. */
+    ( void ) memset( ucHeap, 0, sizeof( ucHeap ) );
+    ullRandom = ( ulSeed * 0x9E3779B97F4A7C15ULL ) | 1U;
+    prvCalibrateClock();
+    ulChurn = ( unsigned long ) ( dChurn * ( double ) ulLive + 0.5 );
+    ulChurn = ( ulChurn == 0UL ) ? 1UL : ulChurn;
+
+    for( x = 0; x < ulLive; x++ )
+    {
+        prvCreate( &xObjects[ x ] );
+    }
+
+    for( c = 0; c < ulChanges; c++ )
+    {
+        for( x = 0; x < ulChurn; x++ )
+        {
+            prvDelete( &xObjects[ prvRandom( ( uint32_t ) ulLive ) ] );
+        }
+
+        /* The objects deleted twice over are created again all the same, so
+         * the number of live objects holds. */
+        for( x = 0; x < ulLive; x++ )
+        {
+            if( xObjects[ x ].pvFirst == NULL )
+            {
+                prvCreate( &xObjects[ x ] );
+            }
+        }
+
+        prvSampleFragmentation();
+    }
+
+    if( iHeader != 0 )
+    {
+        printf( "heap,live,changes,churn,seed,path,samples,mean_ns,p50_ns,p99_ns,max_ns,failures,frag_mean,frag_max\n" );
+    }
+
+    for( t = 0; t < eBenchPaths; t++ )
+    {
+        pxSamples = &xSamples[ t ];
+
+        if( pxSamples->xCount == 0U )
+        {
+            continue;
+        }
+
+        qsort( pxSamples->pullValues, pxSamples->xCount, sizeof( uint64_t ), prvCompare );
+
+        for( ullSum = 0U, x = 0; x < pxSamples->xCount; x++ )
+        {
+            ullSum += pxSamples->pullValues[ x ];
+        }
+
+        printf( "%s,%lu,%lu,%.2f,%lu,%s,%zu,%.1f,%llu,%llu,%llu,%lu,%.3f,%.3f\n",
+                benchHEAP, ulLive, ulChanges, dChurn, ulSeed, pcPathNames[ t ], pxSamples->xCount,
+                ( double ) ullSum / ( double ) pxSamples->xCount,
+                ( unsigned long long ) pxSamples->pullValues[ pxSamples->xCount / 2U ],
+                ( unsigned long long ) pxSamples->pullValues[ ( pxSamples->xCount * 99U ) / 100U ],
+                ( unsigned long long ) pxSamples->pullValues[ pxSamples->xCount - 1U ],
+                ulFailures, ( ulFragmentationSamples != 0UL ) ? dFragmentationSum / ( double ) ulFragmentationSamples : 0.0,
+                dFragmentationMax );
+    }
+
+    return 0;
+}
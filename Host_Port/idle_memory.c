@@ -0,0 +1,39 @@
+/*
+ * Memory of the idle task for the host builds other than the simulator, whose
+ * application, main.c, has its own.  The kernel asks for it in place of
+ * allocating it when configSUPPORT_STATIC_ALLOCATION is 1, for example:
+ *
+ *     make bench CONFIG="-DconfigSUPPORT_STATIC_ALLOCATION=1"
+ */
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+
+    #if ( configUSE_EDF_SCHEDULER == 1 )
+        static StaticPeriodicTask_t xIdleTaskBuffer;
+    #else
+        static StaticTask_t xIdleTaskBuffer;
+    #endif
+    static StackType_t xIdleTaskStack[ configMINIMAL_STACK_SIZE ];
+/*-----------------------------------------------------------*/
+
+    #if ( configUSE_EDF_SCHEDULER == 1 )
+        void vApplicationGetIdlePeriodicTaskMemory( StaticPeriodicTask_t ** ppxIdleTaskTCBBuffer,
+                                                    StackType_t ** ppxIdleTaskStackBuffer,
+                                                    uint32_t * pulIdleTaskStackSize )
+    #else
+        void vApplicationGetIdleTaskMemory( StaticTask_t ** ppxIdleTaskTCBBuffer,
+                                            StackType_t ** ppxIdleTaskStackBuffer,
+                                            uint32_t * pulIdleTaskStackSize )
+    #endif
+    {
+        *ppxIdleTaskTCBBuffer = &xIdleTaskBuffer;
+        *ppxIdleTaskStackBuffer = xIdleTaskStack;
+        *pulIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* configSUPPORT_STATIC_ALLOCATION */
@@ -0,0 +1,522 @@
+/*
+ * Cost of an event from a producer task to a consumer task, through a queue,
+ * a task notification or a ring buffer, on the host.
+ *
+ * This is the path from the button and Tx tasks of Edited Files/main.c to
+ * Uart_Rx.  Each round, a producer task posts one event from each of
+ * --sources sources, and a consumer task blocked on all of them takes and
+ * handles the events:
+ *
+ *   queue     one queue of one byte per source, all members of a queue set.
+ *             The consumer waits on the set, then receives from the queue
+ *             the set returned.
+ *   notify    one bit of the notification value of the consumer per source,
+ *             set with xTaskNotify( eSetBits ).  The consumer takes every bit
+ *             set since its last wait with a single xTaskNotifyWait().
+ *   ring      one record of 4 bytes per event, the number of its source, in
+ *             a single producer, single consumer ring (spsc_ring.c), which
+ *             the consumer waits on.  There the tick also starts the rounds
+ *             through a ring, with xSpscRingSendFromISR().
+ *
+ * The consumer is woken under EDF either at each event (preempt, its
+ * deadline is earlier than the one of the producer) or once the producer has
+ * posted them all and blocked (batch, its deadline is later).
+ *
+ * The tasks run on the contexts of the simulator port (sim/port.c), so the
+ * blocking calls, the wakeups and the context switches are the ones of the
+ * kernel.  A round is started by the tick the idle task takes once both
+ * tasks are blocked, and times:
+ *
+ *   post      each call of the producer to post an event, with the switch to
+ *             the consumer and back when it preempts
+ *   event     the round from the first post to the consumer having handled
+ *             the last event, divided by the number of sources.  In batch it
+ *             includes the block of the producer.
+ *
+ * Each configuration runs in its own process, as the scheduler cannot be
+ * started twice.
+ *
+ * Usage:
+ *   ipcbench [--path queue,notify,ring] [--order preempt,batch]
+ *            [--sources 1,3,8] [--rounds 100000]
+ *
+ * Times are in nanoseconds of CLOCK_MONOTONIC_RAW, less the cost of reading
+ * the clock.
+ */
+
+#define _GNU_SOURCE
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "spsc_ring.h"
+
+#include "sim/sim.h"
+
+#if ( configUSE_EDF_SCHEDULER != 1 ) || ( configUSE_QUEUE_SETS != 1 ) || ( configUSE_TASK_NOTIFICATIONS != 1 )
+    #error The benchmark needs the EDF scheduler, the queue sets and the task notifications
+#endif
+
+#define benchMAX_SOURCES    32
+#define benchRING_RECORDS   32
+#define benchMAX_LIST       16
+#define benchSHORT_PERIOD   20U
+#define benchLONG_PERIOD    50U
+#define benchPRIORITY       ( configUSE_EDF_HYBRID == 1 ? configEDF_BAND_PRIORITY : 1 )
+
+typedef enum
+{
+    eBenchPost = 0,
+    eBenchEvent,
+    eBenchPaths
+} BenchPath_t;
+
+static const char * const pcPathNames[ eBenchPaths ] = { "post", "event" };
+
+typedef struct
+{
+    uint64_t * pullValues;
+    size_t xCount;
+    size_t xSize;
+} Samples_t;
+
+typedef enum
+{
+    eChannelQueue = 0,
+    eChannelNotify,
+    eChannelRing,
+    eChannels
+} BenchChannel_t;
+
+static const char * const pcChannelNames[ eChannels ] = { "queue", "notify", "ring" };
+
+typedef struct
+{
+    BenchChannel_t eChannel;
+    int iBatch;
+    unsigned uSources;
+    unsigned long ulRounds;
+} BenchConfig_t;
+
+static Samples_t xSamples[ eBenchPaths ];
+static uint64_t ullClockCost;
+static BenchConfig_t xConfig;
+
+static TaskHandle_t xProducer = NULL;
+static TaskHandle_t xConsumer = NULL;
+static QueueHandle_t xQueues[ benchMAX_SOURCES ];
+static QueueSetHandle_t xQueueSet = NULL;
+static SpscRing_t xEventRing;
+static uint32_t ulEventStorage[ benchRING_RECORDS ];
+static SpscRing_t xRoundRing;
+static uint32_t ulRoundStorage[ benchRING_RECORDS ];
+
+/* Set by the producer at the start of a round, read by the consumer. */
+static uint64_t ullRoundStart;
+static volatile uint32_t ulHandled;
+
+/* The sim.h interface sim/port.c calls back into. */
+TickType_t xSimEndTick = portMAX_DELAY;
+BaseType_t xSimFastForward = pdFALSE;
+/*-----------------------------------------------------------*/
+
+static uint64_t prvNow( void )
+{
+    struct timespec xTime;
+
+    clock_gettime( CLOCK_MONOTONIC_RAW, &xTime );
+    return ( uint64_t ) xTime.tv_sec * 1000000000ULL + ( uint64_t ) xTime.tv_nsec;
+}
+
+static void prvAddSample( BenchPath_t ePath,
+                          uint64_t ullStart,
+                          uint64_t ullEnd,
+                          unsigned uDivisor )
+{
+    Samples_t * pxSamples = &xSamples[ ePath ];
+    uint64_t ullValue = ullEnd - ullStart;
+
+    ullValue = ( ullValue > ullClockCost ) ? ullValue - ullClockCost : 0U;
+
+    if( pxSamples->xCount == pxSamples->xSize )
+    {
+        pxSamples->xSize = ( pxSamples->xSize == 0U ) ? 4096U : pxSamples->xSize * 2U;
+        pxSamples->pullValues = realloc( pxSamples->pullValues, pxSamples->xSize * sizeof( uint64_t ) );
+
+        if( pxSamples->pullValues == NULL )
+        {
+            fprintf( stderr, "ipcbench: out of memory\n" );
+            exit( 1 );
+        }
+    }
+
+    pxSamples->pullValues[ pxSamples->xCount++ ] = ullValue / uDivisor;
+}
+
+static int prvCompare( const void * pvA,
+                       const void * pvB )
+{
+    uint64_t ullA = *( const uint64_t * ) pvA, ullB = *( const uint64_t * ) pvB;
+
+    return ( ullA > ullB ) - ( ullA < ullB );
+}
+
+/* The cheapest of many back to back clock reads, taken off every sample. */
+static void prvCalibrateClock( void )
+{
+    uint64_t ullStart, ullCost;
+    int i;
+
+    ullClockCost = UINT64_MAX;
+
+    for( i = 0; i < 10000; i++ )
+    {
+        ullStart = prvNow();
+        ullCost = prvNow() - ullStart;
+
+        if( ullCost < ullClockCost )
+        {
+            ullClockCost = ullCost;
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvReport( void )
+{
+    Samples_t * pxSamples;
+    uint64_t ullSum;
+    size_t x;
+    int i;
+
+    for( i = 0; i < eBenchPaths; i++ )
+    {
+        pxSamples = &xSamples[ i ];
+
+        if( pxSamples->xCount == 0U )
+        {
+            continue;
+        }
+
+        qsort( pxSamples->pullValues, pxSamples->xCount, sizeof( uint64_t ), prvCompare );
+
+        for( ullSum = 0U, x = 0; x < pxSamples->xCount; x++ )
+        {
+            ullSum += pxSamples->pullValues[ x ];
+        }
+
+        printf( "%s,%s,%u,%lu,%s,%zu,%.1f,%llu,%llu,%llu\n",
+                pcChannelNames[ xConfig.eChannel ], xConfig.iBatch ? "batch" : "preempt", xConfig.uSources, xConfig.ulRounds,
+                pcPathNames[ i ], pxSamples->xCount, ( double ) ullSum / ( double ) pxSamples->xCount,
+                ( unsigned long long ) pxSamples->pullValues[ pxSamples->xCount / 2U ],
+                ( unsigned long long ) pxSamples->pullValues[ ( pxSamples->xCount * 99U ) / 100U ],
+                ( unsigned long long ) pxSamples->pullValues[ pxSamples->xCount - 1U ] );
+    }
+}
+/*-----------------------------------------------------------*/
+
+/* Handles one event, counts the round complete at the last one. */
+static void prvHandled( uint32_t ulEvents )
+{
+    ulHandled += ulEvents;
+
+    if( ulHandled == xConfig.uSources )
+    {
+        prvAddSample( eBenchEvent, ullRoundStart, prvNow(), xConfig.uSources );
+        ulHandled = 0U;
+    }
+}
+
+static void prvConsumerTask( void * pvParameters )
+{
+    QueueSetMemberHandle_t xMember;
+    uint32_t ulBits, ulSource;
+    uint8_t ucEvent;
+
+    ( void ) pvParameters;
+
+    for( ; ; )
+    {
+        if( xConfig.eChannel == eChannelNotify )
+        {
+            ( void ) xTaskNotifyWait( 0U, UINT32_MAX, &ulBits, portMAX_DELAY );
+            prvHandled( ( uint32_t ) __builtin_popcount( ulBits ) );
+        }
+        else if( xConfig.eChannel == eChannelRing )
+        {
+            if( xSpscRingReceive( &xEventRing, &ulSource, portMAX_DELAY ) == pdPASS )
+            {
+                prvHandled( 1U );
+            }
+        }
+        else
+        {
+            xMember = xQueueSelectFromSet( xQueueSet, portMAX_DELAY );
+
+            if( xQueueReceive( xMember, &ucEvent, 0 ) == pdPASS )
+            {
+                prvHandled( 1U );
+            }
+        }
+    }
+}
+
+static void prvProducerTask( void * pvParameters )
+{
+    unsigned long ulRound;
+    uint64_t ullStart;
+    uint32_t ulSource, ulTickRound;
+    uint8_t ucEvent = 1U;
+    unsigned uSource;
+
+    ( void ) pvParameters;
+
+    for( ulRound = 0; ulRound < xConfig.ulRounds; ulRound++ )
+    {
+        /* Released by the tick, see vSimTickElapsed(). */
+        if( xConfig.eChannel == eChannelRing )
+        {
+            ( void ) xSpscRingReceive( &xRoundRing, &ulTickRound, portMAX_DELAY );
+        }
+        else
+        {
+            ( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+        }
+
+        ullRoundStart = prvNow();
+
+        for( uSource = 0; uSource < xConfig.uSources; uSource++ )
+        {
+            ullStart = prvNow();
+
+            if( xConfig.eChannel == eChannelNotify )
+            {
+                ( void ) xTaskNotify( xConsumer, 1UL << uSource, eSetBits );
+            }
+            else if( xConfig.eChannel == eChannelRing )
+            {
+                ulSource = ( uint32_t ) uSource;
+                ( void ) xSpscRingSend( &xEventRing, &ulSource, 0 );
+            }
+            else
+            {
+                ( void ) xQueueSend( xQueues[ uSource ], &ucEvent, 0 );
+            }
+
+            prvAddSample( eBenchPost, ullStart, prvNow(), 1U );
+        }
+    }
+
+    /* Once the consumer has handled the last round. */
+    if( xConfig.eChannel == eChannelRing )
+    {
+        ( void ) xSpscRingReceive( &xRoundRing, &ulTickRound, portMAX_DELAY );
+    }
+    else
+    {
+        ( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+    }
+
+    prvReport();
+    fflush( stdout );
+    _exit( ( ulHandled == 0U ) ? 0 : 1 );
+}
+/*-----------------------------------------------------------*/
+
+/* Taken by the idle task once the producer and the consumer are both
+ * blocked, starts the next round. */
+void vSimTickElapsed( void )
+{
+    static uint32_t ulTickRound = 0U;
+    BaseType_t xWoken = pdFALSE;
+
+    if( xProducer == NULL )
+    {
+        return;
+    }
+
+    if( xConfig.eChannel == eChannelRing )
+    {
+        /* Only while the producer waits, so the ring never holds more than
+         * the round it is about to start. */
+        if( uxSpscRingRecordsWaiting( &xRoundRing ) == 0U )
+        {
+            ( void ) xSpscRingSendFromISR( &xRoundRing, &ulTickRound, &xWoken );
+            ulTickRound++;
+        }
+    }
+    else
+    {
+        vTaskNotifyGiveFromISR( xProducer, &xWoken );
+    }
+
+    portYIELD_FROM_ISR( xWoken );
+}
+
+void vSimContextSwitched( void )
+{
+}
+
+void vSimPeripheralInterrupt( void )
+{
+}
+/*-----------------------------------------------------------*/
+
+static void prvRun( void )
+{
+    TickType_t xConsumerPeriod = xConfig.iBatch ? benchLONG_PERIOD : benchSHORT_PERIOD;
+    TickType_t xProducerPeriod = xConfig.iBatch ? benchSHORT_PERIOD : benchLONG_PERIOD;
+    unsigned uSource;
+
+    /* Neither task completes a job, so their deadlines stay those of the
+     * first jobs, which are in the order of the periods. */
+    if( ( xTaskPeriodicCreate( prvConsumerTask, "Cons", configMINIMAL_STACK_SIZE, NULL, benchPRIORITY, &xConsumer, xConsumerPeriod ) != pdPASS ) ||
+        ( xTaskPeriodicCreate( prvProducerTask, "Prod", configMINIMAL_STACK_SIZE, NULL, benchPRIORITY, &xProducer, xProducerPeriod ) != pdPASS ) )
+    {
+        fprintf( stderr, "ipcbench: could not create the tasks\n" );
+        exit( 1 );
+    }
+
+    vSpscRingInit( &xEventRing, ulEventStorage, benchRING_RECORDS, sizeof( uint32_t ) );
+    vSpscRingInit( &xRoundRing, ulRoundStorage, benchRING_RECORDS, sizeof( uint32_t ) );
+
+    if( xConfig.eChannel == eChannelQueue )
+    {
+        xQueueSet = xQueueCreateSet( xConfig.uSources );
+
+        for( uSource = 0; uSource < xConfig.uSources; uSource++ )
+        {
+            xQueues[ uSource ] = xQueueCreate( 1, sizeof( uint8_t ) );
+
+            if( ( xQueueSet == NULL ) || ( xQueues[ uSource ] == NULL ) ||
+                ( xQueueAddToSet( xQueues[ uSource ], xQueueSet ) != pdPASS ) )
+            {
+                fprintf( stderr, "ipcbench: could not create the queues\n" );
+                exit( 1 );
+            }
+        }
+    }
+
+    /* Does not return, the producer ends the run. */
+    vTaskStartScheduler();
+    exit( 1 );
+}
+/*-----------------------------------------------------------*/
+
+static int prvSplit( char * pcList,
+                     char * pcItems[],
+                     int iMax )
+{
+    int iCount = 0;
+    char * pcItem = strtok( pcList, "," );
+
+    while( ( pcItem != NULL ) && ( iCount < iMax ) )
+    {
+        pcItems[ iCount++ ] = pcItem;
+        pcItem = strtok( NULL, "," );
+    }
+
+    return iCount;
+}
+
+int main( int argc,
+          char * argv[] )
+{
+    char cPaths[ 128 ] = "queue,notify,ring", cOrders[ 128 ] = "preempt,batch", cSources[ 128 ] = "1,3,8";
+    char * pcPaths[ benchMAX_LIST ], * pcOrders[ benchMAX_LIST ], * pcSources[ benchMAX_LIST ];
+    int iPaths, iOrders, iSources, p, o, s, iStatus;
+    unsigned long ulRounds = 100000UL;
+    pid_t xChild;
+
+    for( p = 1; p < argc; p++ )
+    {
+        if( ( strcmp( argv[ p ], "--path" ) == 0 ) && ( p + 1 < argc ) )
+        {
+            snprintf( cPaths, sizeof( cPaths ), "%s", argv[ ++p ] );
+        }
+        else if( ( strcmp( argv[ p ], "--order" ) == 0 ) && ( p + 1 < argc ) )
+        {
+            snprintf( cOrders, sizeof( cOrders ), "%s", argv[ ++p ] );
+        }
+        else if( ( strcmp( argv[ p ], "--sources" ) == 0 ) && ( p + 1 < argc ) )
+        {
+            snprintf( cSources, sizeof( cSources ), "%s", argv[ ++p ] );
+        }
+        else if( ( strcmp( argv[ p ], "--rounds" ) == 0 ) && ( p + 1 < argc ) )
+        {
+            ulRounds = strtoul( argv[ ++p ], NULL, 0 );
+        }
+        else
+        {
+            fprintf( stderr, "usage: %s [--path queue,notify,ring] [--order preempt,batch] [--sources 1,3,8] [--rounds N]\n", argv[ 0 ] );
+            return 2;
+        }
+    }
+
+    iPaths = prvSplit( cPaths, pcPaths, benchMAX_LIST );
+    iOrders = prvSplit( cOrders, pcOrders, benchMAX_LIST );
+    iSources = prvSplit( cSources, pcSources, benchMAX_LIST );
+
+    printf( "channel,order,sources,rounds,path,samples,mean_ns,p50_ns,p99_ns,max_ns\n" );
+
+    for( p = 0; p < iPaths; p++ )
+    {
+        for( o = 0; o < iOrders; o++ )
+        {
+            for( s = 0; s < iSources; s++ )
+            {
+                for( xConfig.eChannel = eChannelQueue; xConfig.eChannel < eChannels; xConfig.eChannel++ )
+                {
+                    if( strcmp( pcPaths[ p ], pcChannelNames[ xConfig.eChannel ] ) == 0 )
+                    {
+                        break;
+                    }
+                }
+
+                xConfig.iBatch = ( strcmp( pcOrders[ o ], "batch" ) == 0 );
+                xConfig.uSources = ( unsigned ) atoi( pcSources[ s ] );
+                xConfig.ulRounds = ulRounds;
+
+                if( xConfig.eChannel == eChannels )
+                {
+                    fprintf( stderr, "ipcbench: unknown path %s\n", pcPaths[ p ] );
+                    return 2;
+                }
+
+                if( ( xConfig.uSources == 0U ) || ( xConfig.uSources > benchMAX_SOURCES ) )
+                {
+                    fprintf( stderr, "ipcbench: between 1 and %d sources\n", benchMAX_SOURCES );
+                    return 2;
+                }
+
+                fflush( stdout );
+                xChild = fork();
+
+                if( xChild == 0 )
+                {
+                    prvCalibrateClock();
+                    prvRun();
+                }
+
+                if( ( xChild < 0 ) || ( waitpid( xChild, &iStatus, 0 ) < 0 ) ||
+                    !WIFEXITED( iStatus ) || ( WEXITSTATUS( iStatus ) != 0 ) )
+                {
+                    fprintf( stderr, "ipcbench: run of %s, %s, %u sources failed\n",
+                             pcPaths[ p ], pcOrders[ o ], xConfig.uSources );
+                    return 1;
+                }
+            }
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,81 @@
+/*
+ * Host port of the kernel.
+ *
+ * There is no context switch: the program driving the kernel plays the
+ * running task itself.  A yield only sets xPortYieldPending, and the driver
+ * calls vTaskSwitchContext() when it finds it set.  Nothing preempts the
+ * driver, so the critical sections only count their nesting.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Set by a yield, cleared by the driver once it has switched context. */
+volatile BaseType_t xPortYieldPending = pdFALSE;
+
+static UBaseType_t uxCriticalNesting = 0;
+/*-----------------------------------------------------------*/
+
+StackType_t * pxPortInitialiseStack( StackType_t * pxTopOfStack,
+                                     TaskFunction_t pxCode,
+                                     void * pvParameters )
+{
+    ( void ) pxCode;
+    ( void ) pvParameters;
+
+    return pxTopOfStack;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xPortStartScheduler( void )
+{
+    /* Return to vTaskStartScheduler(), and from there to the driver, with the
+     * scheduler running and pxCurrentTCB selected. */
+    return pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+void vPortEndScheduler( void )
+{
+}
+/*-----------------------------------------------------------*/
+
+void vPortYield( void )
+{
+    xPortYieldPending = pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+void vPortEnterCritical( void )
+{
+    uxCriticalNesting++;
+}
+/*-----------------------------------------------------------*/
+
+void vPortExitCritical( void )
+{
+    configASSERT( uxCriticalNesting > 0U );
+    uxCriticalNesting--;
+}
+/*-----------------------------------------------------------*/
+
+void vPortDisableInterrupts( void )
+{
+}
+/*-----------------------------------------------------------*/
+
+void vPortEnableInterrupts( void )
+{
+}
+/*-----------------------------------------------------------*/
+
+void vAssertCalled( const char * pcFile,
+                    unsigned long ulLine )
+{
+    fprintf( stderr, "assertion failed at %s:%lu\n", pcFile, ulLine );
+    abort();
+}
@@ -0,0 +1,305 @@
+/*
+ * Stress check of the single producer, single consumer ring buffer of
+ * Edited Files/spsc_ring.c.
+ *
+ * Two rings run at once, on the contexts of the simulator port (sim/port.c):
+ *
+ *   8-byte    records of 8 bytes, a sequence number, from a producer task to
+ *             a consumer task, in a ring of 8.  Both sides block, the
+ *             producer on the full ring, the consumer on the empty one, at
+ *             random with or without a timeout, and retry when it runs out.
+ *   3-byte    records of 3 bytes, copied with memcpy(), from an interrupt to
+ *             a consumer task, in a ring of 4 whose storage is not aligned.
+ *             The interrupt sends into the full ring too, and sends the same
+ *             record again at its next interrupt when it was refused.
+ *
+ * Each side runs for a random number of cycles between two records, and now
+ * and then sleeps for a few ticks, so that the rings go from empty to full
+ * and back all along the run.  The interrupts are those of a peripheral of
+ * the simulator, see ullSimPeripheralCycles.
+ *
+ * Each consumer checks that every record arrives, once and in order, and
+ * each timeout that it waited for the ticks it was given.  A lost wakeup
+ * leaves a side blocked for good on a wait without a timeout, and the other
+ * one on the full or empty ring, so that the ring stops.  The check fails if
+ * either ring misses a record, if a timeout came early, if a case above never
+ * happened, or if a ring goes checkSTALL_TICKS without a record.
+ *
+ * Usage:
+ *   ringcheck
+ * Exit status is 1 when the check fails.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "spsc_ring.h"
+
+#include "sim/sim.h"
+
+#if ( configUSE_EDF_SCHEDULER != 1 )
+    #error The check needs the EDF scheduler
+#endif
+
+#define checkPRIORITY            ( configUSE_EDF_HYBRID == 1 ? configEDF_BAND_PRIORITY : 1 )
+
+/* Records sent through each ring. */
+#define checkRECORDS8            200000UL
+#define checkRECORDS3            50000UL
+
+#define checkSLOTS8              8U
+#define checkSLOTS3              4U
+
+/* Ticks each side waits for at most at a time, when it waits with a
+ * timeout, one time in two. */
+#define checkSEND_TICKS          1U
+#define checkRECEIVE_TICKS       2U
+
+/* Cycles a side runs for between two records, at most, and one chance in
+ * how many that it sleeps instead. */
+#define checkRUN_CYCLES          ( simTICK_CYCLES / 4U )
+#define checkSLEEP_ONE_IN        64U
+#define checkSLEEP_TICKS         4U
+
+/* Far more than the longest pause of either side. */
+#define checkSTALL_TICKS         ( ( TickType_t ) 100U )
+
+typedef struct
+{
+    uint8_t ucBytes[ 3 ];
+} Record3_t;
+
+typedef struct
+{
+    const char * pcName;
+    unsigned long ulReceived;
+    unsigned long ulSendTimeouts;
+    unsigned long ulReceiveTimeouts;
+    unsigned long ulErrors;
+    TickType_t xLastRecord;
+} RingStats_t;
+
+static SpscRing_t xRing8;
+static uint64_t ullStorage8[ checkSLOTS8 ];
+
+/* Records of 3 bytes need no alignment, so the storage starts 2 bytes off. */
+static SpscRing_t xRing3;
+static uint8_t ucStorage3[ 2U + ( checkSLOTS3 * sizeof( Record3_t ) ) ];
+
+static RingStats_t xStats8 = { "8-byte", 0UL, 0UL, 0UL, 0UL, 0U };
+static RingStats_t xStats3 = { "3-byte", 0UL, 0UL, 0UL, 0UL, 0U };
+
+/* Records the interrupt has sent. */
+static unsigned long ulSent3 = 0UL;
+
+static uint32_t ulRandomState = 1U;
+
+/* The sim.h interface sim/port.c calls back into. */
+TickType_t xSimEndTick = portMAX_DELAY;
+BaseType_t xSimFastForward = pdFALSE;
+/*-----------------------------------------------------------*/
+
+/* xorshift32, the same sequence on every run. */
+static uint32_t prvRandom( void )
+{
+    ulRandomState ^= ulRandomState << 13;
+    ulRandomState ^= ulRandomState >> 17;
+    ulRandomState ^= ulRandomState << 5;
+    return ulRandomState;
+}
+
+/* Runs for a random time, or now and then sleeps for a few ticks. */
+static void prvPause( void )
+{
+    if( ( prvRandom() % checkSLEEP_ONE_IN ) == 0U )
+    {
+        vTaskDelay( 1U + ( prvRandom() % checkSLEEP_TICKS ) );
+    }
+    else
+    {
+        vSimRun( prvRandom() % checkRUN_CYCLES );
+    }
+}
+
+/* Waits without a timeout one time in two. */
+static TickType_t prvTicksToWait( TickType_t xTicks )
+{
+    return ( ( prvRandom() & 1U ) == 0U ) ? portMAX_DELAY : xTicks;
+}
+
+static void prvRecord3( Record3_t * pxRecord,
+                        unsigned long ulNumber )
+{
+    pxRecord->ucBytes[ 0 ] = ( uint8_t ) ulNumber;
+    pxRecord->ucBytes[ 1 ] = ( uint8_t ) ( ulNumber >> 8 );
+    pxRecord->ucBytes[ 2 ] = ( uint8_t ) ( ulNumber >> 16 );
+}
+
+/* The interrupt of the 3-byte ring, at a random time from now. */
+static void prvArmInterrupt( void )
+{
+    ullSimPeripheralCycles = ullSimCycles + ( prvRandom() % ( 2U * checkRUN_CYCLES ) );
+}
+
+static void prvReport( void )
+{
+    const RingStats_t * pxStats[] = { &xStats8, &xStats3 };
+    const unsigned long ulRecords[] = { checkRECORDS8, checkRECORDS3 };
+    int iFailed = 0;
+    int i;
+
+    for( i = 0; i < 2; i++ )
+    {
+        printf( "%-8s %lu/%lu records, %lu errors, %lu send %s, %lu receive timeouts\n",
+                pxStats[ i ]->pcName, pxStats[ i ]->ulReceived, ulRecords[ i ], pxStats[ i ]->ulErrors,
+                pxStats[ i ]->ulSendTimeouts, ( i == 0 ) ? "timeouts" : "into a full ring",
+                pxStats[ i ]->ulReceiveTimeouts );
+        iFailed |= ( pxStats[ i ]->ulReceived != ulRecords[ i ] ) || ( pxStats[ i ]->ulErrors != 0UL ) ||
+                   ( pxStats[ i ]->ulSendTimeouts == 0UL ) || ( pxStats[ i ]->ulReceiveTimeouts == 0UL );
+    }
+
+    fflush( stdout );
+    _exit( iFailed );
+}
+/*-----------------------------------------------------------*/
+
+static void prvProducer8Task( void * pvParameters )
+{
+    uint64_t ullRecord;
+
+    ( void ) pvParameters;
+
+    for( ullRecord = 0U; ullRecord < checkRECORDS8; ullRecord++ )
+    {
+        while( xSpscRingSend( &xRing8, &ullRecord, prvTicksToWait( checkSEND_TICKS ) ) != pdPASS )
+        {
+            xStats8.ulSendTimeouts++;
+        }
+
+        prvPause();
+    }
+
+    vTaskSuspend( NULL );
+}
+
+static void prvConsumerTask( void * pvParameters )
+{
+    SpscRing_t * pxRing = ( SpscRing_t * ) pvParameters;
+    RingStats_t * pxStats = ( pxRing == &xRing8 ) ? &xStats8 : &xStats3;
+    unsigned long ulRecords = ( pxRing == &xRing8 ) ? checkRECORDS8 : checkRECORDS3;
+    uint64_t ullRecord;
+    Record3_t xRecord, xExpected;
+    TickType_t xStart, xTicksToWait;
+    BaseType_t xReceived;
+
+    while( pxStats->ulReceived < ulRecords )
+    {
+        xStart = xTaskGetTickCount();
+        xTicksToWait = prvTicksToWait( checkRECEIVE_TICKS );
+        xReceived = xSpscRingReceive( pxRing, ( pxRing == &xRing8 ) ? ( void * ) &ullRecord : ( void * ) &xRecord, xTicksToWait );
+
+        if( xReceived != pdPASS )
+        {
+            pxStats->ulReceiveTimeouts++;
+            pxStats->ulErrors += ( xTicksToWait == portMAX_DELAY ) || ( ( xTaskGetTickCount() - xStart ) < checkRECEIVE_TICKS );
+            continue;
+        }
+
+        if( pxRing == &xRing8 )
+        {
+            pxStats->ulErrors += ( ullRecord != ( uint64_t ) pxStats->ulReceived );
+        }
+        else
+        {
+            prvRecord3( &xExpected, pxStats->ulReceived );
+            pxStats->ulErrors += ( memcmp( &xRecord, &xExpected, sizeof( Record3_t ) ) != 0 );
+        }
+
+        pxStats->ulReceived++;
+        pxStats->xLastRecord = xTaskGetTickCount();
+        prvPause();
+    }
+
+    if( ( xStats8.ulReceived == checkRECORDS8 ) && ( xStats3.ulReceived == checkRECORDS3 ) )
+    {
+        prvReport();
+    }
+
+    vTaskSuspend( NULL );
+}
+/*-----------------------------------------------------------*/
+
+void vSimPeripheralInterrupt( void )
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    Record3_t xRecord;
+
+    prvRecord3( &xRecord, ulSent3 );
+
+    if( xSpscRingSendFromISR( &xRing3, &xRecord, &xHigherPriorityTaskWoken ) == pdPASS )
+    {
+        ulSent3++;
+    }
+    else
+    {
+        xStats3.ulSendTimeouts++;
+    }
+
+    /* Now and then a pause of a few ticks, for the consumer to time out. */
+    if( ulSent3 < checkRECORDS3 )
+    {
+        prvArmInterrupt();
+
+        if( ( prvRandom() % checkSLEEP_ONE_IN ) == 0U )
+        {
+            ullSimPeripheralCycles += ( uint64_t ) checkSLEEP_TICKS * simTICK_CYCLES;
+        }
+    }
+
+    portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+}
+
+void vSimTickElapsed( void )
+{
+    const TickType_t xNow = xTaskGetTickCount();
+
+    if( ( ( xStats8.ulReceived < checkRECORDS8 ) && ( ( xNow - xStats8.xLastRecord ) > checkSTALL_TICKS ) ) ||
+        ( ( xStats3.ulReceived < checkRECORDS3 ) && ( ( xNow - xStats3.xLastRecord ) > checkSTALL_TICKS ) ) )
+    {
+        printf( "ringcheck: a ring stopped at tick %lu\n", ( unsigned long ) xNow );
+        prvReport();
+    }
+}
+
+void vSimContextSwitched( void )
+{
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+    vSpscRingInit( &xRing8, ullStorage8, checkSLOTS8, sizeof( uint64_t ) );
+    vSpscRingInit( &xRing3, &( ucStorage3[ 2 ] ), checkSLOTS3, sizeof( Record3_t ) );
+
+    /* The consumers have the earlier deadlines, so a record wakes them at
+     * once, and the 3-byte one, fed by the interrupt, the earliest. */
+    if( ( xTaskPeriodicCreate( prvConsumerTask, "Cons3", configMINIMAL_STACK_SIZE, &xRing3, checkPRIORITY, NULL, 10U ) != pdPASS ) ||
+        ( xTaskPeriodicCreate( prvConsumerTask, "Cons8", configMINIMAL_STACK_SIZE, &xRing8, checkPRIORITY, NULL, 20U ) != pdPASS ) ||
+        ( xTaskPeriodicCreate( prvProducer8Task, "Prod8", configMINIMAL_STACK_SIZE, NULL, checkPRIORITY, NULL, 30U ) != pdPASS ) )
+    {
+        fprintf( stderr, "ringcheck: could not create the tasks\n" );
+        return 1;
+    }
+
+    prvArmInterrupt();
+
+    /* Does not return, the last consumer to finish ends the run. */
+    vTaskStartScheduler();
+    return 1;
+}
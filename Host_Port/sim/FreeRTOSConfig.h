@@ -0,0 +1,54 @@
+/*
+ * FreeRTOS configuration of the simulator.
+ *
+ * The simulator runs the configuration of the target, Edited Files/
+ * FreeRTOSConfig.h, so only what the host needs is changed after it.  The
+ * headers it includes for the target, lpc21xx.h and GPIO.h, are the ones of
+ * this directory.
+ */
+
+#ifndef SIM_FREERTOS_CONFIG_H
+#define SIM_FREERTOS_CONFIG_H
+
+#include "../../Edited Files/FreeRTOSConfig.h"
+
+/* Pointers and stack words are twice as wide on the host. */
+#undef configTOTAL_HEAP_SIZE
+#define configTOTAL_HEAP_SIZE    ( ( size_t ) 64 * 1024 )
+
+/* make sim-static runs the application without a heap: the tasks of main.c
+ * and the idle task are created in static memory.  The stats formatting
+ * functions allocate, and main.c uses none of them. */
+#if defined( simSTATIC_ALLOCATION ) && ( simSTATIC_ALLOCATION == 1 )
+    #undef configSUPPORT_DYNAMIC_ALLOCATION
+    #define configSUPPORT_DYNAMIC_ALLOCATION        0
+    #undef configSUPPORT_STATIC_ALLOCATION
+    #define configSUPPORT_STATIC_ALLOCATION         1
+    #undef configUSE_STATS_FORMATTING_FUNCTIONS
+    #define configUSE_STATS_FORMATTING_FUNCTIONS    0
+#endif
+
+/* make check-latency runs the application with the latency statistics of
+ * vTaskGetLatencyStats(), left out on the target, see --latency in sim.c. */
+#if defined( simLATENCY_STATS ) && ( simLATENCY_STATS == 1 )
+    #undef configUSE_TASK_LATENCY_STATS
+    #define configUSE_TASK_LATENCY_STATS    1
+#endif
+
+/* Timer 1 counts at a little under 60 kHz on the target, far too coarse for
+ * the jobs of 20 us of main.c, so the trace is stamped in microseconds of
+ * virtual time instead.  The run-time stats keep the counter of the target. */
+extern uint64_t ullSimCycles;
+#undef configTRACE_RECORDER_TIMESTAMP
+#define configTRACE_RECORDER_TIMESTAMP()    ( ( uint32_t ) ( ullSimCycles / ( configCPU_CLOCK_HZ / 1000000UL ) ) )
+#undef configTRACE_RECORDER_TIMER_HZ
+#define configTRACE_RECORDER_TIMER_HZ       1000000UL
+
+/* The port needs to know which task is the idle task, see sim/port.c. */
+#define INCLUDE_xTaskGetIdleTaskHandle    1
+
+/* A failed assertion stops the simulator with the file and line. */
+extern void vAssertCalled( const char * pcFile, unsigned long ulLine );
+#define configASSERT( x )    if( ( x ) == 0 ) vAssertCalled( __FILE__, __LINE__ )
+
+#endif /* SIM_FREERTOS_CONFIG_H */
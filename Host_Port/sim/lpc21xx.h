@@ -0,0 +1,23 @@
+/*
+ * The LPC21xx registers used by the application and the kernel
+ * configuration, for the simulator.
+ *
+ * Timer 1 counts the virtual time of sim.h.  Its control, prescale and the
+ * VPB divider are plain variables that the counter is computed from when it
+ * is read.  The other registers are not simulated.
+ */
+
+#ifndef LPC21XX_H
+#define LPC21XX_H
+
+/* Timer 1 */
+extern volatile unsigned long T1TCR;
+extern volatile unsigned long T1PR;
+#define T1TC    ( ulSimTimer1Counter() )
+
+/* VPB divider */
+extern volatile unsigned long VPBDIV;
+
+unsigned long ulSimTimer1Counter( void );
+
+#endif /* LPC21XX_H */
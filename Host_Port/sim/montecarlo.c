@@ -0,0 +1,446 @@
+/*
+ * Execution time distributions and Monte Carlo runs of the simulator.
+ *
+ * Each job draws its execution time from the distribution of its task, so a
+ * run with a given seed is still the same on every host.  iMonteCarloFork()
+ * repeats the run with consecutive seeds, each in a child process, as many at
+ * once as there are workers, and adds up the jobs and deadline misses the
+ * runs report per task.  Two probabilities are printed for each task, with
+ * their 95 % Wilson score intervals:
+ *
+ *   per job    misses over jobs.  The interval takes the jobs as independent,
+ *              which they are not quite: a miss makes a miss of the next jobs
+ *              more likely, so it is on the narrow side.
+ *   per run    runs with at least one miss over runs.  The runs are
+ *              independent, so this interval is exact, and it is the one to
+ *              read when no miss was seen at all.
+ */
+
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "montecarlo.h"
+
+/* Largest task number a run can report. */
+#define mcMAX_TASKS    ( 64U )
+
+/* z of the 95 % intervals. */
+#define mcZ            ( 1.959964 )
+
+typedef struct xMC_WORKER
+{
+    pid_t xPid;
+    int iFd;
+} McWorker_t;
+
+typedef struct xMC_TOTAL
+{
+    char cName[ 16 ];
+    uint64_t ullJobs;
+    uint64_t ullMisses;
+    uint32_t ulRunsWithMisses;
+} McTotal_t;
+
+static uint64_t ullRandom = 1U;
+/*-----------------------------------------------------------*/
+
+void vRandomSeed( uint64_t ullSeed )
+{
+    ullRandom = ( ullSeed * 0x9E3779B97F4A7C15ULL ) | 1U;
+}
+/*-----------------------------------------------------------*/
+
+/* xorshift64*, as in bench.c. */
+static double prvRandom( void )
+{
+    ullRandom ^= ullRandom >> 12;
+    ullRandom ^= ullRandom << 25;
+    ullRandom ^= ullRandom >> 27;
+    return ( double ) ( ( ullRandom * 2685821657736338717ULL ) >> 11 ) / 9007199254740992.0;
+}
+/*-----------------------------------------------------------*/
+
+static int prvParseHistogram( SimExecTime_t * pxExecTime,
+                              const char * pcPath )
+{
+    FILE * pxFile = fopen( pcPath, "r" );
+    char cLine[ 128 ];
+    double dValue, dCount, dTotal = 0.0;
+    int iFields;
+
+    if( pxFile == NULL )
+    {
+        perror( pcPath );
+        return -1;
+    }
+
+    pxExecTime->pdValues = malloc( mcMAX_HISTOGRAM_VALUES * sizeof( double ) );
+    pxExecTime->pdCumulative = malloc( mcMAX_HISTOGRAM_VALUES * sizeof( double ) );
+    pxExecTime->ulValues = 0U;
+
+    while( fgets( cLine, sizeof( cLine ), pxFile ) != NULL )
+    {
+        iFields = sscanf( cLine, "%lf %lf", &dValue, &dCount );
+
+        if( ( iFields < 1 ) || ( cLine[ strspn( cLine, " \t" ) ] == '#' ) )
+        {
+            continue;
+        }
+
+        if( iFields == 1 )
+        {
+            dCount = 1.0;
+        }
+
+        if( ( dValue < 0.0 ) || ( dCount < 0.0 ) || ( pxExecTime->ulValues == mcMAX_HISTOGRAM_VALUES ) )
+        {
+            fprintf( stderr, "%s: negative value or count, or more than %u values\n", pcPath, mcMAX_HISTOGRAM_VALUES );
+            fclose( pxFile );
+            return -1;
+        }
+
+        dTotal += dCount;
+        pxExecTime->pdValues[ pxExecTime->ulValues ] = dValue;
+        pxExecTime->pdCumulative[ pxExecTime->ulValues ] = dTotal;
+        pxExecTime->ulValues++;
+    }
+
+    fclose( pxFile );
+
+    if( dTotal <= 0.0 )
+    {
+        fprintf( stderr, "%s: no values\n", pcPath );
+        return -1;
+    }
+
+    pxExecTime->eKind = eExecHistogram;
+
+    return 0;
+}
+/*-----------------------------------------------------------*/
+
+int iExecTimeParse( SimExecTime_t * pxExecTime,
+                    const char * pcSpec )
+{
+    char * pcEnd;
+    int iFields;
+
+    memset( pxExecTime, 0, sizeof( *pxExecTime ) );
+
+    if( strncmp( pcSpec, "hist:", 5 ) == 0 )
+    {
+        return prvParseHistogram( pxExecTime, pcSpec + 5 );
+    }
+    else if( strncmp( pcSpec, "uniform:", 8 ) == 0 )
+    {
+        pxExecTime->eKind = eExecUniform;
+        iFields = sscanf( pcSpec + 8, "%lf:%lf", &pxExecTime->dA, &pxExecTime->dB );
+
+        if( ( iFields == 2 ) && ( pxExecTime->dA >= 0.0 ) && ( pxExecTime->dB >= pxExecTime->dA ) )
+        {
+            return 0;
+        }
+    }
+    else if( strncmp( pcSpec, "normal:", 7 ) == 0 )
+    {
+        pxExecTime->eKind = eExecNormal;
+        iFields = sscanf( pcSpec + 7, "%lf:%lf:%lf", &pxExecTime->dA, &pxExecTime->dB, &pxExecTime->dMax );
+
+        if( ( iFields >= 2 ) && ( pxExecTime->dA >= 0.0 ) && ( pxExecTime->dB >= 0.0 ) &&
+            ( ( iFields == 2 ) || ( pxExecTime->dMax >= pxExecTime->dA ) ) )
+        {
+            return 0;
+        }
+    }
+    else
+    {
+        pxExecTime->eKind = eExecFixed;
+        pxExecTime->dA = strtod( pcSpec, &pcEnd );
+
+        if( ( pcEnd != pcSpec ) && ( *pcEnd == '\0' ) && ( pxExecTime->dA >= 0.0 ) )
+        {
+            return 0;
+        }
+    }
+
+    fprintf( stderr, "sim: bad execution time '%s'\n", pcSpec );
+
+    return -1;
+}
+/*-----------------------------------------------------------*/
+
+double dExecTimeSample( const SimExecTime_t * pxExecTime )
+{
+    double dSample, dTarget;
+    uint32_t ulLow, ulHigh, ulMid;
+    int iTry;
+
+    switch( pxExecTime->eKind )
+    {
+        case eExecUniform:
+            return pxExecTime->dA + ( prvRandom() * ( pxExecTime->dB - pxExecTime->dA ) );
+
+        case eExecNormal:
+
+            /* Box-Muller, drawn again when out of bounds. */
+            for( iTry = 0; iTry < 100; iTry++ )
+            {
+                dSample = pxExecTime->dA + ( pxExecTime->dB * sqrt( -2.0 * log( 1.0 - prvRandom() ) ) * cos( 2.0 * M_PI * prvRandom() ) );
+
+                if( ( dSample >= 0.0 ) && ( ( pxExecTime->dMax == 0.0 ) || ( dSample <= pxExecTime->dMax ) ) )
+                {
+                    return dSample;
+                }
+            }
+
+            return pxExecTime->dA;
+
+        case eExecHistogram:
+
+            /* The first value whose cumulative weight is above the target. */
+            dTarget = prvRandom() * pxExecTime->pdCumulative[ pxExecTime->ulValues - 1U ];
+            ulLow = 0U;
+            ulHigh = pxExecTime->ulValues - 1U;
+
+            while( ulLow < ulHigh )
+            {
+                ulMid = ( ulLow + ulHigh ) / 2U;
+
+                if( pxExecTime->pdCumulative[ ulMid ] > dTarget )
+                {
+                    ulHigh = ulMid;
+                }
+                else
+                {
+                    ulLow = ulMid + 1U;
+                }
+            }
+
+            return pxExecTime->pdValues[ ulLow ];
+
+        case eExecFixed:
+        default:
+            return pxExecTime->dA;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvWilson( uint64_t ullHits,
+                       uint64_t ullTrials,
+                       double * pdLow,
+                       double * pdHigh )
+{
+    double dN = ( double ) ullTrials;
+    double dP = ( double ) ullHits / dN;
+    double dZ2 = mcZ * mcZ;
+    double dDenominator = 1.0 + ( dZ2 / dN );
+    double dCentre = ( dP + ( dZ2 / ( 2.0 * dN ) ) ) / dDenominator;
+    double dHalf = ( mcZ * sqrt( ( ( dP * ( 1.0 - dP ) ) / dN ) + ( dZ2 / ( 4.0 * dN * dN ) ) ) ) / dDenominator;
+
+    /* The bounds are exactly 0 and 1 when no trial or every trial hit. */
+    *pdLow = ( ullHits != 0U ) ? dCentre - dHalf : 0.0;
+    *pdHigh = ( ullHits != ullTrials ) ? dCentre + dHalf : 1.0;
+}
+/*-----------------------------------------------------------*/
+
+static int prvCollect( int iFd,
+                       McTotal_t * pxTotals )
+{
+    SimTaskResult_t xResults[ mcMAX_TASKS ];
+    uint32_t ulTasks, ulTask;
+    ssize_t xBytes;
+
+    if( ( read( iFd, &ulTasks, sizeof( ulTasks ) ) != ( ssize_t ) sizeof( ulTasks ) ) || ( ulTasks > mcMAX_TASKS ) )
+    {
+        return -1;
+    }
+
+    xBytes = ( ssize_t ) ( ulTasks * sizeof( SimTaskResult_t ) );
+
+    if( read( iFd, xResults, ( size_t ) xBytes ) != xBytes )
+    {
+        return -1;
+    }
+
+    for( ulTask = 0U; ulTask < ulTasks; ulTask++ )
+    {
+        if( pxTotals[ ulTask ].cName[ 0 ] == '\0' )
+        {
+            memcpy( pxTotals[ ulTask ].cName, xResults[ ulTask ].cName, sizeof( pxTotals[ ulTask ].cName ) );
+        }
+
+        pxTotals[ ulTask ].ullJobs += xResults[ ulTask ].ulJobs;
+        pxTotals[ ulTask ].ullMisses += xResults[ ulTask ].ulMisses;
+
+        if( xResults[ ulTask ].ulMisses != 0U )
+        {
+            pxTotals[ ulTask ].ulRunsWithMisses++;
+        }
+    }
+
+    return 0;
+}
+/*-----------------------------------------------------------*/
+
+static void prvPrintTotals( const McTotal_t * pxTotals,
+                            uint32_t ulRuns,
+                            uint64_t ullFirstSeed )
+{
+    uint32_t ulTask;
+    double dLow, dHigh, dRunLow, dRunHigh;
+
+    printf( "%lu runs, seeds %llu to %llu\n", ( unsigned long ) ulRuns,
+            ( unsigned long long ) ullFirstSeed, ( unsigned long long ) ( ullFirstSeed + ulRuns - 1U ) );
+    printf( "%-4s %-16s %10s %8s %11s %-25s %9s %s\n", "#", "name", "jobs", "misses",
+            "per job", "95% CI", "per run", "95% CI" );
+
+    for( ulTask = 0U; ulTask < mcMAX_TASKS; ulTask++ )
+    {
+        if( pxTotals[ ulTask ].ullJobs == 0U )
+        {
+            continue;
+        }
+
+        prvWilson( pxTotals[ ulTask ].ullMisses, pxTotals[ ulTask ].ullJobs, &dLow, &dHigh );
+        prvWilson( pxTotals[ ulTask ].ulRunsWithMisses, ulRuns, &dRunLow, &dRunHigh );
+
+        printf( "%-4lu %-16s %10llu %8llu %11.3e [%.3e, %.3e] %9.4f [%.4f, %.4f]\n",
+                ( unsigned long ) ulTask, pxTotals[ ulTask ].cName,
+                ( unsigned long long ) pxTotals[ ulTask ].ullJobs, ( unsigned long long ) pxTotals[ ulTask ].ullMisses,
+                ( double ) pxTotals[ ulTask ].ullMisses / ( double ) pxTotals[ ulTask ].ullJobs, dLow, dHigh,
+                ( double ) pxTotals[ ulTask ].ulRunsWithMisses / ( double ) ulRuns, dRunLow, dRunHigh );
+    }
+}
+/*-----------------------------------------------------------*/
+
+int iMonteCarloFork( uint32_t ulRuns,
+                     uint32_t ulWorkers,
+                     uint64_t ullFirstSeed,
+                     uint64_t * pullSeed,
+                     int * piResultFd )
+{
+    McWorker_t * pxWorkers = calloc( ulWorkers, sizeof( McWorker_t ) );
+    McTotal_t * pxTotals = calloc( mcMAX_TASKS, sizeof( McTotal_t ) );
+    uint32_t ulStarted = 0U, ulActive = 0U, ulDone = 0U, ulFailed = 0U, ulWorker;
+    int iPipe[ 2 ], iStatus;
+    pid_t xPid;
+
+    if( ( pxWorkers == NULL ) || ( pxTotals == NULL ) )
+    {
+        return -1;
+    }
+
+    while( ulDone < ulRuns )
+    {
+        /* Keep every worker busy. */
+        for( ulWorker = 0U; ( ulWorker < ulWorkers ) && ( ulStarted < ulRuns ); ulWorker++ )
+        {
+            if( pxWorkers[ ulWorker ].xPid != 0 )
+            {
+                continue;
+            }
+
+            if( pipe( iPipe ) != 0 )
+            {
+                perror( "pipe" );
+                return -1;
+            }
+
+            fflush( stdout );
+            fflush( stderr );
+            xPid = fork();
+
+            if( xPid == 0 )
+            {
+                close( iPipe[ 0 ] );
+                *pullSeed = ullFirstSeed + ulStarted;
+                *piResultFd = iPipe[ 1 ];
+                return 1;
+            }
+
+            close( iPipe[ 1 ] );
+
+            if( xPid < 0 )
+            {
+                perror( "fork" );
+                close( iPipe[ 0 ] );
+                return -1;
+            }
+
+            pxWorkers[ ulWorker ].xPid = xPid;
+            pxWorkers[ ulWorker ].iFd = iPipe[ 0 ];
+            ulStarted++;
+            ulActive++;
+        }
+
+        /* The results are far smaller than a pipe, so the children never
+         * block on them and are collected once they have exited. */
+        do
+        {
+            xPid = waitpid( -1, &iStatus, 0 );
+        } while( ( xPid < 0 ) && ( errno == EINTR ) );
+
+        for( ulWorker = 0U; ( ulWorker < ulWorkers ) && ( pxWorkers[ ulWorker ].xPid != xPid ); ulWorker++ )
+        {
+        }
+
+        if( ( xPid < 0 ) || ( ulWorker == ulWorkers ) )
+        {
+            perror( "waitpid" );
+            return -1;
+        }
+
+        if( !WIFEXITED( iStatus ) || ( WEXITSTATUS( iStatus ) != 0 ) || ( prvCollect( pxWorkers[ ulWorker ].iFd, pxTotals ) != 0 ) )
+        {
+            ulFailed++;
+        }
+
+        close( pxWorkers[ ulWorker ].iFd );
+        pxWorkers[ ulWorker ].xPid = 0;
+        ulActive--;
+        ulDone++;
+    }
+
+    if( ulFailed != 0U )
+    {
+        fprintf( stderr, "sim: %lu of %lu runs failed, left out of the results\n",
+                 ( unsigned long ) ulFailed, ( unsigned long ) ulRuns );
+    }
+
+    if( ulFailed < ulRuns )
+    {
+        prvPrintTotals( pxTotals, ulRuns - ulFailed, ullFirstSeed );
+    }
+
+    free( pxWorkers );
+    free( pxTotals );
+
+    return ( ulFailed == 0U ) ? 0 : -1;
+}
+/*-----------------------------------------------------------*/
+
+void vMonteCarloReport( int iResultFd,
+                        const SimTaskResult_t * pxResults,
+                        uint32_t ulTasks )
+{
+    int iStatus = 0;
+
+    if( ulTasks > mcMAX_TASKS )
+    {
+        ulTasks = mcMAX_TASKS;
+    }
+
+    if( ( write( iResultFd, &ulTasks, sizeof( ulTasks ) ) != ( ssize_t ) sizeof( ulTasks ) ) ||
+        ( write( iResultFd, pxResults, ulTasks * sizeof( SimTaskResult_t ) ) != ( ssize_t ) ( ulTasks * sizeof( SimTaskResult_t ) ) ) )
+    {
+        iStatus = 1;
+    }
+
+    close( iResultFd );
+    _exit( iStatus );
+}
@@ -0,0 +1,79 @@
+/*
+ * Execution time distributions and Monte Carlo runs of the simulator, see
+ * montecarlo.c.
+ */
+
+#ifndef MONTECARLO_H
+#define MONTECARLO_H
+
+#include <stdint.h>
+
+/* Largest number of values of a measured histogram. */
+#define mcMAX_HISTOGRAM_VALUES    ( 4096U )
+
+typedef enum
+{
+    eExecFixed = 0,
+    eExecUniform,
+    eExecNormal,
+    eExecHistogram
+} eExecKind;
+
+/* Distribution of the execution time of the jobs of a task, in microseconds. */
+typedef struct xSIM_EXEC_TIME
+{
+    eExecKind eKind;
+    double dA;             /*< Fixed: the time.  Uniform: the minimum.  Normal: the mean. */
+    double dB;             /*< Uniform: the maximum.  Normal: the standard deviation. */
+    double dMax;           /*< Normal: the bound the samples are cut at, 0 for none. */
+    uint32_t ulValues;     /*< Histogram: the number of values. */
+    double * pdValues;     /*< Histogram: the values, and the cumulative weights up to each. */
+    double * pdCumulative;
+} SimExecTime_t;
+
+/* What a run reports for each task, by task number. */
+typedef struct xSIM_TASK_RESULT
+{
+    char cName[ 16 ];
+    uint32_t ulJobs;
+    uint32_t ulMisses;
+} SimTaskResult_t;
+
+/* Parses a distribution:
+ *
+ *   US                      fixed
+ *   uniform:MIN:MAX         uniform between MIN and MAX
+ *   normal:MEAN:SD[:MAX]    normal, cut at 0 and at MAX, as Simso's ACET and
+ *                           et_stddev bounded by the WCET
+ *   hist:FILE               measured: one value per line, each optionally
+ *                           followed by its count
+ *
+ * Returns 0, or -1 with a message on the standard error. */
+int iExecTimeParse( SimExecTime_t * pxExecTime,
+                    const char * pcSpec );
+
+/* Draws an execution time, in microseconds. */
+double dExecTimeSample( const SimExecTime_t * pxExecTime );
+
+/* Seeds the generator of dExecTimeSample(). */
+void vRandomSeed( uint64_t ullSeed );
+
+/* Runs the simulation ulRuns times, in up to ulWorkers processes at once,
+ * each in a process of its own so that it starts from a fresh kernel.
+ *
+ * Returns 1 in each child, which is to run the simulation with the seed
+ * *pullSeed and end it with vMonteCarloReport() on *piResultFd.  Returns in
+ * the parent once every run is done and the deadline miss probabilities have
+ * been printed on the standard output: 0, or -1 if some runs failed. */
+int iMonteCarloFork( uint32_t ulRuns,
+                     uint32_t ulWorkers,
+                     uint64_t ullFirstSeed,
+                     uint64_t * pullSeed,
+                     int * piResultFd );
+
+/* Sends the results of a run to the parent and ends the child. */
+void vMonteCarloReport( int iResultFd,
+                        const SimTaskResult_t * pxResults,
+                        uint32_t ulTasks );
+
+#endif /* MONTECARLO_H */
@@ -0,0 +1,342 @@
+/*
+ * Simulator port of the kernel, see sim.h.
+ *
+ * Each task runs on its own ucontext, with a stack allocated from the host:
+ * the stack the kernel allocates for the task only holds a pointer to that
+ * context, stored at its top by pxPortInitialiseStack().  A context switch is
+ * a swapcontext() from one task to the other, on a yield or at the end of the
+ * tick interrupt.
+ *
+ * There is a single host thread and no signal, so nothing runs in parallel
+ * with the kernel.  The tick interrupt is taken at the points where the
+ * target would have interrupts enabled and time passing: while a task
+ * consumes execution time in vSimRun(), and each time the idle task leaves a
+ * critical section, which it does once per loop.  The interrupts of the
+ * peripherals are taken at the same points.  The critical nesting is part of
+ * the context of each task, as in the ARM7 port.
+ *
+ * With xSimFastForward the idle task does not wait tick by tick when every
+ * other task is blocked.  The time jumps to the tick before the next task is
+ * due to wake up, given by xTaskGetExpectedIdleTime(), and the ticks in
+ * between are caught up in bulk.  The last tick is taken as usual after one
+ * more loop of the idle task, so that the idle task has moved its deadline
+ * on, as it would have done at each tick, by the time the task is released.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <ucontext.h>
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "sim.h"
+
+/* Host stack of each task.  The C library of the host needs far more stack
+ * than the target code, so the depth passed to xTaskCreate() is not used. */
+#define simTHREAD_STACK_SIZE    ( 256U * 1024U )
+
+typedef struct xSIM_THREAD
+{
+    ucontext_t xContext;
+    TaskFunction_t pxCode;
+    void * pvParameters;
+    UBaseType_t uxCriticalNesting; /*< Saved while the task is switched out. */
+} SimThread_t;
+
+/* The first member of a TCB is its top of stack. */
+extern void * volatile pxCurrentTCB;
+
+uint64_t ullSimCycles = 0;
+uint32_t ulSimContextSwitches = 0;
+uint32_t ulSimFastForwardTicks = 0;
+uint64_t ullSimPeripheralCycles = UINT64_MAX;
+
+static uint64_t ullNextTickCycles = simTICK_CYCLES;
+static UBaseType_t uxCriticalNesting = 0;
+static BaseType_t xSchedulerStarted = pdFALSE;
+static BaseType_t xInInterrupt = pdFALSE;
+static BaseType_t xYieldFromInterrupt = pdFALSE;
+static SimThread_t * pxIdleThread = NULL;
+/*-----------------------------------------------------------*/
+
+static SimThread_t * prvThreadOf( void * pvTCB )
+{
+    StackType_t * pxTopOfStack = *( ( StackType_t ** ) pvTCB );
+
+    return ( SimThread_t * ) *pxTopOfStack;
+}
+/*-----------------------------------------------------------*/
+
+static void prvTaskEntry( void )
+{
+    SimThread_t * pxThread = prvThreadOf( pxCurrentTCB );
+
+    /* Tasks start with interrupts enabled. */
+    uxCriticalNesting = 0;
+    pxThread->pxCode( pxThread->pvParameters );
+
+    /* Tasks must not return. */
+    vAssertCalled( __FILE__, __LINE__ );
+}
+/*-----------------------------------------------------------*/
+
+static void prvSwitchContext( void )
+{
+    SimThread_t * pxFrom = prvThreadOf( pxCurrentTCB );
+    SimThread_t * pxTo;
+
+    vTaskSwitchContext();
+    pxTo = prvThreadOf( pxCurrentTCB );
+
+    if( pxTo != pxFrom )
+    {
+        ulSimContextSwitches++;
+        vSimContextSwitched();
+
+        pxFrom->uxCriticalNesting = uxCriticalNesting;
+        swapcontext( &( pxFrom->xContext ), &( pxTo->xContext ) );
+
+        /* Switched back in. */
+        uxCriticalNesting = pxFrom->uxCriticalNesting;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvFastForward( TickType_t xTicks )
+{
+    ullSimCycles = ullNextTickCycles + ( ( uint64_t ) ( xTicks - 1U ) * simTICK_CYCLES );
+    ullNextTickCycles = ullSimCycles + simTICK_CYCLES;
+    ulSimFastForwardTicks += xTicks;
+
+    /* Runs as the tick interrupt would, so that the critical sections of the
+     * catch up do not come back here. */
+    xInInterrupt = pdTRUE;
+    ( void ) xTaskCatchUpTicks( xTicks );
+    vSimTickElapsed();
+    xInInterrupt = pdFALSE;
+
+    if( xYieldFromInterrupt != pdFALSE )
+    {
+        xYieldFromInterrupt = pdFALSE;
+        prvSwitchContext();
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvTickInterrupt( void )
+{
+    BaseType_t xSwitchRequired;
+
+    ullNextTickCycles += simTICK_CYCLES;
+
+    xInInterrupt = pdTRUE;
+    xSwitchRequired = xTaskIncrementTick();
+    vSimTickElapsed();
+    xInInterrupt = pdFALSE;
+
+    if( ( xSwitchRequired != pdFALSE ) || ( xYieldFromInterrupt != pdFALSE ) )
+    {
+        xYieldFromInterrupt = pdFALSE;
+        prvSwitchContext();
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvPeripheralInterrupt( void )
+{
+    if( ullSimPeripheralCycles > ullSimCycles )
+    {
+        ullSimCycles = ullSimPeripheralCycles;
+    }
+
+    ullSimPeripheralCycles = UINT64_MAX;
+
+    xInInterrupt = pdTRUE;
+    vSimPeripheralInterrupt();
+    xInInterrupt = pdFALSE;
+
+    if( xYieldFromInterrupt != pdFALSE )
+    {
+        xYieldFromInterrupt = pdFALSE;
+        prvSwitchContext();
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vSimRun( uint64_t ullCycles )
+{
+    uint64_t ullEnd;
+
+    configASSERT( ( uxCriticalNesting == 0U ) && ( xInInterrupt == pdFALSE ) );
+
+    for( ; ; )
+    {
+        ullEnd = ullSimCycles + ullCycles;
+
+        if( ( ullSimPeripheralCycles < ullNextTickCycles ) && ( ullSimPeripheralCycles <= ullEnd ) )
+        {
+            ullCycles = ( ullSimPeripheralCycles > ullSimCycles ) ? ullEnd - ullSimPeripheralCycles : ullCycles;
+
+            /* Returns once this task runs again. */
+            prvPeripheralInterrupt();
+        }
+        else if( ullNextTickCycles <= ullEnd )
+        {
+            ullCycles = ullEnd - ullNextTickCycles;
+            ullSimCycles = ullNextTickCycles;
+            prvTickInterrupt();
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    ullSimCycles += ullCycles;
+}
+/*-----------------------------------------------------------*/
+
+void vSimStall( uint32_t ulCycles )
+{
+    /* Stop short of the next tick, which is only taken where interrupts are
+     * enabled. */
+    if( ( ullSimCycles + ulCycles ) < ullNextTickCycles )
+    {
+        ullSimCycles += ulCycles;
+    }
+    else
+    {
+        ullSimCycles = ullNextTickCycles - 1U;
+    }
+}
+/*-----------------------------------------------------------*/
+
+StackType_t * pxPortInitialiseStack( StackType_t * pxTopOfStack,
+                                     TaskFunction_t pxCode,
+                                     void * pvParameters )
+{
+    SimThread_t * pxThread = malloc( sizeof( SimThread_t ) );
+    void * pvStack = malloc( simTHREAD_STACK_SIZE );
+
+    configASSERT( ( pxThread != NULL ) && ( pvStack != NULL ) );
+
+    getcontext( &( pxThread->xContext ) );
+    pxThread->xContext.uc_stack.ss_sp = pvStack;
+    pxThread->xContext.uc_stack.ss_size = simTHREAD_STACK_SIZE;
+    pxThread->xContext.uc_link = NULL;
+    makecontext( &( pxThread->xContext ), prvTaskEntry, 0 );
+
+    pxThread->pxCode = pxCode;
+    pxThread->pvParameters = pvParameters;
+    pxThread->uxCriticalNesting = 0;
+
+    *pxTopOfStack = ( StackType_t ) pxThread;
+
+    return pxTopOfStack;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xPortStartScheduler( void )
+{
+    pxIdleThread = prvThreadOf( xTaskGetIdleTaskHandle() );
+    xSchedulerStarted = pdTRUE;
+
+    ulSimContextSwitches++;
+    vSimContextSwitched();
+    setcontext( &( prvThreadOf( pxCurrentTCB )->xContext ) );
+
+    /* Should not get here. */
+    return pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+void vPortEndScheduler( void )
+{
+}
+/*-----------------------------------------------------------*/
+
+void vPortYield( void )
+{
+    /* From an interrupt the switch is done on its way out. */
+    if( xInInterrupt != pdFALSE )
+    {
+        xYieldFromInterrupt = pdTRUE;
+    }
+    else
+    {
+        prvSwitchContext();
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vPortEnterCritical( void )
+{
+    uxCriticalNesting++;
+}
+/*-----------------------------------------------------------*/
+
+void vPortExitCritical( void )
+{
+    TickType_t xIdleTicks = 0U;
+
+    configASSERT( uxCriticalNesting > 0U );
+
+    /* The idle task only runs when no other task can, so the time runs to
+     * the next tick, or further on when every other task is blocked. */
+    if( ( uxCriticalNesting == 1U ) &&
+        ( xInInterrupt == pdFALSE ) &&
+        ( xSchedulerStarted != pdFALSE ) &&
+        ( prvThreadOf( pxCurrentTCB ) == pxIdleThread ) )
+    {
+        if( ( xSimFastForward != pdFALSE ) && ( ullSimPeripheralCycles == UINT64_MAX ) )
+        {
+            /* Still in the critical section. */
+            xIdleTicks = xTaskGetExpectedIdleTime();
+
+            if( xIdleTicks > ( xSimEndTick - xTaskGetTickCount() ) )
+            {
+                xIdleTicks = xSimEndTick - xTaskGetTickCount();
+            }
+        }
+
+        uxCriticalNesting = 0U;
+
+        if( ullSimPeripheralCycles < ullNextTickCycles )
+        {
+            prvPeripheralInterrupt();
+        }
+        else if( xIdleTicks > 1U )
+        {
+            prvFastForward( xIdleTicks - 1U );
+        }
+        else
+        {
+            ullSimCycles = ullNextTickCycles;
+            prvTickInterrupt();
+        }
+    }
+    else
+    {
+        uxCriticalNesting--;
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vPortDisableInterrupts( void )
+{
+}
+/*-----------------------------------------------------------*/
+
+void vPortEnableInterrupts( void )
+{
+}
+/*-----------------------------------------------------------*/
+
+void vAssertCalled( const char * pcFile,
+                    unsigned long ulLine )
+{
+    fprintf( stderr, "assertion failed at %s:%lu\n", pcFile, ulLine );
+    abort();
+}
@@ -0,0 +1,37 @@
+/*
+ * Serial driver of the simulator, in place of the one of the Keil project.
+ * The strings sent go through the transmit buffer of serial_tx.c to the
+ * stand-in UART of sim.c, which records each line with the time it has been
+ * sent by, and nothing is ever received.
+ */
+
+#ifndef SERIAL_COMMS_H
+#define SERIAL_COMMS_H
+
+typedef enum
+{
+	ser50,
+	ser75,
+	ser110,
+	ser134,
+	ser150,
+	ser200,
+	ser300,
+	ser600,
+	ser1200,
+	ser1800,
+	ser2400,
+	ser4800,
+	ser9600,
+	ser19200,
+	ser38400,
+	ser57600,
+	ser115200
+} eBaud;
+
+void xSerialPortInitMinimal( unsigned long ulWantedBaud);
+signed portBASE_TYPE vSerialPutString(const signed char * const pcString, unsigned short usStringLength);
+signed portBASE_TYPE xSerialGetChar(signed char *pcRxedChar);
+void xSerialPutChar(signed char cOutChar);
+
+#endif
@@ -0,0 +1,887 @@
+/*
+ * Simulator of the application of Edited Files/main.c on the host.
+ *
+ * main.c is compiled unmodified into this file, with its main() renamed, and
+ * runs on the port of sim/port.c in the virtual time of sim.h.  The busy
+ * loops of the load tasks take no time on the host, so each job is charged
+ * its execution time when it completes, that is when the task calls
+ * vTaskDelayUntil().  The default execution times are the WCETs of the Simso
+ * model, Simso_Project/EDF_6_Tasks_Project.xml, by task number: the order of
+ * creation, as in the model and in the scheduling trace.  They can be drawn
+ * from a distribution instead, for each job, see montecarlo.h.
+ *
+ * The peripherals are recorders:
+ *
+ *   --uart FILE     the lines sent on the serial port, each after the time
+ *                   in microseconds its line feed left the UART (default:
+ *                   standard output)
+ *   --vcd FILE      the pin levels, as a VCD waveform for GTKWave
+ *   --trace FILE    the scheduling trace, as a dump for
+ *                   Host_Tools/trace_decode.py
+ *   --latency FILE  the response time and start jitter of each task at the
+ *                   end of the run, see vTaskGetLatencyReport().  Needs the
+ *                   build of make check-latency, see sim/FreeRTOSConfig.h
+ *
+ * The serial port is the buffered transmit of Edited Files/serial_tx.c on a
+ * stand-in for UART1: a transmit FIFO of 16 characters, sent at the baud rate
+ * main.c sets, 10 bits each, and refilled by the THRE interrupt once it is
+ * empty, see vSimPeripheralInterrupt().
+ *
+ * and the inputs are given on the command line:
+ *
+ *   --ms N          virtual time to run for, in milliseconds (default 1000)
+ *   --exec N=SPEC   execution time of the jobs of task N, in microseconds,
+ *                   fixed or a distribution, see iExecTimeParse()
+ *   --seed S        seed of the execution times drawn (default 1)
+ *   --input PINn=MS[,MS...]
+ *                   toggles the input PINn of port 0, low at the start, at
+ *                   each of the times, in milliseconds
+ *   --every-tick    takes every tick, instead of skipping the idle intervals
+ *                   when every task is blocked, see xSimFastForward.  Only
+ *                   the tick and idle hooks, and so the pins they drive, see
+ *                   a difference.
+ *
+ * The summary of the run is printed on the standard error.  Everything else
+ * is the same from one run to the next with the same seed.
+ *
+ * With --runs, the simulation is a Monte Carlo experiment instead, see
+ * montecarlo.c:
+ *
+ *   --runs R        runs the simulation R times, with the seeds S to S+R-1,
+ *                   and prints the deadline miss probability of each task
+ *   --workers W     runs at most W at once (default: the number of CPUs)
+ *   --warmup MS     leaves out the jobs released in the first MS milliseconds
+ *                   of each run, such as those missed at the start because
+ *                   the tasks are started in the reverse order of creation
+ *
+ * The recorders are left out, only the probabilities are printed.
+ *
+ * Examples:
+ *   build/sim --ms 2000 --input PIN0=120,480 --vcd pins.vcd --trace trace.bin
+ *   build/sim --ms 600000 --exec 5=normal:4000:800:5000 --exec 6=hist:load_2.txt --runs 1000 --warmup 100
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+#include "sim.h"
+#include "montecarlo.h"
+#include "serial_tx.h"
+
+/* Each job of the application completes with a call to vTaskDelayUntil(),
+ * which is where it is charged its execution time. */
+static void prvJobCompleted( void );
+
+#undef vTaskDelayUntil
+#define vTaskDelayUntil( pxPreviousWakeTime, xTimeIncrement )                   \
+    do {                                                                        \
+        prvJobCompleted();                                                      \
+        ( void ) xTaskDelayUntil( ( pxPreviousWakeTime ), ( xTimeIncrement ) ); \
+    } while( 0 )
+
+#define main    app_main
+#include "main.c"
+#undef main
+
+/* Largest task number that can be given an execution time. */
+#define simMAX_TASKS            ( 32U )
+
+/* Largest number of times an input pin can be toggled. */
+#define simMAX_TOGGLES          ( 64U )
+
+/* Events of the scheduling trace kept for --trace, the last ones of the run. */
+#define simTRACE_EVENTS         ( 65535U )
+
+/* Cycles taken by a call to the GPIO or serial driver. */
+#define simPERIPHERAL_CYCLES    ( 20U )
+
+/* Characters the transmit FIFO of the UART holds. */
+#define simUART_FIFO_SIZE       ( 16U )
+
+/* Bits on the line for a character: start, 8 data and stop. */
+#define simUART_CHAR_BITS       ( 10U )
+
+/* Size of the report of --latency, about 80 characters a task. */
+#define simLATENCY_REPORT_SIZE  ( 2048U )
+
+/* Longest line recorded for --uart, longer ones are split. */
+#define simUART_LINE_SIZE       ( 256U )
+
+#define simCYCLES_PER_US        ( ( uint64_t ) configCPU_CLOCK_HZ / 1000000ULL )
+
+typedef struct xSIM_INPUT
+{
+    uint32_t ulToggles;
+    uint64_t ullToggleCycles[ simMAX_TOGGLES ];
+} SimInput_t;
+
+/* Execution time of the jobs of each task, by task number. */
+static SimExecTime_t xExecTimes[ simMAX_TASKS + 1U ] =
+{
+    { eExecFixed, 0.0 },   { eExecFixed, 20.0 },   { eExecFixed, 19.0 }, { eExecFixed, 19.0 },
+    { eExecFixed, 21.0 },  { eExecFixed, 5000.0 }, { eExecFixed, 12000.0 }
+};
+
+/* Jobs released and deadlines missed from xWarmupTick on, by task number. */
+static SimTaskResult_t xTaskResults[ simMAX_TASKS + 1U ];
+static TickType_t xWarmupTick = 0;
+
+/* The pipe to the parent in a Monte Carlo run, -1 otherwise. */
+static int iResultFd = -1;
+
+static SimInput_t xInputs[ 16 ];
+
+static FILE * pxUartFile = NULL;
+static FILE * pxVcdFile = NULL;
+static const char * pcTracePath = NULL;
+static const char * pcLatencyPath = NULL;
+
+static uint32_t ulPinLevels[ 2 ] = { 0UL, 0UL };
+static uint64_t ullVcdTime = 0;
+static uint32_t ulUartWrites = 0;
+static uint32_t ulUartChars = 0;
+static uint32_t ulUartPeakWaiting = 0;
+static uint64_t ullUartCharCycles = 1;
+static uint64_t ullUartLineFreeCycles = 0; /* When the last character loaded has left. */
+static char cUartLine[ simUART_LINE_SIZE ];
+static size_t xUartLineLength = 0;
+static uint32_t ulDeadlineMisses = 0;
+static struct timespec xHostStart;
+
+#if ( configUSE_TRACE_RECORDER == 1 )
+    static TraceEvent_t xTraceEvents[ simTRACE_EVENTS ];
+    static uint32_t ulTraceDrained = 0;
+    static uint32_t ulTraceKept = 0;
+    static uint32_t ulTraceLost = 0;
+#endif
+
+TickType_t xSimEndTick = ( TickType_t ) configTICK_RATE_HZ;
+BaseType_t xSimFastForward = pdTRUE;
+
+/* Registers of lpc21xx.h. */
+volatile unsigned long T1TCR = 0UL;
+volatile unsigned long T1PR = 0UL;
+volatile unsigned long VPBDIV = 0UL;
+/*-----------------------------------------------------------*/
+
+static uint64_t prvCyclesToNanoseconds( uint64_t ullCycles )
+{
+    return ( ( ullCycles / configCPU_CLOCK_HZ ) * 1000000000ULL ) +
+           ( ( ( ullCycles % configCPU_CLOCK_HZ ) * 1000000000ULL ) / configCPU_CLOCK_HZ );
+}
+/*-----------------------------------------------------------*/
+
+static void prvJobCompleted( void )
+{
+    TaskStatus_t xStatus;
+
+    vTaskGetInfo( NULL, &xStatus, pdFALSE, eRunning );
+
+    if( xStatus.xTaskNumber <= simMAX_TASKS )
+    {
+        vSimRun( ( uint64_t ) ( ( dExecTimeSample( &( xExecTimes[ xStatus.xTaskNumber ] ) ) * ( double ) simCYCLES_PER_US ) + 0.5 ) );
+    }
+}
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TRACE_RECORDER == 1 )
+
+    /* Names the tasks in the results, from the traceEVT_TASK_NAME events. */
+    static void prvAddNameChars( char * pcName,
+                                 uint16_t usOffset,
+                                 uint32_t ulChars )
+    {
+        uint32_t x;
+
+        for( x = 0U; ( x < 4U ) && ( ( usOffset + x ) < ( sizeof( xTaskResults[ 0 ].cName ) - 1U ) ); x++ )
+        {
+            pcName[ usOffset + x ] = ( char ) ( ulChars >> ( 8U * x ) );
+        }
+    }
+
+#endif /* configUSE_TRACE_RECORDER */
+/*-----------------------------------------------------------*/
+
+static void prvDrainTrace( void )
+{
+    #if ( configUSE_TRACE_RECORDER == 1 )
+    {
+        uint32_t ulHead = xTraceRecorder.ulHead;
+        const TraceEvent_t * pxEvent;
+
+        /* The ring of the recorder is drained at each tick and context
+         * switch, so it should never have wrapped in between. */
+        if( ( ulHead - ulTraceDrained ) > configTRACE_RECORDER_EVENTS )
+        {
+            ulTraceLost += ( ulHead - ulTraceDrained ) - configTRACE_RECORDER_EVENTS;
+            ulTraceDrained = ulHead - configTRACE_RECORDER_EVENTS;
+        }
+
+        for( ; ulTraceDrained != ulHead; ulTraceDrained++ )
+        {
+            pxEvent = &( xTraceRecorder.xEvents[ ulTraceDrained & ( configTRACE_RECORDER_EVENTS - 1U ) ] );
+
+            if( pxEvent->ucType == traceEVT_DEADLINE_MISS )
+            {
+                ulDeadlineMisses++;
+            }
+
+            if( ( pxEvent->ucType == traceEVT_TASK_NAME ) && ( pxEvent->ucObject <= simMAX_TASKS ) )
+            {
+                prvAddNameChars( xTaskResults[ pxEvent->ucObject ].cName, pxEvent->usArg, pxEvent->ulTimestamp );
+            }
+            else if( ( pxEvent->ucObject <= simMAX_TASKS ) && ( xTaskGetTickCountFromISR() >= xWarmupTick ) )
+            {
+                if( ( pxEvent->ucType == traceEVT_RELEASE ) ||
+                    ( ( pxEvent->ucType == traceEVT_TASK_CREATE ) && ( pxEvent->usArg != 0U ) ) )
+                {
+                    xTaskResults[ pxEvent->ucObject ].ulJobs++;
+                }
+                else if( pxEvent->ucType == traceEVT_DEADLINE_MISS )
+                {
+                    xTaskResults[ pxEvent->ucObject ].ulMisses++;
+                }
+            }
+
+            xTraceEvents[ ulTraceKept % simTRACE_EVENTS ] = *pxEvent;
+            ulTraceKept++;
+        }
+    }
+    #endif /* configUSE_TRACE_RECORDER */
+}
+/*-----------------------------------------------------------*/
+
+static void prvWriteTrace( void )
+{
+    #if ( configUSE_TRACE_RECORDER == 1 )
+    {
+        FILE * pxFile;
+        uint32_t ulSlots = ( ulTraceKept < simTRACE_EVENTS ) ? ulTraceKept : simTRACE_EVENTS;
+        uint32_t ulHeader[ 5 ];
+
+        pxFile = fopen( pcTracePath, "wb" );
+
+        if( pxFile == NULL )
+        {
+            perror( pcTracePath );
+            exit( 2 );
+        }
+
+        /* The header of a recorder of ulSlots events, see trace_recorder.h,
+         * for a little endian host.  Event n is in slot n % ulSlots, as in the
+         * recorder. */
+        ulHeader[ 0 ] = xTraceRecorder.ulMagic;
+        ulHeader[ 1 ] = ( uint32_t ) xTraceRecorder.usVersion | ( ulSlots << 16 );
+        ulHeader[ 2 ] = xTraceRecorder.ulTimerHz;
+        ulHeader[ 3 ] = xTraceRecorder.ulTickHz;
+        ulHeader[ 4 ] = ulTraceKept;
+        fwrite( ulHeader, sizeof( ulHeader ), 1, pxFile );
+
+        fwrite( xTraceEvents, sizeof( TraceEvent_t ), ulSlots, pxFile );
+        fclose( pxFile );
+
+        if( ulSlots < ulTraceKept )
+        {
+            fprintf( stderr, "sim: the trace holds the last %lu of %lu events\n",
+                     ( unsigned long ) ulSlots, ( unsigned long ) ulTraceKept );
+        }
+
+        if( ulTraceLost != 0U )
+        {
+            fprintf( stderr, "sim: %lu trace events were overwritten before they were read\n",
+                     ( unsigned long ) ulTraceLost );
+        }
+    }
+    #else
+    {
+        fprintf( stderr, "sim: --trace needs configUSE_TRACE_RECORDER\n" );
+    }
+    #endif /* configUSE_TRACE_RECORDER */
+}
+/*-----------------------------------------------------------*/
+
+static void prvWriteLatencyReport( void )
+{
+    #if ( configUSE_TASK_LATENCY_STATS == 1 )
+    {
+        static char cReport[ simLATENCY_REPORT_SIZE ];
+        FILE * pxFile;
+
+        vTaskGetLatencyReport( cReport, pdFALSE );
+
+        pxFile = fopen( pcLatencyPath, "w" );
+
+        if( pxFile == NULL )
+        {
+            perror( pcLatencyPath );
+            exit( 2 );
+        }
+
+        fputs( cReport, pxFile );
+        fclose( pxFile );
+    }
+    #else
+    {
+        fprintf( stderr, "sim: --latency needs configUSE_TASK_LATENCY_STATS\n" );
+    }
+    #endif /* configUSE_TASK_LATENCY_STATS */
+}
+/*-----------------------------------------------------------*/
+
+static void prvFinish( void )
+{
+    struct timespec xHostEnd;
+    double dHostSeconds, dVirtualSeconds;
+
+    prvDrainTrace();
+
+    if( iResultFd >= 0 )
+    {
+        vMonteCarloReport( iResultFd, xTaskResults, simMAX_TASKS + 1U );
+    }
+
+    if( pcTracePath != NULL )
+    {
+        prvWriteTrace();
+    }
+
+    if( pcLatencyPath != NULL )
+    {
+        prvWriteLatencyReport();
+    }
+
+    if( pxVcdFile != NULL )
+    {
+        fprintf( pxVcdFile, "#%llu\n", ( unsigned long long ) prvCyclesToNanoseconds( ullSimCycles ) );
+        fclose( pxVcdFile );
+    }
+
+    if( pxUartFile != NULL )
+    {
+        fflush( pxUartFile );
+    }
+
+    clock_gettime( CLOCK_MONOTONIC, &xHostEnd );
+    dHostSeconds = ( double ) ( xHostEnd.tv_sec - xHostStart.tv_sec ) + ( ( double ) ( xHostEnd.tv_nsec - xHostStart.tv_nsec ) / 1e9 );
+    dVirtualSeconds = ( double ) ullSimCycles / ( double ) configCPU_CLOCK_HZ;
+
+    fprintf( stderr, "sim: %lu ticks (%lu fast forwarded), %lu context switches, %lu deadline misses, %lu UART writes "
+                     "(%lu characters sent, at most %lu buffered), CPU load %d %%\n",
+             ( unsigned long ) xTaskGetTickCountFromISR(), ( unsigned long ) ulSimFastForwardTicks, ( unsigned long ) ulSimContextSwitches,
+             ( unsigned long ) ulDeadlineMisses, ( unsigned long ) ulUartWrites, ( unsigned long ) ulUartChars,
+             ( unsigned long ) ulUartPeakWaiting, CPU_Load );
+    fprintf( stderr, "sim: %.3f s of virtual time in %.1f ms, %.0f times real time\n",
+             dVirtualSeconds, dHostSeconds * 1000.0, ( dHostSeconds > 0.0 ) ? dVirtualSeconds / dHostSeconds : 0.0 );
+
+    exit( 0 );
+}
+/*-----------------------------------------------------------*/
+
+void vSimTickElapsed( void )
+{
+    prvDrainTrace();
+
+    if( xTaskGetTickCountFromISR() >= xSimEndTick )
+    {
+        prvFinish();
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vSimContextSwitched( void )
+{
+    prvDrainTrace();
+}
+/*-----------------------------------------------------------*/
+
+unsigned long ulSimTimer1Counter( void )
+{
+    uint64_t ullDivider;
+
+    if( ( T1TCR & 0x3UL ) != 0x1UL )
+    {
+        /* Disabled or held in reset. */
+        return 0UL;
+    }
+
+    /* PCLK is CCLK / 4 after reset, VPBDIV 1 and 2 divide it by 1 and 2. */
+    ullDivider = ( ( VPBDIV & 0x3UL ) == 0x1UL ) ? 1U : ( ( ( VPBDIV & 0x3UL ) == 0x2UL ) ? 2U : 4U );
+
+    return ( unsigned long ) ( uint32_t ) ( ( ullSimCycles / ullDivider ) / ( ( uint64_t ) T1PR + 1U ) );
+}
+/*-----------------------------------------------------------*/
+
+void GPIO_init( void )
+{
+}
+/*-----------------------------------------------------------*/
+
+pinState_t GPIO_read( portX_t PortName, pinX_t pinNum )
+{
+    const SimInput_t * pxInput;
+    uint32_t ulToggle, ulLevel = 0U;
+
+    vSimStall( simPERIPHERAL_CYCLES );
+
+    if( ( PortName != PORT_0 ) || ( pinNum < PIN0 ) || ( pinNum > PIN15 ) )
+    {
+        return PIN_IS_LOW;
+    }
+
+    pxInput = &( xInputs[ pinNum - PIN0 ] );
+
+    if( pxInput->ulToggles == 0U )
+    {
+        /* Not an input, reads back the output. */
+        return ( ( ulPinLevels[ PortName ] >> pinNum ) & 1U ) ? PIN_IS_HIGH : PIN_IS_LOW;
+    }
+
+    for( ulToggle = 0U; ( ulToggle < pxInput->ulToggles ) && ( pxInput->ullToggleCycles[ ulToggle ] <= ullSimCycles ); ulToggle++ )
+    {
+        ulLevel ^= 1U;
+    }
+
+    return ( ulLevel != 0U ) ? PIN_IS_HIGH : PIN_IS_LOW;
+}
+/*-----------------------------------------------------------*/
+
+void GPIO_write( portX_t PortName, pinX_t PinNum, pinState_t pinState )
+{
+    uint32_t ulMask, ulLevel;
+    uint64_t ullNow;
+
+    vSimStall( simPERIPHERAL_CYCLES );
+
+    if( ( PortName > PORT_1 ) || ( PinNum < PIN0 ) || ( PinNum > PIN15 ) )
+    {
+        return;
+    }
+
+    ulMask = 1UL << PinNum;
+    ulLevel = ( pinState == PIN_IS_HIGH ) ? ulMask : 0UL;
+
+    if( ( ulPinLevels[ PortName ] & ulMask ) == ulLevel )
+    {
+        return;
+    }
+
+    ulPinLevels[ PortName ] ^= ulMask;
+
+    if( pxVcdFile != NULL )
+    {
+        ullNow = prvCyclesToNanoseconds( ullSimCycles );
+
+        if( ullNow != ullVcdTime )
+        {
+            fprintf( pxVcdFile, "#%llu\n", ( unsigned long long ) ullNow );
+            ullVcdTime = ullNow;
+        }
+
+        fprintf( pxVcdFile, "%c%c\n", ( ulLevel != 0UL ) ? '1' : '0', '!' + ( ( int ) PortName * 16 ) + ( PinNum - PIN0 ) );
+    }
+}
+/*-----------------------------------------------------------*/
+
+/* Records the character c, which has left the UART at ullCycles. */
+static void prvUartRecord( char c,
+                           uint64_t ullCycles )
+{
+    size_t x;
+
+    ulUartChars++;
+
+    if( pxUartFile == NULL )
+    {
+        return;
+    }
+
+    if( c != '\n' )
+    {
+        cUartLine[ xUartLineLength++ ] = c;
+
+        if( xUartLineLength < simUART_LINE_SIZE )
+        {
+            return;
+        }
+    }
+
+    /* The line feed itself is left out. */
+    fprintf( pxUartFile, "%10llu ", ( unsigned long long ) ( prvCyclesToNanoseconds( ullCycles ) / 1000ULL ) );
+
+    for( x = 0; x < xUartLineLength; x++ )
+    {
+        if( ( cUartLine[ x ] < ' ' ) || ( cUartLine[ x ] > '~' ) )
+        {
+            fprintf( pxUartFile, "\\x%02x", ( unsigned int ) ( unsigned char ) cUartLine[ x ] );
+        }
+        else
+        {
+            fputc( cUartLine[ x ], pxUartFile );
+        }
+    }
+
+    fputc( '\n', pxUartFile );
+    xUartLineLength = 0;
+}
+/*-----------------------------------------------------------*/
+
+/* The interrupt of the UART, taken when the last character of the FIFO moves
+ * to the shift register, so that the line does not pause between two loads,
+ * or when a writer starts the transmitter. */
+void vSimPeripheralInterrupt( void )
+{
+    char cChars[ simUART_FIFO_SIZE ];
+    UBaseType_t uxChars, x;
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    if( ( ullSimCycles + ullUartCharCycles ) < ullUartLineFreeCycles )
+    {
+        /* Started by a writer while the FIFO still holds characters: it is
+         * refilled at the THRE interrupt, as on the target. */
+        ullSimPeripheralCycles = ullUartLineFreeCycles - ullUartCharCycles;
+
+        return;
+    }
+
+    uxChars = uxSerialTxTakeFromISR( cChars, simUART_FIFO_SIZE, &xHigherPriorityTaskWoken );
+
+    for( x = 0; x < uxChars; x++ )
+    {
+        ullUartLineFreeCycles = ( ( ullUartLineFreeCycles > ullSimCycles ) ? ullUartLineFreeCycles : ullSimCycles ) + ullUartCharCycles;
+        prvUartRecord( cChars[ x ], ullUartLineFreeCycles );
+    }
+
+    if( uxChars != 0U )
+    {
+        ullSimPeripheralCycles = ullUartLineFreeCycles - ullUartCharCycles;
+    }
+
+    portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+}
+/*-----------------------------------------------------------*/
+
+void vSerialTxStart( void )
+{
+    /* The software interrupt of the target, taken as soon as interrupts are
+     * enabled and time passes. */
+    ullSimPeripheralCycles = ullSimCycles;
+}
+/*-----------------------------------------------------------*/
+
+void xSerialPortInitMinimal( unsigned long ulWantedBaud )
+{
+    ullUartCharCycles = ( ( uint64_t ) configCPU_CLOCK_HZ * simUART_CHAR_BITS ) / ( ( ulWantedBaud != 0UL ) ? ulWantedBaud : 1UL );
+    vSerialTxInit();
+}
+/*-----------------------------------------------------------*/
+
+/* As in Edited Files/serial.c. */
+signed portBASE_TYPE vSerialPutString( const signed char * const pcString,
+                                       unsigned short usStringLength )
+{
+    unsigned short usLength = 0;
+    BaseType_t xReturn;
+
+    vSimStall( simPERIPHERAL_CYCLES );
+    ulUartWrites++;
+
+    if( pcString == NULL )
+    {
+        return pdFALSE;
+    }
+
+    while( ( usLength < usStringLength ) && ( pcString[ usLength ] != '\0' ) )
+    {
+        usLength++;
+    }
+
+    xReturn = xSerialTxSend( ( const char * ) pcString, ( UBaseType_t ) usLength, configSERIAL_TX_BLOCK_TICKS );
+
+    if( uxSerialTxCharsWaiting() > ulUartPeakWaiting )
+    {
+        ulUartPeakWaiting = ( uint32_t ) uxSerialTxCharsWaiting();
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+signed portBASE_TYPE xSerialGetChar( signed char * pcRxedChar )
+{
+    ( void ) pcRxedChar;
+
+    return pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+void xSerialPutChar( signed char cOutChar )
+{
+    vSimStall( simPERIPHERAL_CYCLES );
+    ulUartWrites++;
+    ( void ) xSerialTxSend( ( const char * ) &cOutChar, 1U, configSERIAL_TX_BLOCK_TICKS );
+}
+/*-----------------------------------------------------------*/
+
+static FILE * prvOpen( const char * pcPath )
+{
+    FILE * pxFile = fopen( pcPath, "w" );
+
+    if( pxFile == NULL )
+    {
+        perror( pcPath );
+        exit( 2 );
+    }
+
+    return pxFile;
+}
+/*-----------------------------------------------------------*/
+
+static void prvWriteVcdHeader( void )
+{
+    int iPort, iPin;
+
+    fprintf( pxVcdFile, "$timescale 1 ns $end\n" );
+
+    for( iPort = 0; iPort < 2; iPort++ )
+    {
+        fprintf( pxVcdFile, "$scope module PORT_%d $end\n", iPort );
+
+        for( iPin = 0; iPin < 16; iPin++ )
+        {
+            fprintf( pxVcdFile, "$var wire 1 %c PIN%d $end\n", '!' + ( iPort * 16 ) + iPin, iPin );
+        }
+
+        fprintf( pxVcdFile, "$upscope $end\n" );
+    }
+
+    fprintf( pxVcdFile, "$enddefinitions $end\n#0\n$dumpvars\n" );
+
+    for( iPin = 0; iPin < 32; iPin++ )
+    {
+        fprintf( pxVcdFile, "0%c\n", '!' + iPin );
+    }
+
+    fprintf( pxVcdFile, "$end\n" );
+}
+/*-----------------------------------------------------------*/
+
+static int prvUsage( void )
+{
+    fprintf( stderr,
+             "usage: sim [--ms N] [--exec TASK=SPEC]... [--seed S] [--input PINn=MS[,MS...]]...\n"
+             "           [--every-tick] [--uart FILE] [--vcd FILE] [--trace FILE] [--latency FILE]\n"
+             "       sim [--ms N] [--exec TASK=SPEC]... [--seed S] [--input PINn=MS[,MS...]]...\n"
+             "           [--every-tick] --runs R [--workers W] [--warmup MS]\n"
+             "SPEC is US, uniform:MIN:MAX, normal:MEAN:SD[:MAX] or hist:FILE\n" );
+
+    return 2;
+}
+/*-----------------------------------------------------------*/
+
+static int prvParseInput( const char * pcArg )
+{
+    SimInput_t * pxInput;
+    char * pcEnd;
+    unsigned long ulPin;
+    double dMilliseconds;
+    uint64_t ullCycles;
+
+    if( strncmp( pcArg, "PIN", 3 ) != 0 )
+    {
+        return -1;
+    }
+
+    ulPin = strtoul( pcArg + 3, &pcEnd, 10 );
+
+    if( ( pcEnd == pcArg + 3 ) || ( *pcEnd != '=' ) || ( ulPin > 15UL ) )
+    {
+        return -1;
+    }
+
+    pxInput = &( xInputs[ ulPin ] );
+
+    do
+    {
+        dMilliseconds = strtod( pcEnd + 1, &pcEnd );
+        ullCycles = ( uint64_t ) ( dMilliseconds * ( double ) ( configCPU_CLOCK_HZ / 1000UL ) );
+
+        if( ( dMilliseconds < 0.0 ) || ( pxInput->ulToggles == simMAX_TOGGLES ) ||
+            ( ( pxInput->ulToggles != 0U ) && ( ullCycles < pxInput->ullToggleCycles[ pxInput->ulToggles - 1U ] ) ) )
+        {
+            return -1;
+        }
+
+        pxInput->ullToggleCycles[ pxInput->ulToggles++ ] = ullCycles;
+    } while( *pcEnd == ',' );
+
+    return ( *pcEnd == '\0' ) ? 0 : -1;
+}
+/*-----------------------------------------------------------*/
+
+int main( int argc,
+          char ** argv )
+{
+    int iArg, iResult;
+    char * pcEnd;
+    unsigned long ulTask, ulValue;
+    unsigned long ulRuns = 0UL, ulWorkers = ( unsigned long ) sysconf( _SC_NPROCESSORS_ONLN );
+    unsigned long long ullSeed = 1ULL;
+    uint64_t ullRunSeed;
+    const char * pcUartPath = NULL;
+    const char * pcVcdPath = NULL;
+    struct timespec xHostEnd;
+
+    for( iArg = 1; iArg < argc; iArg++ )
+    {
+        if( strcmp( argv[ iArg ], "--every-tick" ) == 0 )
+        {
+            xSimFastForward = pdFALSE;
+            continue;
+        }
+
+        if( iArg + 1 >= argc )
+        {
+            return prvUsage();
+        }
+
+        if( strcmp( argv[ iArg ], "--ms" ) == 0 )
+        {
+            ulValue = strtoul( argv[ ++iArg ], &pcEnd, 10 );
+
+            if( ( *pcEnd != '\0' ) || ( ulValue == 0UL ) )
+            {
+                return prvUsage();
+            }
+
+            xSimEndTick = ( TickType_t ) ( ( ( uint64_t ) ulValue * configTICK_RATE_HZ ) / 1000U );
+        }
+        else if( strcmp( argv[ iArg ], "--exec" ) == 0 )
+        {
+            ulTask = strtoul( argv[ ++iArg ], &pcEnd, 10 );
+
+            if( ( *pcEnd != '=' ) || ( ulTask == 0UL ) || ( ulTask > simMAX_TASKS ) )
+            {
+                return prvUsage();
+            }
+
+            if( iExecTimeParse( &( xExecTimes[ ulTask ] ), pcEnd + 1 ) != 0 )
+            {
+                return prvUsage();
+            }
+        }
+        else if( strcmp( argv[ iArg ], "--seed" ) == 0 )
+        {
+            ullSeed = strtoull( argv[ ++iArg ], &pcEnd, 10 );
+
+            if( *pcEnd != '\0' )
+            {
+                return prvUsage();
+            }
+        }
+        else if( strcmp( argv[ iArg ], "--runs" ) == 0 )
+        {
+            ulRuns = strtoul( argv[ ++iArg ], &pcEnd, 10 );
+
+            if( ( *pcEnd != '\0' ) || ( ulRuns == 0UL ) )
+            {
+                return prvUsage();
+            }
+        }
+        else if( strcmp( argv[ iArg ], "--workers" ) == 0 )
+        {
+            ulWorkers = strtoul( argv[ ++iArg ], &pcEnd, 10 );
+
+            if( ( *pcEnd != '\0' ) || ( ulWorkers == 0UL ) )
+            {
+                return prvUsage();
+            }
+        }
+        else if( strcmp( argv[ iArg ], "--warmup" ) == 0 )
+        {
+            ulValue = strtoul( argv[ ++iArg ], &pcEnd, 10 );
+
+            if( *pcEnd != '\0' )
+            {
+                return prvUsage();
+            }
+
+            xWarmupTick = ( TickType_t ) ( ( ( uint64_t ) ulValue * configTICK_RATE_HZ ) / 1000U );
+        }
+        else if( strcmp( argv[ iArg ], "--input" ) == 0 )
+        {
+            if( prvParseInput( argv[ ++iArg ] ) != 0 )
+            {
+                return prvUsage();
+            }
+        }
+        else if( strcmp( argv[ iArg ], "--uart" ) == 0 )
+        {
+            pcUartPath = argv[ ++iArg ];
+        }
+        else if( strcmp( argv[ iArg ], "--vcd" ) == 0 )
+        {
+            pcVcdPath = argv[ ++iArg ];
+        }
+        else if( strcmp( argv[ iArg ], "--trace" ) == 0 )
+        {
+            pcTracePath = argv[ ++iArg ];
+        }
+        else if( strcmp( argv[ iArg ], "--latency" ) == 0 )
+        {
+            pcLatencyPath = argv[ ++iArg ];
+        }
+        else
+        {
+            return prvUsage();
+        }
+    }
+
+    clock_gettime( CLOCK_MONOTONIC, &xHostStart );
+
+    if( ulRuns != 0UL )
+    {
+        if( ( pcUartPath != NULL ) || ( pcVcdPath != NULL ) || ( pcTracePath != NULL ) || ( pcLatencyPath != NULL ) )
+        {
+            fprintf( stderr, "sim: --runs leaves out the recorders\n" );
+            return prvUsage();
+        }
+
+        iResult = iMonteCarloFork( ( uint32_t ) ulRuns, ( uint32_t ) ulWorkers,
+                                   ( uint64_t ) ullSeed, &ullRunSeed, &iResultFd );
+
+        if( iResult != 1 )
+        {
+            clock_gettime( CLOCK_MONOTONIC, &xHostEnd );
+            fprintf( stderr, "sim: %lu runs in %.1f ms\n", ulRuns,
+                     ( ( double ) ( xHostEnd.tv_sec - xHostStart.tv_sec ) * 1000.0 ) + ( ( double ) ( xHostEnd.tv_nsec - xHostStart.tv_nsec ) / 1e6 ) );
+
+            return ( iResult == 0 ) ? 0 : 1;
+        }
+
+        /* A run of its own, which reports to the parent in prvFinish(). */
+        ullSeed = ullRunSeed;
+    }
+    else
+    {
+        pxUartFile = ( pcUartPath != NULL ) ? prvOpen( pcUartPath ) : stdout;
+
+        if( pcVcdPath != NULL )
+        {
+            pxVcdFile = prvOpen( pcVcdPath );
+            prvWriteVcdHeader();
+        }
+    }
+
+    vRandomSeed( ( uint64_t ) ullSeed );
+
+    /* Does not return, the run ends in vSimTickElapsed(). */
+    return app_main();
+}
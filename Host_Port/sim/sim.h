@@ -0,0 +1,75 @@
+/*
+ * Virtual time of the simulator, shared by sim/port.c and sim/sim.c.
+ *
+ * Nothing in the simulator depends on the host clock.  Time is a count of
+ * virtual CPU cycles at configCPU_CLOCK_HZ that only moves forward when a
+ * task consumes execution time with vSimRun(), when the idle task runs and
+ * when a peripheral is accessed.  The tick interrupt is taken each time the
+ * count crosses a multiple of simTICK_CYCLES, so a run with the same inputs
+ * always gives the same schedule, the same pin waveforms and the same UART
+ * output.
+ *
+ * The interrupts of the peripherals are taken at the same points, at the
+ * time they are due, see ullSimPeripheralCycles.
+ *
+ * When every task is blocked the time can also jump to the tick before the
+ * next one wakes up, see xSimFastForward.
+ */
+
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+
+/* CPU cycles between two ticks. */
+#define simTICK_CYCLES    ( ( uint64_t ) configCPU_CLOCK_HZ / ( uint64_t ) configTICK_RATE_HZ )
+
+/* Virtual CPU cycles since the simulator started. */
+extern uint64_t ullSimCycles;
+
+/* Context switches done by the port, the first task included. */
+extern uint32_t ulSimContextSwitches;
+
+/* Set by sim.c.  The tick count the run ends at, which the fast forward
+ * stops short of. */
+extern TickType_t xSimEndTick;
+
+/* Set by sim.c.  pdTRUE to skip the idle intervals: instead of one tick per
+ * loop of the idle task, the ticks up to the one before the next task wakes
+ * up are given to the kernel at once with xTaskCatchUpTicks().  The schedule
+ * is the same, but the tick hook is not called for the ticks skipped and the
+ * idle task only loops once over them. */
+extern BaseType_t xSimFastForward;
+
+/* Ticks given to the kernel by the fast forward. */
+extern uint32_t ulSimFastForwardTicks;
+
+/* Set by sim.c.  The cycle count a peripheral raises its next interrupt at,
+ * UINT64_MAX for none, and at most ullSimCycles for one pending now.  The
+ * port takes it where it would take a tick, and calls
+ * vSimPeripheralInterrupt(), after clearing this back to UINT64_MAX.  There
+ * is no fast forward while an interrupt is due. */
+extern uint64_t ullSimPeripheralCycles;
+
+/* Runs the current task for ullCycles of virtual time.  The ticks that fall
+ * in the interval are taken on the way, so the task can be preempted and
+ * only returns once it has received all of its cycles.  Must not be called
+ * from a critical section or from a hook. */
+void vSimRun( uint64_t ullCycles );
+
+/* Moves the virtual time forward by a few cycles without taking a tick, for
+ * the cost of a peripheral access.  Safe from anywhere. */
+void vSimStall( uint32_t ulCycles );
+
+/* Implemented by sim.c.  Called by the port at the end of each tick
+ * interrupt, and on each context switch just before the new task runs. */
+void vSimTickElapsed( void );
+void vSimContextSwitched( void );
+
+/* Implemented by sim.c.  The interrupt of a peripheral, see
+ * ullSimPeripheralCycles. */
+void vSimPeripheralInterrupt( void );
+
+#endif /* SIM_H */
@@ -0,0 +1,175 @@
+/*
+ * Check that the tasks created by xTaskPeriodicCreateTable() can be deleted:
+ * their TCBs and stacks are carved from the one block of their table, which
+ * must never be handed back to the heap, whatever the allocation options.
+ *
+ * A table of three periodic tasks runs on the contexts of the simulator port
+ * (sim/port.c).  The first one, of the shortest period, runs the steps below
+ * and the other two count their runs:
+ *
+ *   delete        vTaskDelete() of the third task by the first one
+ *   re-create     the third task again, in a table of its own, which runs
+ *   self delete   vTaskDelete( NULL ) by the second task, freed by the idle
+ *                 task, after which it runs no more
+ *   heap          blocks allocated and freed after the deletions
+ *
+ * The free heap must be the same before and after each deletion, and again
+ * once the blocks are freed.  A deletion that freed memory of the table would
+ * change it, or trip an assertion of the heap.
+ *
+ * Usage:
+ *   tablecheck
+ * Exit status is 1 when a step fails.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "sim/sim.h"
+
+#if ( configUSE_EDF_SCHEDULER != 1 ) || ( configSUPPORT_DYNAMIC_ALLOCATION != 1 ) || ( INCLUDE_vTaskDelete != 1 )
+    #error The check needs the EDF scheduler, the dynamic allocation and vTaskDelete()
+#endif
+
+#ifndef checkHEAP
+    #define checkHEAP    "heap"
+#endif
+
+#define checkPRIORITY            ( configUSE_EDF_HYBRID == 1 ? configEDF_BAND_PRIORITY : 1 )
+#define checkTASKS               3U
+
+/* Ticks the first task waits for the others to run, or the idle task to
+ * free a task that deleted itself. */
+#define checkWAIT                20U
+
+#define checkBLOCKS              4U
+#define checkBLOCK_SIZE          100U
+
+static void prvStepsTask( void * pvParameters );
+static void prvCountingTask( void * pvParameters );
+
+static const TaskPeriodicParameters_t xTasks[ checkTASKS ] =
+{
+    { prvStepsTask,    "Steps", configMINIMAL_STACK_SIZE, ( void * ) 0, checkPRIORITY, 10U, 0U, 0U },
+    { prvCountingTask, "Self",  configMINIMAL_STACK_SIZE, ( void * ) 1, checkPRIORITY, 20U, 0U, 0U },
+    { prvCountingTask, "Other", configMINIMAL_STACK_SIZE, ( void * ) 2, checkPRIORITY, 40U, 0U, 0U }
+};
+
+static TaskHandle_t xHandles[ checkTASKS ];
+
+/* Runs of each counting task. */
+static volatile uint32_t ulRuns[ checkTASKS ];
+
+static volatile BaseType_t xDeleteSelf = pdFALSE;
+
+static int iFailed = 0;
+
+/* The sim.h interface sim/port.c calls back into. */
+TickType_t xSimEndTick = portMAX_DELAY;
+BaseType_t xSimFastForward = pdFALSE;
+/*-----------------------------------------------------------*/
+
+static void prvCheck( const char * pcStep,
+                      BaseType_t xPassed )
+{
+    printf( "%-9s %-12s %s\n", checkHEAP, pcStep, ( xPassed != pdFALSE ) ? "ok" : "FAILED" );
+    iFailed |= ( xPassed == pdFALSE );
+}
+
+static void prvCountingTask( void * pvParameters )
+{
+    const UBaseType_t uxTask = ( UBaseType_t ) ( uintptr_t ) pvParameters;
+
+    for( ; ; )
+    {
+        ulRuns[ uxTask ]++;
+
+        if( ( uxTask == 1U ) && ( xDeleteSelf != pdFALSE ) )
+        {
+            vTaskDelete( NULL );
+        }
+
+        vTaskDelay( 1U );
+    }
+}
+
+static void prvStepsTask( void * pvParameters )
+{
+    void * pvBlocks[ checkBLOCKS ];
+    size_t xFree;
+    uint32_t ulRunsBefore;
+    BaseType_t xCreated, xAllocated = pdTRUE;
+    UBaseType_t uxBlock;
+
+    ( void ) pvParameters;
+
+    /* Lets the other tasks run once. */
+    vTaskDelay( checkWAIT );
+
+    xFree = xPortGetFreeHeapSize();
+    vTaskDelete( xHandles[ 2 ] );
+    prvCheck( "delete", xPortGetFreeHeapSize() == xFree );
+
+    ulRuns[ 2 ] = 0U;
+    xFree = xPortGetFreeHeapSize();
+    xCreated = xTaskPeriodicCreateTable( &( xTasks[ 2 ] ), 1U, &( xHandles[ 2 ] ) );
+    xCreated = ( xCreated == pdPASS ) && ( xPortGetFreeHeapSize() < xFree );
+    vTaskDelay( checkWAIT );
+    prvCheck( "re-create", ( xCreated != pdFALSE ) && ( ulRuns[ 2 ] > 0U ) );
+
+    xFree = xPortGetFreeHeapSize();
+    xDeleteSelf = pdTRUE;
+    vTaskDelay( checkWAIT );
+    ulRunsBefore = ulRuns[ 1 ];
+    vTaskDelay( checkWAIT );
+    prvCheck( "self delete", ( xPortGetFreeHeapSize() == xFree ) && ( ulRuns[ 1 ] == ulRunsBefore ) );
+
+    for( uxBlock = 0U; uxBlock < checkBLOCKS; uxBlock++ )
+    {
+        pvBlocks[ uxBlock ] = pvPortMalloc( checkBLOCK_SIZE * ( uxBlock + 1U ) );
+        xAllocated = ( xAllocated != pdFALSE ) && ( pvBlocks[ uxBlock ] != NULL );
+    }
+
+    for( uxBlock = 0U; uxBlock < checkBLOCKS; uxBlock++ )
+    {
+        vPortFree( pvBlocks[ uxBlock ] );
+    }
+
+    prvCheck( "heap", ( xAllocated != pdFALSE ) && ( xPortGetFreeHeapSize() == xFree ) );
+
+    fflush( stdout );
+    _exit( iFailed );
+}
+/*-----------------------------------------------------------*/
+
+void vSimPeripheralInterrupt( void )
+{
+}
+
+void vSimTickElapsed( void )
+{
+}
+
+void vSimContextSwitched( void )
+{
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+    if( xTaskPeriodicCreateTable( xTasks, checkTASKS, xHandles ) != pdPASS )
+    {
+        fprintf( stderr, "tablecheck: could not create the tasks\n" );
+        return 1;
+    }
+
+    /* Does not return, the first task ends the run. */
+    vTaskStartScheduler();
+    return 1;
+}
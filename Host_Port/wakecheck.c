@@ -0,0 +1,193 @@
+/*
+ * Check that under EDF a job woken by an event preempts the running job when
+ * its deadline is earlier, whatever woke it.
+ *
+ * Two periodic tasks of the same priority run on the contexts of the
+ * simulator port (sim/port.c): a waker, of the longer period, and a woken
+ * task, of the shorter one.  Neither completes a job, so their deadlines stay
+ * those of their first jobs, and the woken task always has the earlier one.
+ * The woken task blocks on each event below in turn, and the waker raises it:
+ *
+ *   notify          xTaskNotifyGive() from the waker
+ *   queue           xQueueSend() from the waker, to a queue the woken task
+ *                   receives from
+ *   notify isr      vTaskNotifyGiveFromISR() from an interrupt
+ *   queue isr       xQueueSendFromISR() from an interrupt
+ *   abort delay     xTaskAbortDelay() from the waker, on a vTaskDelay() of
+ *                   the woken task
+ *
+ * The interrupts are those of a peripheral of the simulator, see
+ * ullSimPeripheralCycles, taken while the waker runs.  The woken task must
+ * have run by the time the call of the waker returns, or in the interrupt
+ * cases by the end of the vSimRun() the interrupt was taken in.
+ *
+ * In the hybrid mode both tasks are in the EDF band, and preempt each other
+ * on their deadlines all the same: make wakecheck runs a hybrid build too.
+ * In the non-preemptive build no job preempts another, and every check fails.
+ *
+ * Usage:
+ *   wakecheck
+ * Exit status is 1 when an event did not preempt.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+#include "sim/sim.h"
+
+#if ( configUSE_EDF_SCHEDULER != 1 ) || ( configUSE_TASK_NOTIFICATIONS != 1 ) || ( INCLUDE_xTaskAbortDelay != 1 )
+    #error The check needs the EDF scheduler, the task notifications and xTaskAbortDelay()
+#endif
+
+#define checkSHORT_PERIOD        20U
+#define checkLONG_PERIOD         50U
+#define checkPRIORITY            ( configUSE_EDF_HYBRID == 1 ? configEDF_BAND_PRIORITY : 1 )
+#define checkDELAY               1000U
+
+/* Cycles the waker runs for, and after how many of them the interrupt is
+ * raised. */
+#define checkRUN_CYCLES          1000U
+#define checkINTERRUPT_CYCLES    100U
+
+typedef enum
+{
+    eCheckNotify = 0,
+    eCheckQueue,
+    eCheckNotifyFromISR,
+    eCheckQueueFromISR,
+    eCheckAbortDelay,
+    eChecks
+} Check_t;
+
+static const char * const pcCheckNames[ eChecks ] = { "notify", "queue", "notify isr", "queue isr", "abort delay" };
+
+static TaskHandle_t xWoken = NULL;
+static QueueHandle_t xQueue = NULL;
+static volatile Check_t eRaised = eChecks;
+
+/* Checks the woken task has handled, the step it is at. */
+static volatile uint32_t ulHandled = 0U;
+
+/* The sim.h interface sim/port.c calls back into. */
+TickType_t xSimEndTick = portMAX_DELAY;
+BaseType_t xSimFastForward = pdFALSE;
+/*-----------------------------------------------------------*/
+
+static void prvWokenTask( void * pvParameters )
+{
+    uint8_t ucEvent;
+    Check_t eCheck;
+
+    ( void ) pvParameters;
+
+    for( eCheck = eCheckNotify; eCheck < eChecks; eCheck++ )
+    {
+        if( ( eCheck == eCheckNotify ) || ( eCheck == eCheckNotifyFromISR ) )
+        {
+            ( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+        }
+        else if( eCheck == eCheckAbortDelay )
+        {
+            vTaskDelay( checkDELAY );
+        }
+        else
+        {
+            ( void ) xQueueReceive( xQueue, &ucEvent, portMAX_DELAY );
+        }
+
+        ulHandled++;
+    }
+
+    vTaskSuspend( NULL );
+}
+
+static void prvWakerTask( void * pvParameters )
+{
+    uint8_t ucEvent = 1U;
+    Check_t eCheck;
+    int iFailed = 0;
+
+    ( void ) pvParameters;
+
+    for( eCheck = eCheckNotify; eCheck < eChecks; eCheck++ )
+    {
+        if( eCheck == eCheckNotify )
+        {
+            ( void ) xTaskNotifyGive( xWoken );
+        }
+        else if( eCheck == eCheckQueue )
+        {
+            ( void ) xQueueSend( xQueue, &ucEvent, 0 );
+        }
+        else if( eCheck == eCheckAbortDelay )
+        {
+            ( void ) xTaskAbortDelay( xWoken );
+        }
+        else
+        {
+            eRaised = eCheck;
+            ullSimPeripheralCycles = ullSimCycles + checkINTERRUPT_CYCLES;
+            vSimRun( checkRUN_CYCLES );
+        }
+
+        printf( "%-12s %s\n", pcCheckNames[ eCheck ], ( ulHandled == ( uint32_t ) eCheck + 1U ) ? "preempted" : "NOT preempted" );
+        iFailed |= ( ulHandled != ( uint32_t ) eCheck + 1U );
+
+        /* Lets the woken task catch up when it did not preempt. */
+        vTaskDelay( 1 );
+    }
+
+    fflush( stdout );
+    _exit( iFailed );
+}
+/*-----------------------------------------------------------*/
+
+void vSimPeripheralInterrupt( void )
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    uint8_t ucEvent = 1U;
+
+    if( eRaised == eCheckNotifyFromISR )
+    {
+        vTaskNotifyGiveFromISR( xWoken, &xHigherPriorityTaskWoken );
+    }
+    else
+    {
+        ( void ) xQueueSendFromISR( xQueue, &ucEvent, &xHigherPriorityTaskWoken );
+    }
+
+    portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+}
+
+void vSimTickElapsed( void )
+{
+}
+
+void vSimContextSwitched( void )
+{
+}
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+    xQueue = xQueueCreate( 1, sizeof( uint8_t ) );
+
+    if( ( xQueue == NULL ) ||
+        ( xTaskPeriodicCreate( prvWokenTask, "Woken", configMINIMAL_STACK_SIZE, NULL, checkPRIORITY, &xWoken, checkSHORT_PERIOD ) != pdPASS ) ||
+        ( xTaskPeriodicCreate( prvWakerTask, "Waker", configMINIMAL_STACK_SIZE, NULL, checkPRIORITY, NULL, checkLONG_PERIOD ) != pdPASS ) )
+    {
+        fprintf( stderr, "wakecheck: could not create the tasks\n" );
+        return 1;
+    }
+
+    /* Does not return, the waker ends the run. */
+    vTaskStartScheduler();
+    return 1;
+}
@@ -0,0 +1,99 @@
+#!/usr/bin/env python3
+"""Latency from a button edge to its message on the UART, in the simulator.
+
+Runs the simulator of Host_Port with the two button inputs of main.c, PIN0 and
+PIN1 of port 0, toggled at irregular times, and matches each edge with the
+first "Btn(N)Rising" or "Btn(N)Falling" line the UART prints after it.  The
+latency covers the whole chain: the sampling of the input by the button task,
+the notification, the job of Uart_Rx that queues the message, and the UART
+that sends it, as the time of a line is when its last character is out.  An
+edge with no message before the next edge of the same button is counted as
+lost.
+
+The edges of each button are drawn at random, at least --gap milliseconds
+apart so that the button task, which samples every 50 ms, sees each of them,
+and at most 64 of them, the number the simulator takes per pin.
+
+Usage:
+  button_latency.py [--sim Host_Port/build/sim] [--ms 10000] [--gap 120] [--seed 1]
+"""
+
+import argparse
+import os
+import random
+import subprocess
+import sys
+
+
+# simMAX_TOGGLES of sim.c.
+MAX_EDGES = 64
+
+
+def draw_edges(rng, duration_ms, gap_ms):
+    edges, t = [], gap_ms
+    while len(edges) < MAX_EDGES:
+        t += gap_ms + rng.random() * gap_ms
+        if t >= duration_ms - gap_ms:
+            break
+        edges.append(round(t, 3))
+    return edges
+
+
+def percentile(values, per_mille):
+    values = sorted(values)
+    return values[min(len(values) - 1, (len(values) * per_mille) // 1000)]
+
+
+def main():
+    root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("--sim", default=os.path.join(root, "Host_Port", "build", "sim"), help="simulator binary")
+    parser.add_argument("--ms", type=int, default=10000, help="virtual time to run for (default 10000)")
+    parser.add_argument("--gap", type=float, default=120.0, help="shortest time between two edges of a button, in ms")
+    parser.add_argument("--seed", type=int, default=1, help="seed of the edge times")
+    args = parser.parse_args()
+
+    rng = random.Random(args.seed)
+    edges = {1: draw_edges(rng, args.ms, args.gap), 2: draw_edges(rng, args.ms, args.gap)}
+    command = [args.sim, "--ms", str(args.ms)]
+    for button, times in edges.items():
+        command += ["--input", "PIN%d=%s" % (button - 1, ",".join("%g" % t for t in times))]
+
+    try:
+        uart = subprocess.run(command, check=True, stdout=subprocess.PIPE, stderr=subprocess.DEVNULL,
+                              universal_newlines=True).stdout
+    except (OSError, subprocess.CalledProcessError) as error:
+        sys.stderr.write("button_latency: %s\n" % error)
+        return 1
+
+    # The input is low at the start, so the odd edges are rising.
+    messages = {1: [], 2: []}
+    for line in uart.splitlines():
+        fields = line.split(None, 1)
+        if len(fields) == 2 and fields[1].startswith("Btn(") and fields[1][4] in "12":
+            messages[int(fields[1][4])].append((int(fields[0]) / 1000.0, fields[1].endswith("Rising")))
+
+    print("%-8s %6s %6s %8s %8s %8s %8s" % ("button", "edges", "lost", "p50_ms", "p99_ms", "max_ms", "mean_ms"))
+    for button in (1, 2):
+        latencies, lost, m = [], 0, 0
+        times = edges[button]
+        for i, t in enumerate(times):
+            end = times[i + 1] if i + 1 < len(times) else float("inf")
+            while m < len(messages[button]) and messages[button][m][0] < t:
+                m += 1
+            if m < len(messages[button]) and messages[button][m][0] < end and messages[button][m][1] == (i % 2 == 0):
+                latencies.append(messages[button][m][0] - t)
+                m += 1
+            else:
+                lost += 1
+        if latencies:
+            print("Btn(%d)   %6d %6d %8.2f %8.2f %8.2f %8.2f"
+                  % (button, len(times), lost, percentile(latencies, 500), percentile(latencies, 990),
+                     max(latencies), sum(latencies) / len(latencies)))
+        else:
+            print("Btn(%d)   %6d %6d" % (button, len(times), lost))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,261 @@
+#!/usr/bin/env python3
+"""Compare a recorded scheduling trace with the Simso model of the task set.
+
+The jobs released in the trace (see trace_decode.py) are replayed through a
+preemptive EDF simulation of the task set declared in the Simso project.  For
+every job the start time, finish time and number of preemptions of the trace
+are compared with the simulation, and the measured execution time is checked
+against the WCET of the model.
+
+By default the simulation runs each job for the time it took on the target,
+so a divergence means the kernel took a different scheduling decision than
+EDF would have.  With --exec model every job runs for its model WCET instead,
+which compares the target with the Simso analysis itself.
+
+Tasks are matched by creation order: the periodic tasks of the trace, idle task
+excluded, in the order of their task number, with the tasks of the model in
+the order of their id.  The names of the trace are cut to
+configMAX_TASK_NAME_LEN and may not tell the tasks apart.  --map N=MODEL_NAME
+overrides the match of task number N.
+
+A job that blocks in the middle of its execution, as Uart_Rx does while it
+waits for the events of its period, is replayed as a suspension: each part
+after a block is made ready when the trace shows the task woken, and runs
+with the deadline of the job.  With --exec model a job is a single part of
+its WCET, as in Simso.
+
+Usage:
+  simso_compare.py trace.hex Simso_Project/EDF_6_Tasks_Project.xml
+Exit status is 1 when a job diverges beyond --tolerance, or exceeds its WCET
+by more than --wcet-tolerance per cent, 0 by default.  The summary marks every task
+whose longest job exceeds its WCET, whatever the tolerance.  The execution
+times are only as fine as the timer of the trace: 16.7 us a count on the
+target, 1 us in the simulator.
+"""
+
+import argparse
+import os
+import sys
+import xml.etree.ElementTree as ElementTree
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import trace_decode  # noqa: E402
+
+
+class ModelTask:
+    def __init__(self, element):
+        self.id = int(element.get("id"))
+        self.name = element.get("name")
+        self.period = float(element.get("period")) / 1e3
+        self.deadline = float(element.get("deadline")) / 1e3
+        self.wcet = float(element.get("WCET")) / 1e3
+
+
+def load_model(path):
+    """Returns the periodic tasks of a Simso project, ordered by id."""
+    root = ElementTree.parse(path).getroot()
+    tasks = [ModelTask(e) for e in root.iter("task") if e.get("task_type", "Periodic") == "Periodic"]
+    return sorted(tasks, key=lambda t: t.id)
+
+
+class Job:
+    def __init__(self, task, release, deadline):
+        self.task = task
+        self.release = release
+        self.deadline = deadline
+        self.start = None
+        self.finish = None
+        self.preemptions = 0
+        self.instant_preemptions = 0
+        self.exec_time = 0.0
+        self.parts = []         # (ready, execution time), one after each block
+
+
+def measured_jobs(task):
+    """Splits the execution of a trace task into its jobs.
+
+    A job starts at each release the kernel recorded.  A release with the
+    deadline of the job already running does not start a new one.  A job is
+    everything the task executed until the next job.
+
+    The tasks of main.c take the time of their first release when they first
+    run, not at their creation, and time the first job from there: the job
+    released by the creation is taken as released at the first run.
+    """
+    starts = []
+    for release, deadline in task.releases:
+        if not starts or deadline != starts[-1][1]:
+            starts.append((release, deadline))
+
+    jobs = []
+    for i, (release, deadline) in enumerate(starts):
+        end = starts[i + 1][0] if i + 1 < len(starts) else float("inf")
+        slices = [s for s in task.slices if release <= s[0] < end]
+        if not slices:
+            continue
+        if release == task.created:
+            release = slices[0][0]
+        job = Job(task.number, release, deadline)
+        job.start = slices[0][0]
+        job.finish = slices[-1][1]
+        # A task switched out before the timer moved has not measurably run:
+        # the task woken at once, as a receiver by the send of the job, may
+        # run first in the simulation or preempt it there, depending on how
+        # far the simulated start is from the measured one.  Either count
+        # matches.
+        job.preemptions = sum(1 for s in slices[:-1] if s[2] and s[1] > s[0])
+        job.instant_preemptions = sum(1 for s in slices[:-1] if s[2] and s[1] == s[0])
+        job.exec_time = sum(e - s for s, e, _ in slices)
+        ready = release
+        for k, (start, stop, preempted) in enumerate(slices):
+            if k == 0 or not slices[k - 1][2]:
+                job.parts.append([ready if k == 0 else start, 0.0])
+            job.parts[-1][1] += stop - start
+        jobs.append(job)
+    return jobs
+
+
+def simulate_edf(jobs, parts):
+    """Runs the jobs on one processor under preemptive EDF.
+
+    jobs is a list of Job with release and deadline set, parts for each one
+    the list of (ready, execution time) it runs in, with the deadline of the
+    job.  Fills in start, finish and preemptions of copies of the jobs, which
+    are returned in the same order.  Ties on the deadline go to the part made
+    ready first, as vListInsert() does in the kernel.
+    """
+    sim = [Job(j.task, j.release, j.deadline) for j in jobs]
+    units = [(ready, j, p) for j in range(len(jobs)) for p, (ready, _) in enumerate(parts[j])]
+    units.sort()
+    remaining = {(j, p): e for j in range(len(jobs)) for p, (_, e) in enumerate(parts[j])}
+    ready = []
+    now = 0.0
+    nxt = 0
+    running = None
+
+    while nxt < len(units) or ready:
+        if not ready:
+            now = max(now, units[nxt][0])
+        while nxt < len(units) and units[nxt][0] <= now + 1e-12:
+            ready.append(units[nxt])
+            nxt += 1
+
+        current = min(ready, key=lambda u: (sim[u[1]].deadline, u[0], u[1], u[2]))
+        job = sim[current[1]]
+        if running is not None and running[1] != current[1] and running in ready:
+            sim[running[1]].preemptions += 1
+        running = current
+        if job.start is None:
+            job.start = now
+
+        key = current[1:]
+        next_release = units[nxt][0] if nxt < len(units) else float("inf")
+        if now + remaining[key] <= next_release + 1e-12:
+            now += remaining[key]
+            remaining[key] = 0.0
+            job.finish = now
+            ready.remove(current)
+            running = None
+        else:
+            remaining[key] -= next_release - now
+            now = next_release
+    return sim
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("dump", help="dump of xTraceRecorder, raw binary or Intel HEX")
+    parser.add_argument("model", help="Simso project (.xml)")
+    parser.add_argument("--exec", choices=("measured", "model"), default="measured",
+                        help="execution time of the simulated jobs (default: measured)")
+    parser.add_argument("--tolerance", type=float, default=0.1,
+                        help="largest start/finish difference accepted, in ms (default: 0.1)")
+    parser.add_argument("--wcet-tolerance", type=float, default=0.0,
+                        help="largest execution time accepted over the WCET, in %% of it (default: 0)")
+    parser.add_argument("--map", action="append", default=[], metavar="N=MODEL_NAME",
+                        help="match the trace task number N with the model task MODEL_NAME")
+    parser.add_argument("--all", action="store_true", help="list every job, not only the divergent ones")
+    args = parser.parse_args(argv)
+
+    try:
+        header, events = trace_decode.load_dump(args.dump)
+        model = load_model(args.model)
+    except (OSError, ValueError, ElementTree.ParseError) as e:
+        sys.stderr.write("simso_compare: %s\n" % e)
+        return 2
+
+    tasks, _ = trace_decode.build_timeline(header, events)
+    periodic = [tasks[n] for n in sorted(tasks) if tasks[n].period and tasks[n].name != "IDLE"]
+    by_name = {m.name: m for m in model}
+    matches = dict(zip((t.number for t in periodic), model))
+    for item in args.map:
+        number, _, model_name = item.partition("=")
+        if not number.isdigit() or model_name not in by_name:
+            sys.stderr.write("simso_compare: no task %s in the model, or %s is not a task number\n"
+                             % (model_name, number))
+            return 2
+        matches[int(number)] = by_name[model_name]
+
+    tick_hz = float(header["tick_hz"])
+    jobs = []
+    for t in periodic:
+        if t.number not in matches:
+            sys.stderr.write("simso_compare: %s has no match in the model, ignored\n" % t.name)
+            continue
+        m = matches[t.number]
+        if abs(t.period / tick_hz - m.period) > 0.5 / tick_hz:
+            sys.stderr.write("simso_compare: %s has period %g ms, %s %g ms in the model\n"
+                             % (t.name, t.period * 1e3 / tick_hz, m.name, m.period * 1e3))
+        for job in measured_jobs(t):
+            job.deadline = job.release + m.deadline
+            jobs.append(job)
+
+    if not jobs:
+        sys.stderr.write("simso_compare: no complete job in the trace\n")
+        return 2
+
+    parts = [j.parts if args.exec == "measured" else [(j.release, matches[j.task].wcet)] for j in jobs]
+    simulated = simulate_edf(jobs, parts)
+    tolerance = args.tolerance / 1e3
+    wcet_tolerance = args.wcet_tolerance / 100
+    failed = False
+
+    print("%-10s %-17s %9s %9s %9s %9s %9s %5s %5s  %s"
+          % ("task", "model", "release", "start", "sim", "finish", "sim", "pre", "sim", "notes"))
+    stats = {}
+    for job, sim in zip(jobs, simulated):
+        m = matches[job.task]
+        notes = []
+        if abs(job.start - sim.start) > tolerance:
+            notes.append("start %+.3f ms" % ((job.start - sim.start) * 1e3))
+        if abs(job.finish - sim.finish) > tolerance:
+            notes.append("finish %+.3f ms" % ((job.finish - sim.finish) * 1e3))
+        if not job.preemptions <= sim.preemptions <= job.preemptions + job.instant_preemptions:
+            notes.append("preemptions")
+        if job.exec_time > m.wcet * (1 + wcet_tolerance):
+            notes.append("WCET exceeded: %.3f > %.3f ms" % (job.exec_time * 1e3, m.wcet * 1e3))
+        if job.finish > job.deadline + tolerance:
+            notes.append("deadline missed")
+
+        s = stats.setdefault(job.task, {"name": tasks[job.task].name, "model": m.name, "jobs": 0, "divergent": 0, "max_exec": 0.0, "wcet": m.wcet})
+        s["jobs"] += 1
+        s["divergent"] += 1 if notes else 0
+        s["max_exec"] = max(s["max_exec"], job.exec_time)
+        failed = failed or bool(notes)
+
+        if notes or args.all:
+            print("%-10s %-17s %9.3f %9.3f %9.3f %9.3f %9.3f %5d %5d  %s"
+                  % (tasks[job.task].name[:10], m.name, job.release * 1e3, job.start * 1e3, sim.start * 1e3,
+                     job.finish * 1e3, sim.finish * 1e3, job.preemptions, sim.preemptions, "; ".join(notes)))
+
+    print()
+    print("%-10s %-17s %6s %9s %12s %9s" % ("task", "model", "jobs", "divergent", "max exec ms", "WCET ms"))
+    for s in stats.values():
+        print("%-10s %-17s %6d %9d %12.3f %9.3f%s"
+              % (s["name"][:10], s["model"], s["jobs"], s["divergent"], s["max_exec"] * 1e3, s["wcet"] * 1e3,
+                 "  exceeded" if s["max_exec"] > s["wcet"] else ""))
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
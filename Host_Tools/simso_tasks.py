@@ -0,0 +1,138 @@
+#!/usr/bin/env python3
+"""Generate the task table of the application from its Simso model.
+
+The periodic tasks of the Simso project become the entries of a const
+TaskPeriodicParameters_t table, in the order of their id, for
+xTaskPeriodicCreateTable().  Besides the attributes Simso itself uses (name,
+period, deadline, WCET and the priority field), each task of the project
+declares the function that implements it and its stack depth in words, as the
+custom fields "function" and "stack".
+
+The header also defines TaskN_Period, the period in ticks of the task of id N,
+for the calls of xTaskDelayUntil(), and checks that the tick rate it was
+generated for is the one of the build.  Times in the model are in
+milliseconds; periods and deadlines must be whole ticks, WCETs are rounded up.
+
+Usage:
+  simso_tasks.py Simso_Project/EDF_6_Tasks_Project.xml -o "Edited Files/app_tasks.h"
+"""
+
+import argparse
+import math
+import os
+import sys
+import xml.etree.ElementTree as ElementTree
+
+
+class ModelTask:
+    def __init__(self, element, tick_hz):
+        self.id = int(element.get("id"))
+        self.name = element.get("name")
+        self.function = element.get("function")
+        self.stack = element.get("stack")
+        self.priority = int(element.get("priority", "1"))
+        self.period = to_ticks(element, "period", tick_hz)
+        self.deadline = to_ticks(element, "deadline", tick_hz)
+        self.wcet = int(math.ceil(float(element.get("WCET")) * tick_hz / 1e3 - 1e-9))
+        if not self.function or not self.stack:
+            raise ValueError("task %s has no function or stack field" % self.name)
+        self.stack = int(self.stack)
+
+
+def to_ticks(element, attribute, tick_hz):
+    ticks = float(element.get(attribute)) * tick_hz / 1e3
+    if ticks <= 0 or abs(ticks - round(ticks)) > 1e-6:
+        raise ValueError("%s of task %s is not a whole number of ticks"
+                         % (attribute, element.get("name")))
+    return int(round(ticks))
+
+
+def load_model(path, tick_hz):
+    """Returns the periodic tasks of a Simso project, ordered by id."""
+    root = ElementTree.parse(path).getroot()
+    tasks = [ModelTask(e, tick_hz) for e in root.iter("task")
+             if e.get("task_type", "Periodic") == "Periodic"]
+    return sorted(tasks, key=lambda t: t.id)
+
+
+def c_string(text):
+    return '"%s"' % text.replace("\\", "\\\\").replace('"', '\\"')
+
+
+def generate(tasks, model_path, tick_hz):
+    out = []
+    out.append("/*")
+    out.append(" * Task table of the application, generated by Host_Tools/simso_tasks.py from")
+    out.append(" * %s.  Edit the model and generate it again" % model_path)
+    out.append(" * rather than editing this file.")
+    out.append(" */")
+    out.append("")
+    out.append("#ifndef APP_TASKS_H")
+    out.append("#define APP_TASKS_H")
+    out.append("")
+    out.append('#include "FreeRTOS.h"')
+    out.append('#include "task.h"')
+    out.append("")
+    out.append("/* Fails to compile if configTICK_RATE_HZ, which holds a cast, is not the")
+    out.append(" * tick rate the periods were converted at. */")
+    out.append("typedef char appTICK_RATE_CHECK[ ( configTICK_RATE_HZ == %d ) ? 1 : -1 ];" % tick_hz)
+    out.append("")
+    out.append("/* Periods, in ticks, by Simso task id. */")
+    width = max(len("Task%d_Period" % t.id) for t in tasks)
+    for t in tasks:
+        out.append("#define %-*s    %d" % (width, "Task%d_Period" % t.id, t.period))
+    out.append("")
+    out.append("#define appTASK_COUNT    %d" % len(tasks))
+    out.append("")
+    out.append("/* Words of stack of all the tasks together. */")
+    out.append("#define appSTACK_WORDS    %d" % sum(t.stack for t in tasks))
+    out.append("")
+    for t in tasks:
+        out.append("void %s( void * pvParameters );" % t.function)
+    out.append("")
+    out.append("static const TaskPeriodicParameters_t xAppTasks[ appTASK_COUNT ] =")
+    out.append("{")
+    out.append("    /* Function, name, stack depth, parameters, priority, period, deadline, WCET. */")
+    for i, t in enumerate(tasks):
+        out.append("    { %s, %s, %d, NULL, %d, Task%d_Period, %d, %d }%s"
+                   % (t.function, c_string(t.name), t.stack, t.priority, t.id, t.deadline, t.wcet,
+                      "," if i + 1 < len(tasks) else ""))
+    out.append("};")
+    out.append("")
+    out.append("#endif /* APP_TASKS_H */")
+    return "\n".join(out) + "\n"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("model", help="Simso project (.xml)")
+    parser.add_argument("-o", "--output", help="header to write (default: standard output)")
+    parser.add_argument("--tick-hz", type=int, default=1000, help="configTICK_RATE_HZ (default 1000)")
+    args = parser.parse_args()
+
+    try:
+        tasks = load_model(args.model, args.tick_hz)
+    except ValueError as error:
+        sys.stderr.write("simso_tasks: %s\n" % error)
+        return 1
+    if not tasks:
+        sys.stderr.write("simso_tasks: no periodic task in %s\n" % args.model)
+        return 1
+    for t in tasks:
+        if t.deadline != t.period:
+            sys.stderr.write("simso_tasks: task %s has a deadline other than its period,"
+                             " which the kernel does not schedule\n" % t.name)
+            return 1
+
+    model_path = os.path.relpath(args.model, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+    header = generate(tasks, model_path.replace(os.sep, "/"), args.tick_hz)
+    if args.output:
+        with open(args.output, "w", newline="\n") as f:
+            f.write(header)
+    else:
+        sys.stdout.write(header)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,155 @@
+#!/usr/bin/env python3
+"""Size the task stacks from the stack use measured in a training run.
+
+Built with configUSE_STACK_PROFILING set to 1, main.c prints on the UART, once
+the training run is over, a line per task of the task table:
+
+  STACK <index> <name> <depth> <used> <recommended depth>
+
+separated by tabs, with the sizes in words (see vTaskGetStackProfile()).  This
+reads those lines from a capture of the UART, anything else on a line before
+STACK is ignored, and prints the depth of each task in the Simso model next to
+what it used and the recommended depth.  The index is the position of the task
+in the table, which is the order of the ids of the model: the names are cut
+to configMAX_TASK_NAME_LEN on the target, so they are only shown.
+
+With --update the recommended depths are written into the "stack" fields of
+the model, and with -o the task table is generated again from it, as
+simso_tasks.py does.  --margin recomputes the recommended depths from the use
+with another margin than the configSTACK_PROFILING_MARGIN of the build.
+
+The simulator of Host_Port runs the tasks on host stacks, so only a run on the
+target measures anything.
+
+Usage:
+  stack_sizes.py uart.log Simso_Project/EDF_6_Tasks_Project.xml
+  stack_sizes.py uart.log Simso_Project/EDF_6_Tasks_Project.xml --update -o "Edited Files/app_tasks.h"
+"""
+
+import argparse
+import math
+import os
+import re
+import sys
+
+import simso_tasks
+
+
+class StackReport:
+    def __init__(self, fields):
+        self.index = int(fields[0])
+        self.name = fields[1]
+        self.depth = int(fields[2])
+        self.used = int(fields[3])
+        self.recommended = int(fields[4])
+
+
+def load_report(path):
+    """Returns the last report of each task index in a UART capture."""
+    reports = {}
+    with open(path, "rb") as f:
+        for raw in f:
+            line = raw.decode("latin-1").rstrip("\r\n")
+            start = line.find("STACK\t")
+            if start < 0:
+                continue
+            fields = line[start:].split("\t")[1:]
+            if len(fields) != 5:
+                raise ValueError("malformed stack report: %r" % line[start:])
+            report = StackReport(fields)
+            reports[report.index] = report
+    return reports
+
+
+def recommend(report, margin, alignment_words):
+    """The recommended depth for another margin, in percent, rounded as
+    vTaskGetStackProfile() does for a stack that grows down."""
+    depth = report.used + int(math.ceil(report.used * margin / 100.0))
+    depth = -(-depth // alignment_words) * alignment_words
+    return depth + alignment_words - 1
+
+
+def update_model(path, depths):
+    """Rewrites the stack field of the tasks of the model whose id is a key of
+    depths, leaving the rest of the file byte for byte."""
+    with open(path, "rb") as f:
+        text = f.read().decode("utf-8")
+
+    def replace(match):
+        element = match.group(0)
+        task_id = re.search(r'\bid="(\d+)"', element)
+        if task_id is None or int(task_id.group(1)) not in depths:
+            return element
+        new, count = re.subn(r'\bstack="\d+"', 'stack="%d"' % depths[int(task_id.group(1))], element)
+        if count != 1:
+            raise ValueError("task %s has no stack field" % task_id.group(1))
+        return new
+
+    text = re.sub(r"<task\b[^>]*>", replace, text)
+    with open(path, "wb") as f:
+        f.write(text.encode("utf-8"))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("capture", help="UART capture of the training run")
+    parser.add_argument("model", help="Simso project (.xml) the task table was generated from")
+    parser.add_argument("--margin", type=float, help="margin in percent (default: the one of the build)")
+    parser.add_argument("--alignment-words", type=int, default=2,
+                        help="portBYTE_ALIGNMENT in stack words (default 2, the ARM7)")
+    parser.add_argument("--update", action="store_true", help="write the recommended depths into the model")
+    parser.add_argument("-o", "--output", help="task table to generate from the updated model")
+    parser.add_argument("--tick-hz", type=int, default=1000, help="configTICK_RATE_HZ (default 1000)")
+    args = parser.parse_args()
+
+    if args.output and not args.update:
+        parser.error("-o needs --update")
+
+    try:
+        reports = load_report(args.capture)
+        tasks = simso_tasks.load_model(args.model, args.tick_hz)
+    except (OSError, ValueError) as error:
+        sys.stderr.write("stack_sizes: %s\n" % error)
+        return 1
+    if not reports:
+        sys.stderr.write("stack_sizes: no stack report in %s, was the build profiling stacks?\n" % args.capture)
+        return 1
+
+    depths = {}
+    total_before = total_after = 0
+    print("%-20s %-8s %6s %6s %6s" % ("task", "target", "model", "used", "new"))
+    for index, task in enumerate(tasks):
+        report = reports.get(index)
+        if report is None:
+            sys.stderr.write("stack_sizes: no report for task %s\n" % task.name)
+            return 1
+        if report.depth < task.stack - args.alignment_words:
+            sys.stderr.write("stack_sizes: task %s has %d words on the target but %d in the model,"
+                             " is the capture from this model?\n" % (task.name, report.depth, task.stack))
+            return 1
+        new = report.recommended if args.margin is None else recommend(report, args.margin, args.alignment_words)
+        if report.used >= report.depth:
+            sys.stderr.write("stack_sizes: warning: task %s used all of its stack, it may have"
+                             " overflowed: the measure is not reliable\n" % task.name)
+        depths[task.id] = new
+        total_before += task.stack
+        total_after += new
+        print("%-20s %-8s %6d %6d %6d" % (task.name, report.name, task.stack, report.used, new))
+    print("%-20s %-8s %6d %6s %6d" % ("total", "", total_before, "", total_after))
+
+    if args.update:
+        try:
+            update_model(args.model, depths)
+        except (OSError, ValueError) as error:
+            sys.stderr.write("stack_sizes: %s\n" % error)
+            return 1
+    if args.output:
+        tasks = simso_tasks.load_model(args.model, args.tick_hz)
+        model_path = os.path.relpath(args.model, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+        with open(args.output, "w", newline="\n") as f:
+            f.write(simso_tasks.generate(tasks, model_path.replace(os.sep, "/"), args.tick_hz))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
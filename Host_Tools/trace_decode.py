@@ -0,0 +1,295 @@
+#!/usr/bin/env python3
+"""Decode a dump of the scheduling trace recorder (Edited Files/trace_recorder.h).
+
+The dump is the memory of xTraceRecorder, saved from the debugger either as
+raw binary or as Intel HEX (the Keil SAVE command).  The decoder prints a
+summary per task and can write:
+
+  --gantt FILE.svg     a Gantt chart of the task executions, with the job
+                       releases, deadlines and misses
+  --chrome FILE.json   a Chrome trace, to open in chrome://tracing or
+                       https://ui.perfetto.dev
+
+Usage:
+  trace_decode.py trace.hex --gantt trace.svg --chrome trace.json
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+MAGIC = 0x54464445
+HEADER = struct.Struct("<IHHIII")
+EVENT = struct.Struct("<IBBH")
+
+EVT_SWITCH_IN = 1
+EVT_SWITCH_OUT = 2
+EVT_RELEASE = 3
+EVT_DEADLINE_MISS = 4
+EVT_QUEUE_SEND = 5
+EVT_QUEUE_RECEIVE = 6
+EVT_TASK_CREATE = 7
+EVT_TASK_NAME = 8
+
+
+def read_intel_hex(path):
+    """Returns the bytes of an Intel HEX file, from its lowest address."""
+    data = {}
+    base = 0
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            if not line.startswith(":"):
+                continue
+            record = bytes.fromhex(line[1:])
+            count, address, kind = record[0], (record[1] << 8) | record[2], record[3]
+            payload = record[4:4 + count]
+            if kind == 0:
+                for i, b in enumerate(payload):
+                    data[base + address + i] = b
+            elif kind == 2:
+                base = ((payload[0] << 8) | payload[1]) << 4
+            elif kind == 4:
+                base = ((payload[0] << 8) | payload[1]) << 16
+            elif kind == 1:
+                break
+    if not data:
+        return b""
+    start = min(data)
+    return bytes(data.get(a, 0) for a in range(start, max(data) + 1))
+
+
+def load_dump(path):
+    """Returns (header, events) from a dump, events in recording order.
+
+    header is a dict with timer_hz, tick_hz, capacity and head.  events is a
+    list of (timestamp, type, object, arg) tuples.  When more events were
+    recorded than the buffer holds only the last ones are returned.
+    """
+    if path.lower().endswith((".hex", ".ihx")):
+        raw = read_intel_hex(path)
+    else:
+        with open(path, "rb") as f:
+            raw = f.read()
+
+    if len(raw) < HEADER.size:
+        raise ValueError("%s: too short for a trace recorder dump" % path)
+    magic, version, capacity, timer_hz, tick_hz, head = HEADER.unpack_from(raw, 0)
+    if magic != MAGIC:
+        raise ValueError("%s: not a trace recorder dump (magic 0x%08x)" % (path, magic))
+    if version != 1:
+        raise ValueError("%s: unsupported trace recorder version %d" % (path, version))
+    if len(raw) < HEADER.size + capacity * EVENT.size:
+        raise ValueError("%s: dump holds fewer than %d events" % (path, capacity))
+
+    slots = [EVENT.unpack_from(raw, HEADER.size + i * EVENT.size) for i in range(capacity)]
+    if head <= capacity:
+        events = slots[:head]
+    else:
+        first = head % capacity
+        events = slots[first:] + slots[:first]
+
+    header = {"timer_hz": timer_hz, "tick_hz": tick_hz, "capacity": capacity,
+              "head": head, "lost": max(0, head - capacity)}
+    return header, events
+
+
+class Task:
+    def __init__(self, number):
+        self.number = number
+        self.name = "task%d" % number
+        self.period = 0
+        self.created = None     # time, when the creation is in the trace
+        self.slices = []        # (start, end, preempted)
+        self.releases = []      # (time, deadline)
+        self.misses = []        # time
+        self.completions = []   # time the task gave up the processor
+
+    def response_times(self):
+        """Response time of each job whose release and completion are in the trace."""
+        result = []
+        for i, (release, deadline) in enumerate(self.releases):
+            end = self.releases[i + 1][0] if i + 1 < len(self.releases) else None
+            done = [t for t in self.completions if t > release and (end is None or t <= end)]
+            if done:
+                result.append((release, deadline, done[-1]))
+        return result
+
+
+def build_timeline(header, events):
+    """Turns the events into tasks with execution slices and jobs.
+
+    Timestamps are unwrapped and converted to seconds from the first event.
+    Returns (tasks, queue_events), tasks indexed by task number.
+    """
+    timer_hz = float(header["timer_hz"])
+    tick_hz = float(header["tick_hz"])
+    tasks = {}
+    queue_events = []
+    names = {}
+
+    def task(number):
+        if number not in tasks:
+            tasks[number] = Task(number)
+        return tasks[number]
+
+    origin = None
+    previous = None
+    wraps = 0
+    running = None
+    started = None
+    switched_out = None
+
+    for stamp, kind, obj, arg in events:
+        if kind == EVT_TASK_NAME:
+            names.setdefault(obj, {})[arg] = struct.pack("<I", stamp).split(b"\0")[0].decode("latin-1")
+            continue
+
+        if previous is not None and stamp < previous:
+            wraps += 1
+        previous = stamp
+        absolute = stamp + (wraps << 32)
+        if origin is None:
+            origin = absolute
+        now = (absolute - origin) / timer_hz
+
+        if kind == EVT_SWITCH_IN:
+            # A task switched out and back in with no other task in between,
+            # as on a tick that released nothing earlier, goes on with its
+            # slice.
+            if obj == switched_out and task(obj).slices and task(obj).slices[-1][2]:
+                started = task(obj).slices.pop()[0]
+            else:
+                started = now
+            running, switched_out = obj, None
+        elif kind == EVT_SWITCH_OUT:
+            if running == obj and started is not None:
+                task(obj).slices.append((started, now, bool(arg)))
+            if not arg:
+                task(obj).completions.append(now)
+            running, started, switched_out = None, None, obj
+        elif kind == EVT_RELEASE:
+            task(obj).releases.append((now, now + arg / tick_hz))
+        elif kind == EVT_DEADLINE_MISS:
+            task(obj).misses.append(now)
+        elif kind in (EVT_QUEUE_SEND, EVT_QUEUE_RECEIVE):
+            queue_events.append((now, "send" if kind == EVT_QUEUE_SEND else "receive", obj, arg, running))
+        elif kind == EVT_TASK_CREATE:
+            t = task(obj)
+            t.period = arg
+            t.created = now
+            if arg:
+                t.releases.append((now, now + arg / tick_hz))
+
+    # A task still running at the end of the dump gets its last slice too.
+    if running is not None and started is not None and previous is not None:
+        end = ((previous + (wraps << 32)) - origin) / timer_hz
+        task(running).slices.append((started, end, True))
+
+    for number, parts in names.items():
+        task(number).name = "".join(parts[k] for k in sorted(parts))
+
+    return tasks, queue_events
+
+
+def print_summary(header, tasks, out=sys.stdout):
+    out.write("%d events recorded, %d lost to wrap-around, timer %d Hz, tick %d Hz\n"
+              % (header["head"], header["lost"], header["timer_hz"], header["tick_hz"]))
+    out.write("%-4s %-10s %7s %6s %6s %10s %10s %6s\n"
+              % ("#", "name", "period", "jobs", "slices", "busy ms", "max RT ms", "misses"))
+    for number in sorted(tasks):
+        t = tasks[number]
+        busy = sum(end - start for start, end, _ in t.slices)
+        rts = [done - release for release, _, done in t.response_times()]
+        out.write("%-4d %-10s %7d %6d %6d %10.3f %10s %6d\n"
+                  % (number, t.name[:10], t.period, len(t.releases), len(t.slices), busy * 1e3,
+                     "%.3f" % (max(rts) * 1e3) if rts else "-", len(t.misses)))
+
+
+def write_chrome(path, tasks, queue_events):
+    """Writes a Chrome trace event file, one thread per task."""
+    trace = []
+    for number, t in tasks.items():
+        trace.append({"name": "thread_name", "ph": "M", "pid": 1, "tid": number,
+                      "args": {"name": t.name}})
+        for start, end, preempted in t.slices:
+            trace.append({"name": t.name, "ph": "X", "pid": 1, "tid": number,
+                          "ts": start * 1e6, "dur": (end - start) * 1e6,
+                          "args": {"end": "preempted" if preempted else "blocked"}})
+        for release, deadline in t.releases:
+            trace.append({"name": "release", "ph": "i", "s": "t", "pid": 1, "tid": number,
+                          "ts": release * 1e6, "args": {"deadline_us": deadline * 1e6}})
+        for miss in t.misses:
+            trace.append({"name": "deadline miss", "ph": "i", "s": "t", "pid": 1, "tid": number,
+                          "ts": miss * 1e6, "cname": "terrible"})
+    for now, kind, queue, waiting, running in queue_events:
+        trace.append({"name": "queue %d %s" % (queue, kind), "ph": "i", "s": "t", "pid": 1,
+                      "tid": running if running is not None else 0, "ts": now * 1e6,
+                      "args": {"waiting": waiting}})
+    with open(path, "w") as f:
+        json.dump({"traceEvents": trace, "displayTimeUnit": "ms"}, f, indent=0)
+
+
+def write_gantt(path, tasks):
+    """Writes an SVG Gantt chart, one row per task, time in ms."""
+    rows = sorted(tasks)
+    end = max([e for t in tasks.values() for _, e, _ in t.slices] +
+              [d for t in tasks.values() for _, d in t.releases] + [1e-3])
+    scale = 1000.0 / end          # pixels per second, the chart is 1000 px wide
+    left, row_h, top = 110, 40, 20
+    height = top + row_h * len(rows) + 40
+    svg = ['<svg xmlns="http://www.w3.org/2000/svg" width="%d" height="%d" font-family="sans-serif" font-size="11">'
+           % (left + 1020, height)]
+
+    for i, number in enumerate(rows):
+        t = tasks[number]
+        y = top + i * row_h
+        svg.append('<text x="4" y="%d">%s</text>' % (y + 24, t.name))
+        svg.append('<line x1="%d" y1="%d" x2="%d" y2="%d" stroke="#ccc"/>' % (left, y + 30, left + 1000, y + 30))
+        for start, stop, preempted in t.slices:
+            svg.append('<rect x="%.1f" y="%d" width="%.1f" height="16" fill="%s"/>'
+                       % (left + start * scale, y + 14, max(0.5, (stop - start) * scale),
+                          "#7aa6da" if preempted else "#3b73b9"))
+        for release, deadline in t.releases:
+            x = left + release * scale
+            svg.append('<path d="M%.1f %d v-12 l-3 4 m3 -4 l3 4" stroke="#2a2" fill="none"/>' % (x, y + 30))
+            x = left + deadline * scale
+            svg.append('<path d="M%.1f %d v12 l-3 -4 m3 4 l3 -4" stroke="#a22" fill="none"/>' % (x, y + 2))
+        for miss in t.misses:
+            svg.append('<circle cx="%.1f" cy="%d" r="4" fill="red"/>' % (left + miss * scale, y + 8))
+
+    axis_y = top + row_h * len(rows) + 10
+    svg.append('<line x1="%d" y1="%d" x2="%d" y2="%d" stroke="black"/>' % (left, axis_y, left + 1000, axis_y))
+    for k in range(11):
+        x = left + k * 100
+        svg.append('<text x="%d" y="%d" text-anchor="middle">%.1f ms</text>' % (x, axis_y + 16, end * k / 10 * 1e3))
+    svg.append("</svg>")
+    with open(path, "w") as f:
+        f.write("\n".join(svg))
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("dump", help="dump of xTraceRecorder, raw binary or Intel HEX")
+    parser.add_argument("--gantt", metavar="SVG", help="write a Gantt chart")
+    parser.add_argument("--chrome", metavar="JSON", help="write a Chrome/Perfetto trace")
+    args = parser.parse_args(argv)
+
+    try:
+        header, events = load_dump(args.dump)
+    except (OSError, ValueError) as e:
+        sys.stderr.write("trace_decode: %s\n" % e)
+        return 1
+
+    tasks, queue_events = build_timeline(header, events)
+    print_summary(header, tasks)
+    if args.gantt:
+        write_gantt(args.gantt, tasks)
+    if args.chrome:
+        write_chrome(args.chrome, tasks, queue_events)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())